@@ -34,6 +34,8 @@ namespace common::callbackstore {
         }
     }
     void TriggerPostRenderCallbacks() {
+        // nothing is published with the count, relaxed is enough
+        atomic_ref(g_frameCount).fetch_add(1, memory_order_relaxed);
         for (auto& callback : postRenderCallbacks)
             callback();
     }
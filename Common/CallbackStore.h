@@ -1,7 +1,9 @@
 #pragma once
 #include "framework.h"
+#include <atomic>
 #include "macro.h"
 #include "DataTypes.h"
+#include "Variables.h"
 
 namespace common::callbackstore {
     using UninitializeCallbackType = void (*)(bool isProcessTerminating);
@@ -12,4 +14,9 @@ namespace common::callbackstore {
     void TriggerUninitializeCallbacks(bool isProcessTerminating);
     void TriggerPostRenderCallbacks();
     void TriggerClearMeasurementFlagsCallbacks();
+
+    // The frames presented so far. The render thread counts them, the input thread and the message hooks read them.
+    inline DWORD FrameCount() {
+        return std::atomic_ref(g_frameCount).load(std::memory_order_relaxed);
+    }
 }
\ No newline at end of file
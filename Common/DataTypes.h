@@ -9,7 +9,8 @@
 
 constexpr auto PROCESS_NAME_MAX_LEN = 64;
 constexpr auto ADDRESS_CHAIN_MAX_LEN = 8;
-constexpr auto GAME_CONFIG_MAX_LEN = 128;
+constexpr auto POINTER_PATH_MAX_LEN = 64;
+constexpr auto SIGNATURE_MAX_LEN = 32;
 
 struct ErrorMessage {
     DWORD code;
@@ -69,10 +70,26 @@ struct AddressChain {
 };
 static_assert(sizeof(void*) == sizeof(AddressChain::Level[0]));
 
+// Bytecode of a pointer path expression, see common::pointerpath
+struct PointerPath {
+    int     Length;
+    DWORD   Code[POINTER_PATH_MAX_LEN];
+};
+
+// Array of bytes pattern of an address in the game module, see common::signature
+struct Signature {
+    int     Length;
+    BYTE    Bytes[SIGNATURE_MAX_LEN];
+    // the bits of Bytes that have to match, 0 for wildcard nibbles
+    BYTE    Mask[SIGNATURE_MAX_LEN];
+    DWORD   Offset;
+};
+
 BEGIN_FLAG_ENUM(GameInput, DWORD)
 NONE/*        */ = 0,
 USE_BOMB/*    */ = 0b0000'0001,
 USE_SPECIAL/* */ = 0b0000'0010,
+USE_FOCUS/*   */ = 0b0000'0100,
 
 MOVE_LEFT/*   */ = 0b1000'0000,
 MOVE_RIGHT/*  */ = 0b0100'0000,
@@ -80,6 +97,16 @@ MOVE_UP/*     */ = 0b0010'0000,
 MOVE_DOWN/*   */ = 0b0001'0000,
 END_FLAG_ENUM()
 
+// flags of g_hookState, see common::hookstate
+BEGIN_FLAG_ENUM(HookState, DWORD)
+None/*             */ = 0,
+InputEnabled/*     */ = 1 << 0,
+ShowImGui/*        */ = 1 << 1,
+LeftMousePressed/* */ = 1 << 2,
+MidMousePressed/*  */ = 1 << 3,
+Minimized/*        */ = 1 << 4,
+END_FLAG_ENUM()
+
 BEGIN_FLAG_ENUM(InputMethod, int)
 None/*        */ = 0,
 DirectInput/* */ = 1 << 0,
@@ -103,6 +130,9 @@ enum class ScriptPositionGetMethod {
 struct GameConfig {
     WCHAR                   ProcessName[PROCESS_NAME_MAX_LEN];
     AddressChain            Address;
+    PointerPath             Path;
+    // when set, locates Address.Level[0] once the game starts
+    Signature               Signature;
 
     ScriptType              ScriptType;
     ScriptRunPlace          ScriptRunPlace;
@@ -115,24 +145,28 @@ struct GameConfig {
     InputMethod             InputMethods;
 };
 
-template <class ElementType, size_t ArraySize>
-class _GameConfigs : public std::array<ElementType, ArraySize> {
-private:
-    _GameConfigs::size_type _length;
-public:
-    constexpr ElementType& add_new() {
-        return this->at(_length++);
-    }
-    constexpr _GameConfigs::size_type length() const noexcept {
-        return _length;
-    }
-    constexpr _GameConfigs::size_type capacity() const noexcept {
-        return this->max_size();
-    }
+// how the player is moved toward the cursor, see core::movementcontrol
+enum class MovementMode {
+    Classic, Predictive, Proportional, Straight,
+};
+
+// Everything the GUI shares with the game processes, see gs_sharedConfig.
+struct SharedConfig {
+    // name of the file mapping holding all game configs, see core::gameconfigregion
+    WCHAR   GameConfigRegionName[MAX_PATH];
+    BYTE    BombButton;
+    BYTE    ExtraButton;
+    DWORD   ToggleOsCursorButton;
+    DWORD   ToggleImGuiButton;
+    WCHAR   TextureFilePath[MAX_PATH];
+    DWORD   TextureBaseHeight;
+    WCHAR   ImGuiFontPath[MAX_PATH];
+    DWORD   ImGuiBaseFontSize;
+    DWORD   ImGuiBaseVerticalResolution;
+    MovementMode MovementMode;
+    // how many times per second the input thread computes the input, 0 when there's no thread
+    DWORD   InputThreadRate;
 };
-// This class must be instantiated with an initializer, preferably {}.
-typedef _GameConfigs<GameConfig, GAME_CONFIG_MAX_LEN> GameConfigs;
-static_assert(std::is_trivial<GameConfigs>::value);
 
 struct string_hash {
     using hash_type = std::hash<std::string_view>;
@@ -158,4 +192,22 @@ struct HWND_DESTROYER {
             DestroyWindow(hwnd);
     }
 };
-typedef std::unique_ptr<HWND, HWND_DESTROYER> WindowHandle;
\ No newline at end of file
+typedef std::unique_ptr<HWND, HWND_DESTROYER> WindowHandle;
+
+struct HANDLE_CLOSER {
+    typedef HANDLE pointer;
+    void operator()(HANDLE handle) const {
+        if (handle != NULL && handle != INVALID_HANDLE_VALUE)
+            CloseHandle(handle);
+    }
+};
+typedef std::unique_ptr<HANDLE, HANDLE_CLOSER> Handle;
+
+struct VIEW_UNMAPPER {
+    typedef LPVOID pointer;
+    void operator()(LPVOID view) const {
+        if (view != NULL)
+            UnmapViewOfFile(view);
+    }
+};
+typedef std::unique_ptr<LPVOID, VIEW_UNMAPPER> MappedView;
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "framework.h"
 #include <string>
+#include <string_view>
 
 #include "Helper.Encoding.h"
 
@@ -15,6 +16,17 @@ namespace common::helper::encoding {
         return output;
     }
 
+    // Write into a caller-provided buffer without null-terminating it, returns the required length in WCHARs.
+    // Nothing is written if the buffer is too small.
+    int ConvertToUtf16(string_view utf8str, wchar_t* output, int outputSize) {
+        if (utf8str.size() == 0)
+            return 0;
+        auto chrCount = MultiByteToWideChar(CP_UTF8, 0, utf8str.data(), int(utf8str.size()), nullptr, 0);
+        if (chrCount > 0 && chrCount <= outputSize)
+            MultiByteToWideChar(CP_UTF8, 0, utf8str.data(), int(utf8str.size()), output, chrCount);
+        return chrCount;
+    }
+
     string ConvertToUtf8(const wchar_t* utf16str) {
         auto byteCount = WideCharToMultiByte(CP_UTF8, 0, utf16str, -1, nullptr, 0, nullptr, nullptr);
         if (byteCount == 0)
@@ -2,8 +2,10 @@
 #include "framework.h"
 #include "macro.h"
 #include <string>
+#include <string_view>
 
 namespace common::helper::encoding {
     std::wstring ConvertToUtf16(const char* utf8str);
+    int ConvertToUtf16(std::string_view utf8str, wchar_t* output, int outputSize);
     std::string ConvertToUtf8(const wchar_t* utf16str);
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "framework.h"
 #include <string>
 #include <format>
+#include <vector>
+#include <algorithm>
 
 #include "Helper.Memory.h"
 #include "Variables.h"
@@ -8,26 +10,140 @@
 using namespace std;
 
 namespace common::helper::memory {
+    struct ReadableRange {
+        DWORD Begin;
+        DWORD End;
+    };
+    // a chain goes back and forth between a few regions, these are checked before searching the whole map
+    constexpr auto RecentRangeCount = 4;
+    // Readable regions of this process, sorted by address. A lookup that misses asks VirtualQuery and adds the region.
+    struct ReadableRangeCache {
+        vector<ReadableRange>   Ranges;
+        ReadableRange           RecentRanges[RecentRangeCount];
+        int                     NextRecentRange;
+        ULONGLONG               Time;
+    };
+    // One per thread, the input thread and a script on the game thread resolve addresses at the same time.
+    // The reads don't catch faults, so the map is dropped after about a frame, when a pointer chain leads somewhere else,
+    // and regions the game frees stay in it only that long.
+    thread_local ReadableRangeCache readableRangeCache;
+    // counted in time, the frames of some games aren't counted
+    constexpr ULONGLONG ReadableRangesLifetimeMs = 16;
+
+    bool IsReadable(const MEMORY_BASIC_INFORMATION& info) {
+        constexpr DWORD ReadableProtection = PAGE_READONLY | PAGE_READWRITE | PAGE_WRITECOPY
+            | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+        return info.State == MEM_COMMIT && (info.Protect & ReadableProtection) != 0 && (info.Protect & PAGE_GUARD) == 0;
+    }
+
+    bool FindReadableRange(ReadableRangeCache& cache, DWORD address, ReadableRange& found) {
+        auto range = upper_bound(cache.Ranges.begin(), cache.Ranges.end(), address, [](DWORD address, const ReadableRange& range) {
+            return address < range.Begin;
+        });
+        if (range == cache.Ranges.begin() || address >= (--range)->End)
+            return false;
+        found = *range;
+        return true;
+    }
+
+    // Unreadable regions aren't remembered, the game may allocate them later.
+    bool QueryReadableRange(ReadableRangeCache& cache, DWORD address, ReadableRange& found) {
+        MEMORY_BASIC_INFORMATION info;
+        if (VirtualQuery(LPCVOID(address), &info, sizeof(info)) != sizeof(info) || !IsReadable(info))
+            return false;
+        found = { DWORD(info.BaseAddress), DWORD(info.BaseAddress) + DWORD(info.RegionSize) };
+        // regions that changed since they were added may overlap the new one
+        erase_if(cache.Ranges, [&](const ReadableRange& range) {
+            return range.Begin < found.End && found.Begin < range.End;
+        });
+        auto position = upper_bound(cache.Ranges.begin(), cache.Ranges.end(), found.Begin, [](DWORD address, const ReadableRange& range) {
+            return address < range.Begin;
+        });
+        cache.Ranges.insert(position, found);
+        return true;
+    }
+
+    void ForgetReadableRanges() {
+        auto& cache = readableRangeCache;
+        cache.Ranges.clear();
+        memset(cache.RecentRanges, 0, sizeof(cache.RecentRanges));
+    }
+
+    bool IsReadable(DWORD address, DWORD size) {
+        auto& cache = readableRangeCache;
+        auto now = GetTickCount64();
+        if (now - cache.Time >= ReadableRangesLifetimeMs) {
+            ForgetReadableRanges();
+            cache.Time = now;
+        }
+        while (true) {
+            const ReadableRange* range = nullptr;
+            for (auto& recentRange : cache.RecentRanges) {
+                if (address - recentRange.Begin < recentRange.End - recentRange.Begin) {
+                    range = &recentRange;
+                    break;
+                }
+            }
+            if (!range) {
+                auto& slot = cache.RecentRanges[cache.NextRecentRange];
+                if (!FindReadableRange(cache, address, slot) && !QueryReadableRange(cache, address, slot))
+                    return false;
+                cache.NextRecentRange = (cache.NextRecentRange + 1) % RecentRangeCount;
+                range = &slot;
+            }
+            if (size <= range->End - address)
+                return true;
+            // the rest is in the next region
+            size -= range->End - address;
+            address = range->End;
+        }
+    }
+
+    bool TryRead(DWORD address, void* buffer, DWORD size) {
+        if (!IsReadable(address, size))
+            return false;
+        memcpy(buffer, (const void*)address, size);
+        return true;
+    }
+
+    bool TryReadDword(DWORD address, DWORD& value) {
+        return TryRead(address, &value, sizeof(value));
+    }
+
     DWORD ResolveAddress(DWORD* offsets, int length) {
         if (length <= 0)
             return NULL;
         auto address = offsets[0] + (DWORD)g_targetModule;
         for (int i = 1; i < length; i++) {
-            address = *PDWORD(address);
-            if (!address)
-                break;
+            if (!TryReadDword(address, address) || !address)
+                return NULL;
+            address += offsets[i];
+        }
+        return address;
+    }
+
+    // Same walk as above, through a memory view. An unreadable pointer gives 0 like a null one.
+    DWORD ResolveAddress(memoryview::MemoryView& view, const DWORD* offsets, int length) {
+        if (length <= 0)
+            return NULL;
+        auto address = offsets[0] + view.ModuleBase;
+        for (int i = 1; i < length; i++) {
+            if (!view.ReadDword(address, address) || !address)
+                return NULL;
             address += offsets[i];
         }
         return address;
     }
 
-    string GetAddressConfigAsString() {
-        if (g_currentConfig.ScriptType != ScriptType::None)
+    string GetAddressConfigAsString(const GameConfig& gameConfig) {
+        if (gameConfig.ScriptType != ScriptType::None)
             return "Using script";
+        if (gameConfig.Path.Length > 0)
+            return "Using pointer path";
         string rs;
         rs.reserve(128);
-        for (int i = 0; i < g_currentConfig.Address.Length; i++) {
-            auto offset = g_currentConfig.Address.Level[i];
+        for (int i = 0; i < gameConfig.Address.Length; i++) {
+            auto offset = gameConfig.Address.Level[i];
             rs.append(format("[{:x}]", offset));
         }
         return rs;
@@ -1,10 +1,19 @@
 #pragma once
 #include "framework.h"
 #include <string>
+#include "DataTypes.h"
+#include "MemoryView.h"
 
 namespace common::helper::memory {
     using ImportTableCallbackType = void (*)(LPCSTR importDllName);
+    bool IsReadable(const MEMORY_BASIC_INFORMATION& info);
+    // Whether size bytes at address can be read in this process, without touching them.
+    bool IsReadable(DWORD address, DWORD size);
+    // Read size bytes of this process, false instead of a crash if they aren't readable.
+    bool TryRead(DWORD address, void* buffer, DWORD size);
+    bool TryReadDword(DWORD address, DWORD& value);
     DWORD ResolveAddress(DWORD* offsets, int length);
-    std::string GetAddressConfigAsString();
+    DWORD ResolveAddress(memoryview::MemoryView& view, const DWORD* offsets, int length);
+    std::string GetAddressConfigAsString(const GameConfig& gameConfig);
     void ScanImportTable(HMODULE hModule, ImportTableCallbackType callback);
 }
\ No newline at end of file
@@ -1,13 +1,19 @@
 #include "framework.h"
 #include "macro.h"
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <charconv>
+#include <type_traits>
+#include <limits>
+#include <cctype>
 
 #include "Helper.h"
 #include "Helper.Memory.h"
 #include "Lua.h"
 #include "LuaJIT.h"
 #include "NeoLua.h"
+#include "PointerPath.h"
 #include "Variables.h"
 
 using namespace std;
@@ -22,6 +28,20 @@ namespace common::helper {
         LocalFree(errorMessage);
     }
 
+    bool PrintToConsole(string_view text) {
+        auto output = GetStdHandle(STD_OUTPUT_HANDLE);
+        Handle console;
+        if ((output == NULL || output == INVALID_HANDLE_VALUE) && AttachConsole(ATTACH_PARENT_PROCESS) != FALSE) {
+            console.reset(CreateFileA("CONOUT$", GENERIC_WRITE, FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL));
+            output = console.get();
+        }
+        if (output == NULL || output == INVALID_HANDLE_VALUE)
+            return false;
+        DWORD written;
+        WriteFile(output, text.data(), DWORD(text.size()), &written, NULL);
+        return true;
+    }
+
     string& Replace(string& input, const char* keyword, const char* replacement) {
         size_t keywordPos = 0;
         auto keywordLen = strlen(keyword);
@@ -33,37 +53,75 @@ namespace common::helper {
         return input;
     }
 
-    tuple<float, const char*> ConvertToFloat(const string& input) {
-        char* endPtr;
-        const char* message = nullptr;
-        auto result = strtof(input.c_str(), &endPtr);
-        if (errno == ERANGE)
-            message = "out of range (type float)";
-        else if (endPtr - input.c_str() != input.size() || input.size() == 0)
-            message = "invalid format";
-        return tuple(result, message);
+    // base 0 follows strtol's convention: "0x" prefix for hex, leading "0" for octal, otherwise decimal
+    string_view StripRadixPrefix(string_view input, int& base) {
+        auto hasHexPrefix = input.size() > 2 && input[0] == '0' && (input[1] == 'x' || input[1] == 'X');
+        if (base == 0) {
+            if (hasHexPrefix)
+                base = 16;
+            else if (input.size() > 1 && input[0] == '0')
+                base = 8;
+            else
+                base = 10;
+        }
+        if (base == 16 && hasHexPrefix)
+            input.remove_prefix(2);
+        return input;
+    }
+
+    /*
+    Accepts what strtof, strtol and strtoul accepted, the config files of existing users were written for them:
+    leading white space, a '+' or '-' sign, the sign before a "0x" prefix, hex floats,
+    and negative values for unsigned types, which wrap around.
+    */
+    template <typename T>
+    tuple<T, const char*> ConvertToNumber(string_view input, const char* rangeMessage, int base = 10) {
+        while (input.size() > 0 && isspace(UCHAR(input[0])))
+            input.remove_prefix(1);
+        auto negative = input.size() > 0 && input[0] == '-';
+        if (input.size() > 0 && (input[0] == '-' || input[0] == '+'))
+            input.remove_prefix(1);
+        T result{};
+        from_chars_result rs;
+        if constexpr (is_integral_v<T>) {
+            input = StripRadixPrefix(input, base);
+            if (input.size() == 0)
+                return tuple(result, "invalid format");
+            make_unsigned_t<T> magnitude{};
+            rs = from_chars(input.data(), input.data() + input.size(), magnitude, base);
+            // the most negative value has no positive counterpart
+            if (rs.ec == errc() && is_signed_v<T> && magnitude > make_unsigned_t<T>(numeric_limits<T>::max()) + negative)
+                rs.ec = errc::result_out_of_range;
+            result = T(negative ? 0 - magnitude : magnitude);
+        }
+        else {
+            auto format = chars_format::general;
+            if (input.size() > 2 && input[0] == '0' && (input[1] == 'x' || input[1] == 'X')) {
+                format = chars_format::hex;
+                input.remove_prefix(2);
+            }
+            if (input.size() == 0)
+                return tuple(result, "invalid format");
+            rs = from_chars(input.data(), input.data() + input.size(), result, format);
+            result = negative ? -result : result;
+        }
+        if (rs.ec == errc::result_out_of_range)
+            return tuple(result, rangeMessage);
+        if (rs.ec != errc() || rs.ptr != input.data() + input.size())
+            return tuple(result, "invalid format");
+        return tuple(result, nullptr);
+    }
+
+    tuple<float, const char*> ConvertToFloat(string_view input) {
+        return ConvertToNumber<float>(input, "out of range (type float)");
     }
 
-    tuple<long, const char*> ConvertToLong(const string& input, int base) {
-        char* endPtr;
-        const char* message = nullptr;
-        auto result = strtol(input.c_str(), &endPtr, base);
-        if (errno == ERANGE)
-            message = "out of range (type long)";
-        else if (endPtr - input.c_str() != input.size() || input.size() == 0)
-            message = "invalid format";
-        return tuple(result, message);
+    tuple<long, const char*> ConvertToLong(string_view input, int base) {
+        return ConvertToNumber<long>(input, "out of range (type long)", base);
     }
 
-    tuple<unsigned long, const char*> ConvertToULong(const string& input, int base) {
-        char* endPtr;
-        const char* message = nullptr;
-        auto result = strtoul(input.c_str(), &endPtr, base);
-        if (errno == ERANGE)
-            message = "out of range (type unsigned long)";
-        else if (endPtr - input.c_str() != input.size() || input.size() == 0)
-            message = "invalid format";
-        return tuple(result, message);
+    tuple<unsigned long, const char*> ConvertToULong(string_view input, int base) {
+        return ConvertToNumber<unsigned long>(input, "out of range (type unsigned long)", base);
     }
 
     void CalculateNextTone(UCHAR& tone, ModulateStage& toneStage) {
@@ -168,7 +226,9 @@ namespace common::helper {
             return neolua::GetPositionAddress();
         else if (g_currentConfig.ScriptType == ScriptType::Lua)
             return lua::GetPositionAddress();
+        else if (g_currentConfig.Path.Length > 0)
+            return pointerpath::Run(g_currentConfig.Path);
         else
-            return memory::ResolveAddress(g_currentConfig.Address.Level, g_currentConfig.Address.Length);        
+            return memory::ResolveAddress(g_currentConfig.Address.Level, g_currentConfig.Address.Length);
     }
 }
@@ -3,14 +3,17 @@
 #include "macro.h"
 #include <tuple>
 #include <string>
+#include <string_view>
 #include "DataTypes.h"
 
 namespace common::helper {
     void ReportLastError(const char* title);
+    // Write to the console the process was started from, false if there is none.
+    bool PrintToConsole(std::string_view text);
     std::string& Replace(std::string& input, const char* keyword, const char* replacement);
-    std::tuple<float, const char*> ConvertToFloat(const std::string& input);
-    std::tuple<long, const char*> ConvertToLong(const std::string& input, int base);
-    std::tuple<unsigned long, const char*> ConvertToULong(const std::string& input, int base);
+    std::tuple<float, const char*> ConvertToFloat(std::string_view input);
+    std::tuple<long, const char*> ConvertToLong(std::string_view input, int base);
+    std::tuple<unsigned long, const char*> ConvertToULong(std::string_view input, int base);
     void CalculateNextTone(UCHAR& tone, ModulateStage& toneStage);
     POINT GetPointerPosition();
     void RemoveWindowBorder(UINT width, UINT height);
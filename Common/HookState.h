@@ -0,0 +1,44 @@
+#pragma once
+#include "framework.h"
+#include <atomic>
+#include "DataTypes.h"
+#include "Variables.h"
+
+// The flags the message hooks write and the render hooks and the input thread read, packed in g_hookState
+// so that a reader gets all of them as they were at the same moment with one load.
+namespace common::hookstate {
+    // A consistent copy of every flag.
+    inline HookState Load() {
+        return HookState(std::atomic_ref(g_hookState).load(std::memory_order_acquire));
+    }
+
+    // Whether all of the flags are set in the copy.
+    inline bool Has(HookState state, HookState flags) {
+        return (state & flags) == flags;
+    }
+
+    // Set or clear the flags together, returns the state before.
+    inline HookState Set(HookState flags, bool value) {
+        std::atomic_ref state(g_hookState);
+        if (value)
+            return HookState(state.fetch_or(DWORD(flags), std::memory_order_acq_rel));
+        return HookState(state.fetch_and(~DWORD(flags), std::memory_order_acq_rel));
+    }
+
+    // Flip the flags, returns the state after.
+    inline HookState Toggle(HookState flags) {
+        return HookState(std::atomic_ref(g_hookState).fetch_xor(DWORD(flags), std::memory_order_acq_rel) ^ DWORD(flags));
+    }
+
+    // Replace the whole state with change(state) in one step, for changes that depend on other flags.
+    // change can run more than once, returns the state after.
+    template <typename F>
+    HookState Update(F change) {
+        std::atomic_ref state(g_hookState);
+        auto current = state.load(std::memory_order_relaxed);
+        auto next = DWORD(change(HookState(current)));
+        while (!state.compare_exchange_weak(current, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+            next = DWORD(change(HookState(current)));
+        return HookState(next);
+    }
+}
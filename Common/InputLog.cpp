@@ -0,0 +1,282 @@
+#include "framework.h"
+#include <vector>
+#include <cstring>
+#include <cstdint>
+
+#include "DataTypes.h"
+#include "InputLog.h"
+
+namespace inputlog = common::inputlog;
+
+using namespace std;
+using inputlog::Frame;
+
+/*
+Input log layout:
+- LogHeader
+- frames, up to the end of the file, each a ChangedField byte followed by the fields it names in the same order
+Integers are 32 bits in the file, so a log recorded by the game reads the same in a build where DWORD is wider.
+*/
+constexpr DWORD LogMagic = 'LIXT';
+constexpr DWORD LogVersion = 1;
+// the buffer is written to the file once it's that full
+constexpr size_t LogBufferSize = 0x10000;
+
+struct LogHeader {
+    uint32_t    Magic;
+    uint32_t    Version;
+};
+
+namespace ChangedField {
+    // the frame count didn't go up by one
+    constexpr BYTE FrameCount = 1 << 0;
+    // the flags and the movement mode
+    constexpr BYTE State = 1 << 1;
+    constexpr BYTE Mouse = 1 << 2;
+    constexpr BYTE PlayerX = 1 << 3;
+    constexpr BYTE PlayerY = 1 << 4;
+    // the client size and the aspect ratio
+    constexpr BYTE Geometry = 1 << 5;
+    // the pixel rate and the pixel offset
+    constexpr BYTE Scale = 1 << 6;
+    constexpr BYTE Input = 1 << 7;
+}
+
+BYTE PackState(const Frame& frame) {
+    return BYTE(frame.InputEnabled) | BYTE(frame.ShowImGui) << 1 | BYTE(frame.LeftPressed) << 2
+        | BYTE(frame.MidPressed) << 3 | BYTE(frame.HasPosition) << 4 | BYTE(frame.MovementMode) << 5;
+}
+
+void UnpackState(BYTE state, Frame& frame) {
+    frame.InputEnabled = (state & 1) != 0;
+    frame.ShowImGui = (state & 1 << 1) != 0;
+    frame.LeftPressed = (state & 1 << 2) != 0;
+    frame.MidPressed = (state & 1 << 3) != 0;
+    frame.HasPosition = (state & 1 << 4) != 0;
+    frame.MovementMode = MovementMode(state >> 5);
+}
+
+void WriteVarint(vector<BYTE>& output, uint32_t value) {
+    while (value >= 0x80) {
+        output.push_back(BYTE(value) | 0x80);
+        value >>= 7;
+    }
+    output.push_back(BYTE(value));
+}
+
+// small differences either way make small varints
+void WriteDifference(vector<BYTE>& output, LONG current, LONG previous) {
+    auto difference = int32_t(uint32_t(current) - uint32_t(previous));
+    WriteVarint(output, uint32_t(difference) << 1 ^ uint32_t(difference >> 31));
+}
+
+template <typename T>
+void WriteValue(vector<BYTE>& output, T value) {
+    auto bytes = (const BYTE*)&value;
+    output.insert(output.end(), bytes, bytes + sizeof(T));
+}
+
+bool Same(float left, float right) {
+    return memcmp(&left, &right, sizeof(float)) == 0;
+}
+
+bool Same(double left, double right) {
+    return memcmp(&left, &right, sizeof(double)) == 0;
+}
+
+void Encode(const Frame& previous, const Frame& frame, vector<BYTE>& output) {
+    BYTE changes = 0;
+    if (uint32_t(frame.FrameCount) != uint32_t(previous.FrameCount + 1))
+        changes |= ChangedField::FrameCount;
+    if (PackState(frame) != PackState(previous))
+        changes |= ChangedField::State;
+    if (frame.MousePosition.x != previous.MousePosition.x || frame.MousePosition.y != previous.MousePosition.y)
+        changes |= ChangedField::Mouse;
+    if (!Same(frame.PlayerPositionRaw.X, previous.PlayerPositionRaw.X))
+        changes |= ChangedField::PlayerX;
+    if (!Same(frame.PlayerPositionRaw.Y, previous.PlayerPositionRaw.Y))
+        changes |= ChangedField::PlayerY;
+    if (frame.ClientSize.cx != previous.ClientSize.cx || frame.ClientSize.cy != previous.ClientSize.cy
+        || !Same(frame.AspectRatio.X, previous.AspectRatio.X) || !Same(frame.AspectRatio.Y, previous.AspectRatio.Y))
+        changes |= ChangedField::Geometry;
+    if (!Same(frame.PixelRate, previous.PixelRate)
+        || !Same(frame.PixelOffset.X, previous.PixelOffset.X) || !Same(frame.PixelOffset.Y, previous.PixelOffset.Y))
+        changes |= ChangedField::Scale;
+    if (frame.GameInput != previous.GameInput)
+        changes |= ChangedField::Input;
+
+    output.push_back(changes);
+    if (changes & ChangedField::FrameCount)
+        WriteDifference(output, LONG(frame.FrameCount), LONG(previous.FrameCount + 1));
+    if (changes & ChangedField::State)
+        output.push_back(PackState(frame));
+    if (changes & ChangedField::Mouse) {
+        WriteDifference(output, frame.MousePosition.x, previous.MousePosition.x);
+        WriteDifference(output, frame.MousePosition.y, previous.MousePosition.y);
+    }
+    if (changes & ChangedField::PlayerX)
+        WriteValue(output, frame.PlayerPositionRaw.X);
+    if (changes & ChangedField::PlayerY)
+        WriteValue(output, frame.PlayerPositionRaw.Y);
+    if (changes & ChangedField::Geometry) {
+        WriteDifference(output, frame.ClientSize.cx, previous.ClientSize.cx);
+        WriteDifference(output, frame.ClientSize.cy, previous.ClientSize.cy);
+        WriteValue(output, frame.AspectRatio);
+    }
+    if (changes & ChangedField::Scale) {
+        WriteValue(output, frame.PixelRate);
+        WriteValue(output, frame.PixelOffset);
+    }
+    if (changes & ChangedField::Input)
+        WriteVarint(output, uint32_t(frame.GameInput));
+}
+
+// Reads the fields of a frame from a buffer, every read fails once the buffer is overrun.
+struct FrameReader {
+    const BYTE* Position;
+    const BYTE* End;
+
+    bool ReadVarint(uint32_t& value) {
+        value = 0;
+        for (auto shift = 0; shift < 35; shift += 7) {
+            if (Position == End)
+                return false;
+            auto byte = *Position++;
+            value |= uint32_t(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool ReadDifference(LONG& value, LONG previous) {
+        uint32_t zigzag;
+        if (!ReadVarint(zigzag))
+            return false;
+        value = LONG(int32_t(uint32_t(previous) + (zigzag >> 1 ^ (0 - (zigzag & 1)))));
+        return true;
+    }
+
+    template <typename T>
+    bool ReadValue(T& value) {
+        if (size_t(End - Position) < sizeof(T))
+            return false;
+        memcpy(&value, Position, sizeof(T));
+        Position += sizeof(T);
+        return true;
+    }
+};
+
+bool Decode(FrameReader& reader, const Frame& previous, Frame& frame) {
+    frame = previous;
+    frame.FrameCount = DWORD(uint32_t(previous.FrameCount + 1));
+    BYTE changes;
+    if (!reader.ReadValue(changes))
+        return false;
+    LONG frameCount = frame.FrameCount;
+    uint32_t gameInput;
+    BYTE state;
+    auto succeeded = true;
+    if (changes & ChangedField::FrameCount) {
+        succeeded = succeeded && reader.ReadDifference(frameCount, LONG(frame.FrameCount));
+        frame.FrameCount = DWORD(uint32_t(frameCount));
+    }
+    if (changes & ChangedField::State) {
+        succeeded = succeeded && reader.ReadValue(state);
+        if (succeeded)
+            UnpackState(state, frame);
+    }
+    if (changes & ChangedField::Mouse) {
+        succeeded = succeeded && reader.ReadDifference(frame.MousePosition.x, previous.MousePosition.x)
+            && reader.ReadDifference(frame.MousePosition.y, previous.MousePosition.y);
+    }
+    if (changes & ChangedField::PlayerX)
+        succeeded = succeeded && reader.ReadValue(frame.PlayerPositionRaw.X);
+    if (changes & ChangedField::PlayerY)
+        succeeded = succeeded && reader.ReadValue(frame.PlayerPositionRaw.Y);
+    if (changes & ChangedField::Geometry) {
+        succeeded = succeeded && reader.ReadDifference(frame.ClientSize.cx, previous.ClientSize.cx)
+            && reader.ReadDifference(frame.ClientSize.cy, previous.ClientSize.cy)
+            && reader.ReadValue(frame.AspectRatio);
+    }
+    if (changes & ChangedField::Scale)
+        succeeded = succeeded && reader.ReadValue(frame.PixelRate) && reader.ReadValue(frame.PixelOffset);
+    if (changes & ChangedField::Input) {
+        succeeded = succeeded && reader.ReadVarint(gameInput);
+        frame.GameInput = GameInput(gameInput);
+    }
+    return succeeded;
+}
+
+bool Flush(inputlog::Writer& writer) {
+    DWORD written;
+    auto size = DWORD(writer.Buffer.size());
+    auto succeeded = WriteFile(writer.File.get(), writer.Buffer.data(), size, &written, NULL) != FALSE && written == size;
+    writer.Buffer.clear();
+    return succeeded;
+}
+
+namespace common::inputlog {
+    bool Open(Writer& writer, const WCHAR* path) {
+        writer.File.reset(CreateFileW(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL));
+        if (writer.File.get() == INVALID_HANDLE_VALUE)
+            return false;
+        writer.Buffer.clear();
+        writer.Buffer.reserve(LogBufferSize + sizeof(Frame) * 2);
+        writer.Previous = {};
+        LogHeader header{ .Magic = LogMagic, .Version = LogVersion };
+        WriteValue(writer.Buffer, header);
+        return Flush(writer);
+    }
+
+    bool Append(Writer& writer, const Frame& frame) {
+        Encode(writer.Previous, frame, writer.Buffer);
+        writer.Previous = frame;
+        if (writer.Buffer.size() < LogBufferSize)
+            return true;
+        return Flush(writer);
+    }
+
+    bool Close(Writer& writer) {
+        auto succeeded = Flush(writer);
+        writer.File.reset();
+        return succeeded;
+    }
+
+    bool Read(const WCHAR* path, vector<Frame>& frames) {
+        Handle file(CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL));
+        if (file.get() == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file.get(), &fileSize) == FALSE)
+            return false;
+        if (fileSize.QuadPart < LONGLONG(sizeof(LogHeader)) || fileSize.QuadPart > MAXDWORD) {
+            SetLastError(ERROR_BAD_FORMAT);
+            return false;
+        }
+        vector<BYTE> content(size_t(fileSize.QuadPart));
+        DWORD read;
+        if (ReadFile(file.get(), content.data(), DWORD(content.size()), &read, NULL) == FALSE)
+            return false;
+        LogHeader header;
+        memcpy(&header, content.data(), sizeof(header));
+        if (read != content.size() || header.Magic != LogMagic || header.Version != LogVersion) {
+            SetLastError(ERROR_BAD_FORMAT);
+            return false;
+        }
+
+        frames.clear();
+        FrameReader reader{ .Position = content.data() + sizeof(header), .End = content.data() + content.size() };
+        Frame previous{};
+        while (reader.Position != reader.End) {
+            Frame frame;
+            if (!Decode(reader, previous, frame)) {
+                SetLastError(ERROR_BAD_FORMAT);
+                return false;
+            }
+            frames.push_back(frame);
+            previous = frame;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "framework.h"
+#include <vector>
+#include "DataTypes.h"
+
+/*
+Input log: what each input was computed from, and the input, to compute it again without the game.
+A frame is delta encoded against the previous one: a byte telling which fields changed, then only those.
+Integers are written as zigzag varints of their difference, floating point values as they are.
+A frame where only the cursor moved takes 3 to 7 bytes.
+*/
+namespace common::inputlog {
+    struct Frame {
+        // g_frameCount, there can be several frames per game frame, e.g. with the input thread
+        DWORD           FrameCount;
+        bool            InputEnabled;
+        bool            ShowImGui;
+        bool            LeftPressed;
+        bool            MidPressed;
+        // false when there was no player position to read
+        bool            HasPosition;
+        POINT           MousePosition;
+        DoublePoint     PlayerPositionRaw;
+        // what the player position was scaled with, see core::inputdetermine
+        SIZE            ClientSize;
+        FloatPoint      AspectRatio;
+        float           PixelRate;
+        FloatPoint      PixelOffset;
+        MovementMode    MovementMode;
+        GameInput       GameInput;
+    };
+
+    // Writes are buffered, so a frame costs no file access most of the time.
+    struct Writer {
+        Handle              File;
+        std::vector<BYTE>   Buffer;
+        Frame               Previous;
+    };
+
+    // Create the log file, replacing an existing one.
+    bool Open(Writer& writer, const WCHAR* path);
+    bool Append(Writer& writer, const Frame& frame);
+    // Write what is left in the buffer and close the file.
+    bool Close(Writer& writer);
+    // Every frame of the log, fails with ERROR_BAD_FORMAT on a file that isn't one or is cut short.
+    bool Read(const WCHAR* path, std::vector<Frame>& frames);
+}
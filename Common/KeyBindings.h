@@ -0,0 +1,34 @@
+#pragma once
+#include "framework.h"
+#include <atomic>
+#include "DataTypes.h"
+#include "Variables.h"
+
+// The buttons of g_sharedConfig packed in g_keyBindings. g_sharedConfig is replaced under the lock of the input
+// computation, but the message and input hooks read the buttons on their own threads without it, so they read
+// this copy, which is replaced with one store. A button per byte of the DWORD, the lowest first.
+namespace common::keybindings {
+    struct KeyBindings {
+        BYTE    BombButton;
+        BYTE    ExtraButton;
+        BYTE    ToggleOsCursorButton;
+        BYTE    ToggleImGuiButton;
+    };
+
+    inline KeyBindings Load() {
+        auto packed = std::atomic_ref(g_keyBindings).load(std::memory_order_acquire);
+        return {
+            .BombButton = BYTE(packed),
+            .ExtraButton = BYTE(packed >> 8),
+            .ToggleOsCursorButton = BYTE(packed >> 16),
+            .ToggleImGuiButton = BYTE(packed >> 24),
+        };
+    }
+
+    // Call after each change of g_sharedConfig.
+    inline void Publish(const SharedConfig& config) {
+        auto packed = DWORD(config.BombButton) | DWORD(config.ExtraButton) << 8
+            | DWORD(BYTE(config.ToggleOsCursorButton)) << 16 | DWORD(BYTE(config.ToggleImGuiButton)) << 24;
+        std::atomic_ref(g_keyBindings).store(packed, std::memory_order_release);
+    }
+}
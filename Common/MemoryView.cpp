@@ -0,0 +1,200 @@
+#include "framework.h"
+#include <tlhelp32.h>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#include "macro.h"
+#include "DataTypes.h"
+#include "Variables.h"
+#include "MemoryView.h"
+#include "Helper.Memory.h"
+
+namespace memory = common::helper::memory;
+
+using namespace std;
+
+/*
+Snapshot file layout:
+- SnapshotHeader
+- SnapshotRegion[RegionCount], sorted by BaseAddress
+- the bytes of every region, at SnapshotRegion::DataOffset
+*/
+constexpr DWORD SnapshotMagic = 'GXMS';
+constexpr DWORD SnapshotVersion = 2;
+
+struct SnapshotHeader {
+    DWORD   Magic;
+    DWORD   Version;
+    DWORD   ModuleBase;
+    DWORD   ModuleSize;
+    DWORD   RegionCount;
+};
+
+struct SnapshotRegion {
+    DWORD   BaseAddress;
+    DWORD   Size;
+    DWORD   DataOffset;
+};
+
+// how much of a region is copied into the snapshot file at once
+constexpr DWORD SnapshotChunkSize = 0x100000;
+
+struct SnapshotView : common::memoryview::MemoryView {
+    Handle                  Mapping;
+    MappedView              View;
+    const SnapshotRegion*   Regions;
+    DWORD                   RegionCount;
+    const BYTE*             Data;
+
+    bool Read(DWORD address, void* buffer, DWORD size) override {
+        auto regionsEnd = Regions + RegionCount;
+        auto region = upper_bound(Regions, regionsEnd, address, [](DWORD address, const SnapshotRegion& region) {
+            return address < region.BaseAddress;
+        });
+        if (region == Regions)
+            return false;
+        region--;
+        if (ULONGLONG(address) + size > ULONGLONG(region->BaseAddress) + region->Size)
+            return false;
+        memcpy(buffer, Data + region->DataOffset + (address - region->BaseAddress), size);
+        return true;
+    }
+
+    vector<common::memoryview::MemoryRegion> ListRegions() override {
+        vector<common::memoryview::MemoryRegion> regions;
+        regions.reserve(RegionCount);
+        for (DWORD i = 0; i < RegionCount; i++)
+            regions.push_back({ Regions[i].BaseAddress, Regions[i].Size, Data + Regions[i].DataOffset });
+        return regions;
+    }
+};
+
+DWORD GetModuleSize(HMODULE module) {
+    auto dosHeader = (PIMAGE_DOS_HEADER)module;
+    auto ntHeaders = (PIMAGE_NT_HEADERS)((DWORD_PTR)module + dosHeader->e_lfanew);
+    return ntHeaders->OptionalHeader.SizeOfImage;
+}
+
+bool GetMainModule(DWORD processId, DWORD& moduleBase, DWORD& moduleSize) {
+    Handle snapshot;
+    for (auto i = 0; i < 5; i++) {
+        // CreateToolhelp32Snapshot can fail with ERROR_BAD_LENGTH for no obvious reason, so just retry if that's the case.
+        snapshot.reset(CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, processId));
+        if (snapshot.get() != INVALID_HANDLE_VALUE || GetLastError() != ERROR_BAD_LENGTH)
+            break;
+    }
+    if (snapshot.get() == INVALID_HANDLE_VALUE)
+        return false;
+    MODULEENTRY32W module{ .dwSize = sizeof(module) };
+    if (Module32FirstW(snapshot.get(), &module) == FALSE)
+        return false;
+    moduleBase = DWORD(module.modBaseAddr);
+    moduleSize = module.modBaseSize;
+    return true;
+}
+
+bool IsWritable(const MEMORY_BASIC_INFORMATION& info) {
+    constexpr auto WritableProtect = PAGE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+    return (info.Protect & WritableProtect) != 0;
+}
+
+// Works for this process too with GetCurrentProcess(), ReadProcessMemory copes with regions freed while writing.
+bool WriteSnapshot(HANDLE process, DWORD moduleBase, DWORD moduleSize, const WCHAR* snapshotPath, bool writableOnly) {
+    // list the regions first, writing the file allocates memory and changes them
+    vector<SnapshotRegion> regions;
+    MEMORY_BASIC_INFORMATION info;
+    for (auto address = (BYTE*)NULL; VirtualQueryEx(process, address, &info, sizeof(info)) == sizeof(info); address = (BYTE*)info.BaseAddress + info.RegionSize) {
+        if (memory::IsReadable(info) && (!writableOnly || IsWritable(info)))
+            regions.push_back({ DWORD(info.BaseAddress), DWORD(info.RegionSize) });
+    }
+    SnapshotHeader header{
+        .Magic = SnapshotMagic,
+        .Version = SnapshotVersion,
+        .ModuleBase = moduleBase,
+        .ModuleSize = moduleSize,
+        .RegionCount = DWORD(regions.size()),
+    };
+    auto dataOffset = ULONGLONG(sizeof(header) + regions.size() * sizeof(SnapshotRegion));
+    for (auto& region : regions) {
+        region.DataOffset = DWORD(dataOffset);
+        dataOffset += region.Size;
+    }
+    if (dataOffset > MAXDWORD) {
+        SetLastError(ERROR_FILE_TOO_LARGE);
+        return false;
+    }
+
+    Handle file(CreateFileW(snapshotPath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL));
+    if (file.get() == INVALID_HANDLE_VALUE)
+        return false;
+    DWORD written;
+    auto succeeded = WriteFile(file.get(), &header, sizeof(header), &written, NULL) != FALSE
+        && WriteFile(file.get(), regions.data(), DWORD(regions.size() * sizeof(SnapshotRegion)), &written, NULL) != FALSE;
+    vector<BYTE> buffer(SnapshotChunkSize);
+    for (auto& region : regions) {
+        for (DWORD offset = 0; succeeded && offset < region.Size; offset += SnapshotChunkSize) {
+            auto size = region.Size - offset < SnapshotChunkSize ? region.Size - offset : SnapshotChunkSize;
+            // a region freed since it was listed is saved as zeroes, its place in the file is already taken
+            SIZE_T read = 0;
+            if (ReadProcessMemory(process, (LPCVOID)(region.BaseAddress + offset), buffer.data(), size, &read) == FALSE)
+                memset(buffer.data() + read, 0, size - read);
+            succeeded = WriteFile(file.get(), buffer.data(), size, &written, NULL) != FALSE && written == size;
+        }
+    }
+    file.reset();
+    if (!succeeded)
+        DeleteFileW(snapshotPath);
+    return succeeded;
+}
+
+namespace common::memoryview {
+    unique_ptr<MemoryView> OpenSnapshot(const WCHAR* snapshotPath) {
+        Handle file(CreateFileW(snapshotPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL));
+        if (file.get() == INVALID_HANDLE_VALUE)
+            return nullptr;
+        LARGE_INTEGER fileSize{};
+        if (GetFileSizeEx(file.get(), &fileSize) == FALSE || ULONGLONG(fileSize.QuadPart) < sizeof(SnapshotHeader))
+            return nullptr;
+        auto view = make_unique<SnapshotView>();
+        view->Mapping.reset(CreateFileMappingA(file.get(), NULL, PAGE_READONLY, 0, 0, NULL));
+        view->View.reset(view->Mapping ? MapViewOfFile(view->Mapping.get(), FILE_MAP_READ, 0, 0, 0) : NULL);
+        if (!view->View)
+            return nullptr;
+
+        auto data = (const BYTE*)view->View.get();
+        auto size = ULONGLONG(fileSize.QuadPart);
+        auto& header = *(const SnapshotHeader*)data;
+        if (header.Magic != SnapshotMagic || header.Version != SnapshotVersion)
+            return nullptr;
+        if (sizeof(SnapshotHeader) + ULONGLONG(header.RegionCount) * sizeof(SnapshotRegion) > size)
+            return nullptr;
+        view->Regions = (const SnapshotRegion*)(data + sizeof(SnapshotHeader));
+        view->RegionCount = header.RegionCount;
+        for (DWORD i = 0; i < header.RegionCount; i++) {
+            auto& region = view->Regions[i];
+            if (ULONGLONG(region.DataOffset) + region.Size > size)
+                return nullptr;
+            if (i > 0 && region.BaseAddress < view->Regions[i - 1].BaseAddress)
+                return nullptr;
+        }
+        view->Data = data;
+        view->ModuleBase = header.ModuleBase;
+        view->ModuleSize = header.ModuleSize;
+        return view;
+    }
+
+    bool SaveSnapshot(const WCHAR* snapshotPath, bool writableOnly) {
+        return WriteSnapshot(GetCurrentProcess(), DWORD(g_targetModule), GetModuleSize(g_targetModule), snapshotPath, writableOnly);
+    }
+
+    bool SaveProcessSnapshot(DWORD processId, const WCHAR* snapshotPath, bool writableOnly) {
+        Handle process(::OpenProcess(PROCESS_VM_READ | PROCESS_QUERY_INFORMATION, FALSE, processId));
+        if (!process)
+            return false;
+        DWORD moduleBase, moduleSize;
+        if (!GetMainModule(processId, moduleBase, moduleSize))
+            return false;
+        return WriteSnapshot(process.get(), moduleBase, moduleSize, snapshotPath, writableOnly);
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "framework.h"
+#include <memory>
+#include <vector>
+
+namespace common::memoryview {
+    struct MemoryRegion {
+        DWORD       BaseAddress;
+        DWORD       Size;
+        const BYTE* Data;
+    };
+
+    // Game memory read from a snapshot file instead of through a raw pointer.
+    struct MemoryView {
+        // base address of the game module in the viewed memory
+        DWORD ModuleBase;
+        DWORD ModuleSize;
+
+        virtual ~MemoryView() = default;
+        // Copy size bytes at address, false if any of them can't be read.
+        virtual bool Read(DWORD address, void* buffer, DWORD size) = 0;
+        // Every readable region sorted by address, with its bytes. Only snapshots have them at hand, other views give none.
+        virtual std::vector<MemoryRegion> ListRegions() { return {}; }
+
+        bool ReadDword(DWORD address, DWORD& value) {
+            return Read(address, &value, sizeof(value));
+        }
+    };
+
+    std::unique_ptr<MemoryView> OpenSnapshot(const WCHAR* snapshotPath);
+    // Save every readable region of this process, to be opened with OpenSnapshot elsewhere.
+    // Only the writable ones with writableOnly, enough for a value scan and much smaller.
+    bool SaveSnapshot(const WCHAR* snapshotPath, bool writableOnly);
+    // The same for another process, without ThMouseX being in it.
+    bool SaveProcessSnapshot(DWORD processId, const WCHAR* snapshotPath, bool writableOnly);
+}
@@ -0,0 +1,522 @@
+#include "framework.h"
+#include "macro.h"
+#include <tuple>
+#include <string_view>
+
+#include "Helper.h"
+#include "Helper.Memory.h"
+#include "PointerPath.h"
+#include "Variables.h"
+
+namespace helper = common::helper;
+namespace memory = common::helper::memory;
+
+using namespace std;
+
+/*
+Every instruction is one DWORD: the opcode in the low byte, and an operand in the upper 24 bits.
+ConstWide and In are followed by their immediate DWORDs. Jump targets are positions in PointerPath::Code.
+*/
+enum class Op : BYTE {
+    Const,      // push the operand
+    ConstWide,  // push the next word
+    Module,
+    Index,
+    Add,
+    Sub,
+    Mul,
+    Deref,
+    // merged instructions, see Compiler::Replace
+    AddConst,           // add the operand
+    MulConst,           // multiply by the operand
+    DerefOffset,        // [x + operand]
+    ModuleOffset,       // module + operand
+    LoadModuleOffset,   // [module + operand]
+    AddIndex,           // x + i * operand
+    DerefIndex,         // [x + i * operand]
+    Equal,
+    NotEqual,
+    Less,
+    In,         // the operand is the count of the constants that follow
+    JumpIfZero, // pop, and jump to the operand if 0
+    Jump,
+    LoopBegin,  // pop the count, the operand is the position of the matching LoopNext
+    LoopNext,   // pop the result of the loop body
+};
+
+constexpr auto StackMaxDepth = 16;
+constexpr DWORD OperandMax = 0xFFFFFF;
+// so a garbage pool count can't hang the game
+constexpr DWORD LoopMaxCount = 0x10000;
+constexpr DWORD NoHit = MAXDWORD;
+
+constexpr DWORD MakeInstruction(Op op, DWORD operand = 0) {
+    return DWORD(op) | operand << 8;
+}
+
+bool IsWordChar(char chr) {
+    return chr >= '0' && chr <= '9' || chr >= 'a' && chr <= 'z' || chr >= 'A' && chr <= 'Z' || chr == '_';
+}
+
+// Recursive descent, from the lowest precedence:
+// select  = compare ["?" select ":" select]
+// compare = sum [("==" | "!=" | "<") sum]
+// sum     = product {("+" | "-") product}
+// product = primary {"*" primary}
+struct Compiler {
+    string_view     Source;
+    PointerPath&    Path;
+    size_t          Position;
+    int             Depth;
+    // the positions of the last two instructions, -1 when unknown
+    int             LastInstruction;
+    int             PreviousInstruction;
+    // the position of the latest jump target, instructions can't be merged across it
+    int             JumpTarget;
+    bool            HasLoop;
+    bool            InLoop;
+    const char*     ErrorMessage;
+    string_view     ErrorLocation;
+
+    bool Fail(const char* message, string_view location) {
+        ErrorMessage = message;
+        ErrorLocation = location;
+        return false;
+    }
+
+    bool Fail(const char* message) {
+        return Fail(message, Source.substr(Position, Position < Source.size() ? 1 : 0));
+    }
+
+    void SkipSpaces() {
+        while (Position < Source.size() && (Source[Position] == ' ' || Source[Position] == '\t'))
+            Position++;
+    }
+
+    bool Accept(string_view token) {
+        SkipSpaces();
+        if (Source.substr(Position).starts_with(token)) {
+            Position += token.size();
+            return true;
+        }
+        return false;
+    }
+
+    bool Expect(string_view token, const char* message) {
+        return Accept(token) || Fail(message);
+    }
+
+    string_view NextWord() {
+        SkipSpaces();
+        auto start = Position;
+        while (Position < Source.size() && IsWordChar(Source[Position]))
+            Position++;
+        return Source.substr(start, Position - start);
+    }
+
+    bool EmitWord(DWORD word) {
+        if (Path.Length >= POINTER_PATH_MAX_LEN)
+            return Fail("expression is too long");
+        Path.Code[Path.Length++] = word;
+        return true;
+    }
+
+    bool Emit(Op op, int stackEffect, DWORD operand = 0) {
+        Depth += stackEffect;
+        if (Depth > StackMaxDepth)
+            return Fail("expression is nested too deeply");
+        PreviousInstruction = LastInstruction;
+        LastInstruction = Path.Length;
+        return EmitWord(MakeInstruction(op, operand));
+    }
+
+    void Patch(int position, DWORD operand) {
+        Path.Code[position] = (Path.Code[position] & 0xFF) | operand << 8;
+    }
+
+    // Whether the instruction at the position is the given one, and nothing jumps past it.
+    bool IsMergeable(int position, Op op) {
+        return position >= 0 && position >= JumpTarget && Op(Path.Code[position] & 0xFF) == op;
+    }
+
+    DWORD OperandAt(int position) {
+        return Path.Code[position] >> 8;
+    }
+
+    // Merge the instruction being emitted into one of the last two, dropping everything after the position.
+    // Most of a pointer path is "[x + offset]" and "[x + i * size]", this cuts the instructions the interpreter dispatches.
+    bool Replace(int position, Op op, DWORD operand, int stackEffect) {
+        Path.Code[position] = MakeInstruction(op, operand);
+        Path.Length = position + 1;
+        if (position != LastInstruction) {
+            LastInstruction = position;
+            PreviousInstruction = -1;
+        }
+        Depth += stackEffect;
+        return true;
+    }
+
+    bool EmitAdd() {
+        if (IsMergeable(LastInstruction, Op::Const)) {
+            if (IsMergeable(PreviousInstruction, Op::Module))
+                return Replace(PreviousInstruction, Op::ModuleOffset, OperandAt(LastInstruction), -1);
+            return Replace(LastInstruction, Op::AddConst, OperandAt(LastInstruction), -1);
+        }
+        if (IsMergeable(LastInstruction, Op::MulConst) && IsMergeable(PreviousInstruction, Op::Index))
+            return Replace(PreviousInstruction, Op::AddIndex, OperandAt(LastInstruction), -1);
+        return Emit(Op::Add, -1);
+    }
+
+    bool EmitMul() {
+        if (IsMergeable(LastInstruction, Op::Const))
+            return Replace(LastInstruction, Op::MulConst, OperandAt(LastInstruction), -1);
+        return Emit(Op::Mul, -1);
+    }
+
+    bool EmitDeref() {
+        if (IsMergeable(LastInstruction, Op::AddConst))
+            return Replace(LastInstruction, Op::DerefOffset, OperandAt(LastInstruction), 0);
+        if (IsMergeable(LastInstruction, Op::ModuleOffset))
+            return Replace(LastInstruction, Op::LoadModuleOffset, OperandAt(LastInstruction), 0);
+        if (IsMergeable(LastInstruction, Op::AddIndex))
+            return Replace(LastInstruction, Op::DerefIndex, OperandAt(LastInstruction), 0);
+        return Emit(Op::Deref, 0);
+    }
+
+    bool Constant(string_view word, DWORD& value) {
+        if (word.empty())
+            return Fail("expected a value");
+        auto [number, convMessage] = helper::ConvertToULong(word, 16);
+        if (convMessage != nullptr)
+            return Fail(convMessage, word);
+        value = number;
+        return true;
+    }
+
+    bool Select() {
+        if (!Compare())
+            return false;
+        if (!Accept("?"))
+            return true;
+        auto jumpToElse = Path.Length;
+        if (!Emit(Op::JumpIfZero, -1) || !Select() || !Expect(":", "expected ':'"))
+            return false;
+        auto jumpToEnd = Path.Length;
+        // the else branch starts from the same depth as the then branch
+        if (!Emit(Op::Jump, -1))
+            return false;
+        Patch(jumpToElse, Path.Length);
+        JumpTarget = Path.Length;
+        if (!Select())
+            return false;
+        Patch(jumpToEnd, Path.Length);
+        JumpTarget = Path.Length;
+        return true;
+    }
+
+    bool Compare() {
+        if (!Sum())
+            return false;
+        Op op;
+        if (Accept("=="))
+            op = Op::Equal;
+        else if (Accept("!="))
+            op = Op::NotEqual;
+        else if (Accept("<"))
+            op = Op::Less;
+        else
+            return true;
+        return Sum() && Emit(op, -1);
+    }
+
+    bool Sum() {
+        if (!Product())
+            return false;
+        while (true) {
+            if (Accept("+")) {
+                if (!Product() || !EmitAdd())
+                    return false;
+            }
+            else if (Accept("-")) {
+                if (!Product() || !Emit(Op::Sub, -1))
+                    return false;
+            }
+            else
+                return true;
+        }
+    }
+
+    bool Product() {
+        if (!Primary())
+            return false;
+        while (Accept("*")) {
+            if (!Primary() || !EmitMul())
+                return false;
+        }
+        return true;
+    }
+
+    bool Primary() {
+        if (Accept("[")) {
+            return Select() && Expect("]", "expected ']'") && EmitDeref();
+        }
+        if (Accept("(")) {
+            return Select() && Expect(")", "expected ')'");
+        }
+        auto word = NextWord();
+        if (word == "module")
+            return Emit(Op::Module, 1);
+        if (word == "i") {
+            if (!InLoop)
+                return Fail("'i' can only be used inside first()", word);
+            return Emit(Op::Index, 1);
+        }
+        if (word == "first")
+            return First(word);
+        if (word == "in")
+            return In();
+
+        DWORD value;
+        if (!Constant(word, value))
+            return false;
+        if (value <= OperandMax)
+            return Emit(Op::Const, 1, value);
+        return Emit(Op::ConstWide, 1) && EmitWord(value);
+    }
+
+    bool First(string_view word) {
+        if (HasLoop)
+            return Fail("only one first() is supported", word);
+        HasLoop = true;
+        if (!Expect("(", "expected '('") || !Select() || !Expect(",", "expected ','"))
+            return false;
+        auto loopBegin = Path.Length;
+        if (!Emit(Op::LoopBegin, -1))
+            return false;
+        InLoop = true;
+        if (!Select() || !Expect(")", "expected ')'"))
+            return false;
+        InLoop = false;
+        Patch(loopBegin, Path.Length);
+        if (!Emit(Op::LoopNext, -1))
+            return false;
+        JumpTarget = Path.Length;
+        // LoopNext pushes the found result again when the loop ends
+        Depth++;
+        return true;
+    }
+
+    bool In() {
+        if (!Expect("(", "expected '('") || !Select())
+            return false;
+        auto in = Path.Length;
+        if (!Emit(Op::In, 0))
+            return false;
+        DWORD count = 0;
+        while (Accept(",")) {
+            DWORD value;
+            if (!Constant(NextWord(), value) || !EmitWord(value))
+                return false;
+            count++;
+        }
+        if (count == 0)
+            return Fail("expected ','");
+        Patch(in, count);
+        return Expect(")", "expected ')'");
+    }
+};
+
+// Game memory of this process, read directly once the address is known to be readable.
+struct ProcessMemory {
+    DWORD ModuleBase() {
+        return DWORD(g_targetModule);
+    }
+    bool ReadDword(DWORD address, DWORD& value) {
+        return memory::TryReadDword(address, value);
+    }
+};
+
+namespace common::pointerpath {
+    // the index first() found last time in this process, a player object rarely moves in its pool
+    DWORD processLastHitIndex = NoHit;
+
+    tuple<const char*, string_view> Compile(string_view source, PointerPath& path) {
+        // the index was found by another path
+        ResetLastHit();
+        path = {};
+        Compiler compiler{ .Source = source, .Path = path, .LastInstruction = -1, .PreviousInstruction = -1 };
+        auto succeeded = compiler.Select();
+        compiler.SkipSpaces();
+        if (succeeded && compiler.Position < source.size())
+            succeeded = compiler.Fail("unexpected character");
+        if (!succeeded) {
+            path = {};
+            return { compiler.ErrorMessage, compiler.ErrorLocation };
+        }
+        return { nullptr, {} };
+    }
+
+    template <typename Memory>
+    DWORD Execute(const PointerPath& path, Memory& memory, DWORD& lastHitIndex) {
+        // locals, so the compiler can keep them in registers
+        auto code = path.Code;
+        auto length = path.Length;
+        DWORD stack[StackMaxDepth];
+        auto sp = 0;
+        auto pc = 0;
+        // the enclosing first(), loopCount is 0 outside of it
+        DWORD loopCount = 0;
+        DWORD loopIndex = 0;
+        auto loopBody = 0;
+        auto loopNext = 0;
+        auto loopStackBase = 0;
+        auto loopRetrying = false;
+        DWORD address;
+        DWORD result;
+
+        while (pc < length) {
+            auto word = code[pc++];
+            auto operand = word >> 8;
+            switch (Op(word & 0xFF)) {
+                case Op::Const:
+                    stack[sp++] = operand;
+                    break;
+                case Op::ConstWide:
+                    stack[sp++] = code[pc++];
+                    break;
+                case Op::Module:
+                    stack[sp++] = memory.ModuleBase();
+                    break;
+                case Op::Index:
+                    stack[sp++] = loopIndex;
+                    break;
+                case Op::Add:
+                    sp--;
+                    stack[sp - 1] += stack[sp];
+                    break;
+                case Op::Sub:
+                    sp--;
+                    stack[sp - 1] -= stack[sp];
+                    break;
+                case Op::Mul:
+                    sp--;
+                    stack[sp - 1] *= stack[sp];
+                    break;
+                case Op::AddConst:
+                    stack[sp - 1] += operand;
+                    break;
+                case Op::ModuleOffset:
+                    stack[sp++] = memory.ModuleBase() + operand;
+                    break;
+                case Op::AddIndex:
+                    stack[sp - 1] += loopIndex * operand;
+                    break;
+                case Op::MulConst:
+                    stack[sp - 1] *= operand;
+                    break;
+                case Op::Deref:
+                    address = stack[sp - 1];
+                    goto Load;
+                case Op::DerefOffset:
+                    address = stack[sp - 1] + operand;
+                    goto Load;
+                case Op::DerefIndex:
+                    address = stack[sp - 1] + loopIndex * operand;
+                    goto Load;
+                case Op::LoadModuleOffset:
+                    address = memory.ModuleBase() + operand;
+                    sp++;
+                Load:
+                    if (memory.ReadDword(address, stack[sp - 1]) && stack[sp - 1] != 0)
+                        break;
+                    // a null or unreadable pointer fails the current iteration, or the whole expression
+                    if (loopCount == 0)
+                        return 0;
+                    sp = loopStackBase;
+                    result = 0;
+                    goto EndIteration;
+                case Op::Equal:
+                    sp--;
+                    stack[sp - 1] = stack[sp - 1] == stack[sp];
+                    break;
+                case Op::NotEqual:
+                    sp--;
+                    stack[sp - 1] = stack[sp - 1] != stack[sp];
+                    break;
+                case Op::Less:
+                    sp--;
+                    stack[sp - 1] = stack[sp - 1] < stack[sp];
+                    break;
+                case Op::In: {
+                    auto value = stack[sp - 1];
+                    auto found = false;
+                    for (DWORD i = 0; i < operand; i++)
+                        found |= code[pc + i] == value;
+                    stack[sp - 1] = found;
+                    pc += operand;
+                    break;
+                }
+                case Op::JumpIfZero:
+                    if (stack[--sp] == 0)
+                        pc = operand;
+                    break;
+                case Op::Jump:
+                    pc = operand;
+                    break;
+                case Op::LoopBegin: {
+                    auto count = stack[--sp];
+                    if (count > LoopMaxCount)
+                        count = LoopMaxCount;
+                    if (count == 0) {
+                        stack[sp++] = 0;
+                        pc = operand + 1;
+                        break;
+                    }
+                    // try the last found index first, then scan from the start
+                    loopRetrying = lastHitIndex != 0 && lastHitIndex < count;
+                    loopIndex = loopRetrying ? lastHitIndex : 0;
+                    loopCount = count;
+                    loopBody = pc;
+                    loopNext = operand;
+                    loopStackBase = sp;
+                    break;
+                }
+                case Op::LoopNext:
+                    result = stack[--sp];
+                    goto EndIteration;
+            }
+            continue;
+
+        EndIteration:
+            // move on to the next index, or leave the loop with the result
+            if (result == 0) {
+                if (loopRetrying) {
+                    loopRetrying = false;
+                    loopIndex = 0;
+                }
+                else
+                    loopIndex++;
+                if (loopIndex < loopCount) {
+                    pc = loopBody;
+                    continue;
+                }
+                lastHitIndex = NoHit;
+            }
+            else
+                lastHitIndex = loopIndex;
+            stack[sp++] = result;
+            pc = loopNext + 1;
+            loopCount = 0;
+        }
+        return sp > 0 ? stack[sp - 1] : 0;
+    }
+
+    DWORD Run(const PointerPath& path) {
+        ProcessMemory memory;
+        return Execute(path, memory, processLastHitIndex);
+    }
+
+    void ResetLastHit() {
+        processLastHitIndex = NoHit;
+    }
+}
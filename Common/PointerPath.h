@@ -0,0 +1,28 @@
+#pragma once
+#include "framework.h"
+#include <tuple>
+#include <string_view>
+#include "DataTypes.h"
+
+/*
+Pointer path expressions, for games whose player object can't be reached with a fixed pointer chain.
+Numbers are hexadecimal, like the offsets of a pointer chain.
+- module                the base address of the game module
+- [x]                   read the DWORD at x; reading 0 means a null pointer, see first()
+- x + y, x - y, x * y
+- x == y, x != y, x < y 1 if true, 0 if false
+- c ? x : y             x if c is not 0, y otherwise
+- in(x, a, b, ...)      1 if x equals one of the constants a, b, ..., 0 otherwise
+- first(n, x)           evaluate x with i = 0 .. n - 1, and give the first result that is not 0.
+                        A null pointer read inside x skips to the next i, and the index found last time is tried first.
+                        Only one first() is allowed, and it can't be nested.
+- i                     the index of the enclosing first()
+A null pointer read outside of first() makes the whole expression give 0.
+*/
+namespace common::pointerpath {
+    // Compile an expression, returns an error message and the part of the source it points at on failure.
+    std::tuple<const char*, std::string_view> Compile(std::string_view source, PointerPath& path);
+    DWORD Run(const PointerPath& path);
+    // Forget the first() index found by Run in this process, call it when the path of the process is replaced.
+    void ResetLastHit();
+}
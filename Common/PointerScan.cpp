@@ -0,0 +1,369 @@
+#include "framework.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <format>
+
+#include "macro.h"
+#include "DataTypes.h"
+#include "Helper.Memory.h"
+#include "PointerScan.h"
+
+namespace memory = common::helper::memory;
+namespace memoryview = common::memoryview;
+namespace pointerscan = common::pointerscan;
+
+using namespace std;
+
+/*
+Candidate file layout:
+- CandidateHeader
+- AddressChain records, up to the end of the file
+*/
+constexpr DWORD CandidateMagic = 'GXMC';
+constexpr DWORD CandidateVersion = 1;
+// chains are written and read this many at a time
+constexpr auto CandidateBatchSize = 4096;
+// the snapshot is searched for pointers in pieces of this size, so the threads share the work evenly
+constexpr DWORD PointerChunkSize = 0x100000;
+
+struct CandidateHeader {
+    DWORD   Magic;
+    DWORD   Version;
+};
+
+// A DWORD of the snapshot holding an address inside the snapshot.
+struct PointerEntry {
+    DWORD   Value;
+    DWORD   Location;
+};
+
+struct ScanTask {
+    // where the next pointer has to lead to, minus at most MaxOffset
+    DWORD   Address;
+    // how many pointers the chain follows so far
+    int     Depth;
+    // the offsets after each of those pointers, Offsets[0] is the last one of the chain
+    DWORD   Offsets[ADDRESS_CHAIN_MAX_LEN];
+};
+
+struct WorkQueue {
+    mutex           Lock;
+    deque<ScanTask> Tasks;
+};
+
+struct CandidateWriter {
+    Handle          File;
+    mutex           Lock;
+    atomic<bool>    Failed;
+
+    bool Open(const WCHAR* path) {
+        File.reset(CreateFileW(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL));
+        if (File.get() == INVALID_HANDLE_VALUE)
+            return false;
+        CandidateHeader header{ .Magic = CandidateMagic, .Version = CandidateVersion };
+        return Write(&header, sizeof(header));
+    }
+
+    bool Write(const void* data, DWORD size) {
+        DWORD written;
+        return WriteFile(File.get(), data, size, &written, NULL) != FALSE && written == size;
+    }
+
+    // Write the chains and empty the vector, can be called from any thread.
+    void Append(vector<AddressChain>& chains) {
+        if (chains.empty())
+            return;
+        lock_guard lock(Lock);
+        if (!Failed && !Write(chains.data(), DWORD(chains.size() * sizeof(AddressChain))))
+            Failed = true;
+        chains.clear();
+    }
+};
+
+// Reads a candidate file one batch at a time.
+struct CandidateReader {
+    Handle File;
+
+    bool Open(const WCHAR* path) {
+        File.reset(CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL));
+        if (File.get() == INVALID_HANDLE_VALUE)
+            return false;
+        CandidateHeader header{};
+        DWORD read;
+        if (ReadFile(File.get(), &header, sizeof(header), &read, NULL) == FALSE)
+            return false;
+        if (read != sizeof(header) || header.Magic != CandidateMagic || header.Version != CandidateVersion) {
+            SetLastError(ERROR_BAD_FORMAT);
+            return false;
+        }
+        return true;
+    }
+
+    // Replace the content of the vector with the next batch, false on a read error. An empty batch means the end.
+    bool Next(vector<AddressChain>& chains) {
+        chains.resize(CandidateBatchSize);
+        DWORD read;
+        if (ReadFile(File.get(), chains.data(), DWORD(chains.size() * sizeof(AddressChain)), &read, NULL) == FALSE)
+            return false;
+        chains.resize(read / sizeof(AddressChain));
+        return true;
+    }
+};
+
+int GetThreadCount(const pointerscan::ScanOptions& options) {
+    if (options.ThreadCount > 0)
+        return options.ThreadCount;
+    auto processorCount = int(thread::hardware_concurrency());
+    return processorCount > 0 ? processorCount : 1;
+}
+
+void RunThreads(int threadCount, const function<void(int)>& work) {
+    vector<thread> threads;
+    for (auto i = 1; i < threadCount; i++)
+        threads.emplace_back(work, i);
+    work(0);
+    for (auto& thread : threads)
+        thread.join();
+}
+
+bool IsInRegions(const vector<memoryview::MemoryRegion>& regions, DWORD address) {
+    auto region = upper_bound(regions.begin(), regions.end(), address, [](DWORD address, const memoryview::MemoryRegion& region) {
+        return address < region.BaseAddress;
+    });
+    if (region == regions.begin())
+        return false;
+    region--;
+    return address - region->BaseAddress < region->Size;
+}
+
+// Every aligned DWORD of the snapshot that points into the snapshot, sorted by the address it points to.
+vector<PointerEntry> CollectPointers(const vector<memoryview::MemoryRegion>& regions, int threadCount) {
+    struct Chunk {
+        const memoryview::MemoryRegion* Region;
+        DWORD                           Offset;
+        DWORD                           Size;
+    };
+    vector<Chunk> chunks;
+    for (auto& region : regions) {
+        for (DWORD offset = 0; offset < region.Size; offset += PointerChunkSize)
+            chunks.push_back({ &region, offset, region.Size - offset < PointerChunkSize ? region.Size - offset : PointerChunkSize });
+    }
+    auto lowest = regions.front().BaseAddress;
+    auto highest = regions.back().BaseAddress + regions.back().Size;
+
+    vector<vector<PointerEntry>> threadPointers(threadCount);
+    atomic<size_t> nextChunk = 0;
+    RunThreads(threadCount, [&](int threadIdx) {
+        auto& pointers = threadPointers[threadIdx];
+        for (auto chunkIdx = nextChunk++; chunkIdx < chunks.size(); chunkIdx = nextChunk++) {
+            auto& chunk = chunks[chunkIdx];
+            auto values = (const DWORD*)(chunk.Region->Data + chunk.Offset);
+            auto location = chunk.Region->BaseAddress + chunk.Offset;
+            for (DWORD i = 0; i < chunk.Size / sizeof(DWORD); i++, location += sizeof(DWORD)) {
+                auto value = values[i];
+                if (value >= lowest && value < highest && IsInRegions(regions, value))
+                    pointers.push_back({ value, location });
+            }
+        }
+        sort(pointers.begin(), pointers.end(), [](const PointerEntry& left, const PointerEntry& right) {
+            return left.Value < right.Value;
+        });
+    });
+
+    vector<PointerEntry> pointers;
+    size_t pointerCount = 0;
+    for (auto& part : threadPointers)
+        pointerCount += part.size();
+    pointers.reserve(pointerCount);
+    for (auto& part : threadPointers) {
+        auto middle = pointers.size();
+        pointers.insert(pointers.end(), part.begin(), part.end());
+        vector<PointerEntry>().swap(part);
+        inplace_merge(pointers.begin(), pointers.begin() + middle, pointers.end(), [](const PointerEntry& left, const PointerEntry& right) {
+            return left.Value < right.Value;
+        });
+    }
+    return pointers;
+}
+
+/*
+Depth-first search from the target address backwards, one task per address a pointer has to lead to.
+Each thread takes the newest task of its own queue, and when that runs out, steals the oldest task of another queue,
+which tends to be the root of a big unexplored subtree.
+*/
+struct PointerSearch {
+    const vector<PointerEntry>&     Pointers;
+    DWORD                           ModuleBase;
+    DWORD                           ModuleEnd;
+    pointerscan::ScanOptions        Options;
+    CandidateWriter&                Writer;
+    unique_ptr<WorkQueue[]>         Queues;
+    int                             QueueCount;
+    // tasks queued or being worked on, the search is over when it drops to 0
+    atomic<DWORD>                   PendingTaskCount;
+    atomic<DWORD>                   ChainCount;
+
+    void Push(int queueIdx, const ScanTask& task) {
+        PendingTaskCount++;
+        auto& queue = Queues[queueIdx];
+        lock_guard lock(queue.Lock);
+        queue.Tasks.push_back(task);
+    }
+
+    bool Pop(int queueIdx, ScanTask& task) {
+        for (auto i = 0; i < QueueCount; i++) {
+            auto& queue = Queues[(queueIdx + i) % QueueCount];
+            lock_guard lock(queue.Lock);
+            if (queue.Tasks.empty())
+                continue;
+            if (i == 0) {
+                task = queue.Tasks.back();
+                queue.Tasks.pop_back();
+            }
+            else {
+                task = queue.Tasks.front();
+                queue.Tasks.pop_front();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    bool IsFinished() {
+        return PendingTaskCount == 0 || ChainCount >= Options.MaxChainCount || Writer.Failed;
+    }
+
+    void Expand(int queueIdx, const ScanTask& task, vector<AddressChain>& chains) {
+        auto lowestValue = task.Address > Options.MaxOffset ? task.Address - Options.MaxOffset : 0;
+        auto pointer = lower_bound(Pointers.begin(), Pointers.end(), lowestValue, [](const PointerEntry& pointer, DWORD value) {
+            return pointer.Value < value;
+        });
+        for (; pointer != Pointers.end() && pointer->Value <= task.Address; ++pointer) {
+            auto offset = task.Address - pointer->Value;
+            if (pointer->Location >= ModuleBase && pointer->Location < ModuleEnd) {
+                AddressChain chain{ .Length = task.Depth + 2 };
+                chain.Level[0] = pointer->Location - ModuleBase;
+                chain.Level[1] = offset;
+                for (auto i = 0; i < task.Depth; i++)
+                    chain.Level[2 + i] = task.Offsets[task.Depth - 1 - i];
+                chains.push_back(chain);
+                ChainCount++;
+            }
+            else if (task.Depth + 1 < Options.MaxDepth) {
+                auto next = task;
+                next.Address = pointer->Location;
+                next.Offsets[next.Depth++] = offset;
+                Push(queueIdx, next);
+            }
+        }
+    }
+
+    void Work(int queueIdx) {
+        vector<AddressChain> chains;
+        ScanTask task;
+        while (!IsFinished()) {
+            if (!Pop(queueIdx, task)) {
+                this_thread::yield();
+                continue;
+            }
+            Expand(queueIdx, task, chains);
+            if (chains.size() >= CandidateBatchSize)
+                Writer.Append(chains);
+            PendingTaskCount--;
+        }
+        Writer.Append(chains);
+    }
+};
+
+namespace common::pointerscan {
+    bool Scan(memoryview::MemoryView& snapshot, DWORD targetAddress, const ScanOptions& options, const WCHAR* candidatePath, DWORD& chainCount) {
+        chainCount = 0;
+        auto regions = snapshot.ListRegions();
+        if (regions.empty()) {
+            SetLastError(ERROR_NOT_SUPPORTED);
+            return false;
+        }
+        CandidateWriter writer;
+        if (!writer.Open(candidatePath))
+            return false;
+
+        // the target itself can be in the module, then the chain is just its RVA
+        auto moduleEnd = snapshot.ModuleBase + snapshot.ModuleSize;
+        if (targetAddress >= snapshot.ModuleBase && targetAddress < moduleEnd) {
+            vector<AddressChain> chains{ { .Length = 1, .Level = { targetAddress - snapshot.ModuleBase } } };
+            writer.Append(chains);
+            chainCount++;
+        }
+
+        auto threadCount = GetThreadCount(options);
+        auto pointers = CollectPointers(regions, threadCount);
+        PointerSearch search{
+            .Pointers = pointers,
+            .ModuleBase = snapshot.ModuleBase,
+            .ModuleEnd = moduleEnd,
+            .Options = options,
+            .Writer = writer,
+            .Queues = make_unique<WorkQueue[]>(threadCount),
+            .QueueCount = threadCount,
+        };
+        if (search.Options.MaxDepth > ADDRESS_CHAIN_MAX_LEN - 1)
+            search.Options.MaxDepth = ADDRESS_CHAIN_MAX_LEN - 1;
+        search.Push(0, { .Address = targetAddress });
+        RunThreads(threadCount, [&](int threadIdx) { search.Work(threadIdx); });
+
+        chainCount += search.ChainCount;
+        return !writer.Failed;
+    }
+
+    bool Filter(const WCHAR* candidatePath, memoryview::MemoryView& snapshot, DWORD targetAddress, const WCHAR* outputPath, DWORD& chainCount) {
+        chainCount = 0;
+        CandidateReader reader;
+        CandidateWriter writer;
+        if (!reader.Open(candidatePath) || !writer.Open(outputPath))
+            return false;
+        vector<AddressChain> chains;
+        vector<AddressChain> kept;
+        while (true) {
+            if (!reader.Next(chains))
+                return false;
+            if (chains.empty())
+                return true;
+            for (auto& chain : chains) {
+                if (memory::ResolveAddress(snapshot, chain.Level, chain.Length) == targetAddress)
+                    kept.push_back(chain);
+            }
+            chainCount += DWORD(kept.size());
+            writer.Append(kept);
+            if (writer.Failed)
+                return false;
+        }
+    }
+
+    bool ReadCandidates(const WCHAR* candidatePath, vector<AddressChain>& chains) {
+        chains.clear();
+        CandidateReader reader;
+        if (!reader.Open(candidatePath))
+            return false;
+        vector<AddressChain> batch;
+        while (reader.Next(batch)) {
+            if (batch.empty())
+                return true;
+            chains.insert(chains.end(), batch.begin(), batch.end());
+        }
+        return false;
+    }
+
+    string FormatChain(const AddressChain& chain) {
+        string rs;
+        for (auto i = 0; i < chain.Length; i++)
+            rs += i == 0 ? format("[{:08X}]", chain.Level[i]) : format("[{:X}]", chain.Level[i]);
+        return rs;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "framework.h"
+#include <string>
+#include <vector>
+#include "DataTypes.h"
+#include "MemoryView.h"
+
+/*
+Pointer scan: find the pointer chains that lead from the game module to a known address, like the positionRVA of Games.txt.
+One snapshot gives lots of chains that only work by chance. Filtering them with snapshots taken after restarting
+the game keeps the ones that always lead to the address. Candidates are kept in a file, a scan can find millions of them.
+*/
+namespace common::pointerscan {
+    struct ScanOptions {
+        // how many pointers a chain may follow, at most ADDRESS_CHAIN_MAX_LEN - 1
+        int     MaxDepth;
+        // the largest offset added to a pointer
+        DWORD   MaxOffset;
+        // the scan stops once it has found this many chains
+        DWORD   MaxChainCount;
+        // 0 for one thread per processor
+        int     ThreadCount;
+    };
+
+    // Write the chains from the module of the snapshot to targetAddress into a new candidate file.
+    bool Scan(memoryview::MemoryView& snapshot, DWORD targetAddress, const ScanOptions& options, const WCHAR* candidatePath, DWORD& chainCount);
+    // Copy the candidates that lead to targetAddress in the snapshot too into a new candidate file.
+    bool Filter(const WCHAR* candidatePath, memoryview::MemoryView& snapshot, DWORD targetAddress, const WCHAR* outputPath, DWORD& chainCount);
+    bool ReadCandidates(const WCHAR* candidatePath, std::vector<AddressChain>& chains);
+    // as written in the positionRVA of Games.txt
+    std::string FormatChain(const AddressChain& chain);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "framework.h"
+#include <atomic>
+#include <type_traits>
+
+// Sequence lock for data shared across processes: the sequence is odd while a write is in progress,
+// so a reader retries until it copies the data between two equal, even reads of the sequence.
+namespace common::seqlock {
+    // Copy with relaxed atomic loads and stores: the reader can copy while the writer writes, which the sequence check
+    // catches afterwards, and with atomics that isn't a data race. A word at a time when T divides into words.
+    template <typename T>
+    void CopyRelaxed(T& destination, const T& source) {
+        using Word = std::conditional_t<sizeof(T) % sizeof(DWORD) == 0 && alignof(T) >= alignof(DWORD), DWORD, BYTE>;
+        auto to = (Word*)&destination;
+        auto from = (Word*)&source;
+        for (size_t i = 0; i < sizeof(T) / sizeof(Word); i++)
+            std::atomic_ref(to[i]).store(std::atomic_ref(from[i]).load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    // The caller must make sure there is only one writer at a time.
+    template <typename T>
+    void Write(DWORD& sequence, T& shared, const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        std::atomic_ref seq(sequence);
+        auto start = seq.load(std::memory_order_relaxed);
+        seq.store(start + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        CopyRelaxed(shared, value);
+        seq.store(start + 2, std::memory_order_release);
+    }
+
+    // Whether the data changed since the given sequence, a single atomic load.
+    inline bool HasChanged(DWORD& sequence, DWORD lastSequence) {
+        return std::atomic_ref(sequence).load(std::memory_order_acquire) != lastSequence;
+    }
+
+    // Copy a consistent snapshot of the shared data without taking any lock.
+    // Gives up after a while, so a writer that died mid-write can't hang the reader.
+    template <typename T>
+    bool Read(DWORD& sequence, const T& shared, T& output, DWORD& outputSequence) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        std::atomic_ref seq(sequence);
+        for (auto attempt = 0; attempt < 1000; attempt++) {
+            auto start = seq.load(std::memory_order_acquire);
+            if (start % 2 == 0) {
+                CopyRelaxed(output, shared);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq.load(std::memory_order_relaxed) == start) {
+                    outputSequence = start;
+                    return true;
+                }
+            }
+            YieldProcessor();
+        }
+        return false;
+    }
+}
@@ -0,0 +1,204 @@
+#include "framework.h"
+#include <tuple>
+#include <string_view>
+#include <bit>
+#include <emmintrin.h>
+#include <immintrin.h>
+
+#include "Helper.h"
+#include "Helper.Memory.h"
+#include "Signature.h"
+
+namespace helper = common::helper;
+namespace memory = common::helper::memory;
+
+using namespace std;
+
+#ifndef PF_AVX2_INSTRUCTIONS_AVAILABLE
+#define PF_AVX2_INSTRUCTIONS_AVAILABLE 40
+#endif
+
+// Value of a hexadecimal digit, -1 if it isn't one.
+int HexDigitValue(char c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+bool Matches(const Signature& signature, const BYTE* position) {
+    for (auto i = 0; i < signature.Length; i++) {
+        if (((position[i] ^ signature.Bytes[i]) & signature.Mask[i]) != 0)
+            return false;
+    }
+    return true;
+}
+
+const BYTE* FindScalar(const Signature& signature, const BYTE* position, const BYTE* last) {
+    for (; position <= last; position++) {
+        if (Matches(signature, position))
+            return position;
+    }
+    return nullptr;
+}
+
+/*
+The vector scans compare the first and the last byte without wildcards at 32 or 64 positions per iteration,
+and only check the whole pattern where both of them match. position + anchor + bytes per iteration never goes
+past the end, because anchor < signature.Length and the vector loops stop at last.
+*/
+unsigned CompareAnchorsSse2(const BYTE* position, int firstAnchor, int lastAnchor, __m128i firstByte, __m128i lastByte) {
+    auto firstEqual = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(position + firstAnchor)), firstByte);
+    auto lastEqual = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(position + lastAnchor)), lastByte);
+    return unsigned(_mm_movemask_epi8(_mm_and_si128(firstEqual, lastEqual)));
+}
+
+unsigned CompareAnchorsAvx2(const BYTE* position, int firstAnchor, int lastAnchor, __m256i firstByte, __m256i lastByte) {
+    auto firstEqual = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(position + firstAnchor)), firstByte);
+    auto lastEqual = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(position + lastAnchor)), lastByte);
+    return unsigned(_mm256_movemask_epi8(_mm256_and_si256(firstEqual, lastEqual)));
+}
+
+// Candidates are the set bits of a match mask, bit n for position + n.
+const BYTE* CheckCandidates(const Signature& signature, const BYTE* position, ULONGLONG candidates) {
+    for (; candidates != 0; candidates &= candidates - 1) {
+        auto candidate = position + countr_zero(candidates);
+        if (Matches(signature, candidate))
+            return candidate;
+    }
+    return nullptr;
+}
+
+const BYTE* FindSse2(const Signature& signature, int firstAnchor, int lastAnchor, const BYTE* position, const BYTE* last) {
+    auto firstByte = _mm_set1_epi8(char(signature.Bytes[firstAnchor]));
+    auto lastByte = _mm_set1_epi8(char(signature.Bytes[lastAnchor]));
+    for (; last - position >= 31; position += 32) {
+        auto low = CompareAnchorsSse2(position, firstAnchor, lastAnchor, firstByte, lastByte);
+        auto high = CompareAnchorsSse2(position + 16, firstAnchor, lastAnchor, firstByte, lastByte);
+        if ((low | high) == 0)
+            continue;
+        if (auto match = CheckCandidates(signature, position, low | high << 16))
+            return match;
+    }
+    return FindScalar(signature, position, last);
+}
+
+const BYTE* FindAvx2(const Signature& signature, int firstAnchor, int lastAnchor, const BYTE* position, const BYTE* last) {
+    auto firstByte = _mm256_set1_epi8(char(signature.Bytes[firstAnchor]));
+    auto lastByte = _mm256_set1_epi8(char(signature.Bytes[lastAnchor]));
+    for (; last - position >= 63; position += 64) {
+        auto low = CompareAnchorsAvx2(position, firstAnchor, lastAnchor, firstByte, lastByte);
+        auto high = CompareAnchorsAvx2(position + 32, firstAnchor, lastAnchor, firstByte, lastByte);
+        if ((low | high) == 0)
+            continue;
+        if (auto match = CheckCandidates(signature, position, low | ULONGLONG(high) << 32))
+            return match;
+    }
+    _mm256_zeroupper();
+    return FindSse2(signature, firstAnchor, lastAnchor, position, last);
+}
+
+namespace common::signature {
+    tuple<const char*, string_view> Parse(string_view source, Signature& signature) {
+        signature = {};
+        auto plusIdx = source.rfind('+');
+        auto pattern = source.substr(0, plusIdx);
+        if (plusIdx != string_view::npos) {
+            auto offsetStr = source.substr(plusIdx + 1);
+            auto [offset, message] = helper::ConvertToULong(offsetStr, 16);
+            if (message != nullptr)
+                return { message, offsetStr };
+            signature.Offset = offset;
+        }
+
+        auto nibbleCount = 0;
+        for (size_t i = 0; i < pattern.size(); i++) {
+            auto c = pattern[i];
+            if (c == ' ') {
+                if (nibbleCount % 2 != 0)
+                    return { "expected the second digit of the byte", pattern.substr(i, 1) };
+                continue;
+            }
+            if (nibbleCount / 2 >= SIGNATURE_MAX_LEN)
+                return { "too many bytes, at most 32 are allowed", pattern.substr(i) };
+            BYTE value = 0, mask = 0;
+            if (c != '?') {
+                auto digit = HexDigitValue(c);
+                if (digit < 0)
+                    return { "expected a hexadecimal digit or ?", pattern.substr(i, 1) };
+                value = BYTE(digit);
+                mask = 0xF;
+            }
+            auto shift = nibbleCount % 2 == 0 ? 4 : 0;
+            signature.Bytes[nibbleCount / 2] |= value << shift;
+            signature.Mask[nibbleCount / 2] |= mask << shift;
+            nibbleCount++;
+        }
+        if (nibbleCount % 2 != 0)
+            return { "expected the second digit of the byte", pattern.substr(pattern.size() - 1) };
+        signature.Length = nibbleCount / 2;
+        if (signature.Length == 0)
+            return { "expected a byte pattern", pattern };
+        for (auto i = 0; i < signature.Length; i++) {
+            if (signature.Mask[i] == 0xFF)
+                return { nullptr, {} };
+        }
+        return { "needs at least one byte without wildcards", pattern };
+    }
+
+    const BYTE* Find(const Signature& signature, const BYTE* begin, const BYTE* end) {
+        static const auto hasAvx2 = IsProcessorFeaturePresent(PF_AVX2_INSTRUCTIONS_AVAILABLE) != FALSE;
+        if (signature.Length <= 0 || end - begin < signature.Length)
+            return nullptr;
+        auto firstAnchor = -1, lastAnchor = -1;
+        for (auto i = 0; i < signature.Length; i++) {
+            if (signature.Mask[i] != 0xFF)
+                continue;
+            if (firstAnchor < 0)
+                firstAnchor = i;
+            lastAnchor = i;
+        }
+        auto last = end - signature.Length;
+        if (firstAnchor < 0)
+            return FindScalar(signature, begin, last);
+        if (hasAvx2)
+            return FindAvx2(signature, firstAnchor, lastAnchor, begin, last);
+        return FindSse2(signature, firstAnchor, lastAnchor, begin, last);
+    }
+
+    DWORD Resolve(const Signature& signature, HMODULE module) {
+        auto base = (const BYTE*)module;
+        auto dosHeader = (PIMAGE_DOS_HEADER)module;
+        auto ntHeaders = (PIMAGE_NT_HEADERS)(base + dosHeader->e_lfanew);
+        auto section = IMAGE_FIRST_SECTION(ntHeaders);
+        for (WORD i = 0; i < ntHeaders->FileHeader.NumberOfSections; i++, section++) {
+            if ((section->Characteristics & IMAGE_SCN_MEM_READ) == 0)
+                continue;
+            auto begin = base + section->VirtualAddress;
+            auto size = section->Misc.VirtualSize;
+            if (!memory::IsReadable(DWORD(begin), size))
+                continue;
+            auto match = Find(signature, begin, begin + size);
+            if (match == nullptr)
+                continue;
+            DWORD address;
+            if (!memory::TryReadDword(DWORD(match) + signature.Offset, address))
+                return NULL;
+            return address - DWORD(module);
+        }
+        return NULL;
+    }
+
+    bool ApplyTo(GameConfig& gameConfig, HMODULE module) {
+        if (gameConfig.Signature.Length <= 0)
+            return true;
+        gameConfig.Address.Level[0] = Resolve(gameConfig.Signature, module);
+        if (gameConfig.Address.Level[0] != NULL)
+            return true;
+        gameConfig.Address.Length = 0;
+        return false;
+    }
+}
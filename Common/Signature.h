@@ -0,0 +1,25 @@
+#pragma once
+#include "framework.h"
+#include <tuple>
+#include <string_view>
+#include "DataTypes.h"
+
+/*
+Array of bytes signatures, to find an address in the game module instead of hardcoding it for each game version.
+A signature is written as "<pattern>+<offset>":
+- pattern   hexadecimal bytes, spaces between them are optional. ? matches any nibble, so ?? matches any byte.
+- offset    hexadecimal, where the DWORD holding the address is, counted from the start of the match.
+            Can be left out together with the +, then it's 0.
+E.g. "A1 ?? ?? ?? ?? 8B 48 04+1" finds the address read by a "mov eax, [address]" followed by "mov ecx, [eax+4]".
+*/
+namespace common::signature {
+    // Parse a signature, returns an error message and the part of the source it points at on failure.
+    std::tuple<const char*, std::string_view> Parse(std::string_view source, Signature& signature);
+    // The first match in [begin, end), or nullptr.
+    const BYTE* Find(const Signature& signature, const BYTE* begin, const BYTE* end);
+    // Find the signature in the sections of the module and return the RVA of the address it holds, or 0.
+    DWORD Resolve(const Signature& signature, HMODULE module);
+    // Fill in the first offset of the pointer chain of the game config from its signature.
+    // When the signature isn't found the chain is emptied and false is returned.
+    bool ApplyTo(GameConfig& gameConfig, HMODULE module);
+}
@@ -0,0 +1,299 @@
+#include "framework.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <bit>
+#include <emmintrin.h>
+
+#include "DataTypes.h"
+#include "MemoryView.h"
+#include "ValueScan.h"
+
+namespace memoryview = common::memoryview;
+namespace valuescan = common::valuescan;
+
+using namespace std;
+using memoryview::MemoryRegion;
+using valuescan::Candidates;
+using valuescan::ValueFilter;
+
+constexpr DWORD ValuesPerWord = 64;
+
+/*
+SSE2 comparisons of a 16-byte vector of values, giving one bit per value.
+Keep at most 3 vectors as parameters, more can't be passed by value on x86.
+*/
+struct IntTraits {
+    using Value = int;
+    using Vector = __m128i;
+    static constexpr DWORD Lanes = 4;
+    static Vector Load(const BYTE* data) { return _mm_loadu_si128((const __m128i*)data); }
+    static Vector Set(Value value) { return _mm_set1_epi32(value); }
+    static Vector Equal(Vector left, Vector right) { return _mm_cmpeq_epi32(left, right); }
+    static Vector NotEqual(Vector left, Vector right) { return _mm_xor_si128(Equal(left, right), _mm_set1_epi32(-1)); }
+    static Vector Greater(Vector left, Vector right) { return _mm_cmpgt_epi32(left, right); }
+    static Vector InRange(Vector value, Vector minimum, Vector maximum) {
+        return _mm_xor_si128(_mm_or_si128(Greater(minimum, value), Greater(value, maximum)), _mm_set1_epi32(-1));
+    }
+    static DWORD Mask(Vector result) { return _mm_movemask_ps(_mm_castsi128_ps(result)); }
+};
+
+struct ShortTraits {
+    using Value = short;
+    using Vector = __m128i;
+    static constexpr DWORD Lanes = 8;
+    static Vector Load(const BYTE* data) { return _mm_loadu_si128((const __m128i*)data); }
+    static Vector Set(Value value) { return _mm_set1_epi16(value); }
+    static Vector Equal(Vector left, Vector right) { return _mm_cmpeq_epi16(left, right); }
+    static Vector NotEqual(Vector left, Vector right) { return _mm_xor_si128(Equal(left, right), _mm_set1_epi32(-1)); }
+    static Vector Greater(Vector left, Vector right) { return _mm_cmpgt_epi16(left, right); }
+    static Vector InRange(Vector value, Vector minimum, Vector maximum) {
+        return _mm_xor_si128(_mm_or_si128(Greater(minimum, value), Greater(value, maximum)), _mm_set1_epi32(-1));
+    }
+    // narrow the 16-bit results to bytes, a byte mask has one bit per byte
+    static DWORD Mask(Vector result) { return _mm_movemask_epi8(_mm_packs_epi16(result, _mm_setzero_si128())); }
+};
+
+struct FloatTraits {
+    using Value = float;
+    using Vector = __m128;
+    static constexpr DWORD Lanes = 4;
+    static Vector Load(const BYTE* data) { return _mm_loadu_ps((const float*)data); }
+    static Vector Set(Value value) { return _mm_set1_ps(value); }
+    static Vector Equal(Vector left, Vector right) { return _mm_cmpeq_ps(left, right); }
+    static Vector NotEqual(Vector left, Vector right) { return _mm_cmpneq_ps(left, right); }
+    static Vector Greater(Vector left, Vector right) { return _mm_cmpgt_ps(left, right); }
+    // ordered comparisons, NaN is never in range
+    static Vector InRange(Vector value, Vector minimum, Vector maximum) {
+        return _mm_and_ps(_mm_cmpge_ps(value, minimum), _mm_cmple_ps(value, maximum));
+    }
+    static DWORD Mask(Vector result) { return _mm_movemask_ps(result); }
+};
+
+struct DoubleTraits {
+    using Value = double;
+    using Vector = __m128d;
+    static constexpr DWORD Lanes = 2;
+    static Vector Load(const BYTE* data) { return _mm_loadu_pd((const double*)data); }
+    static Vector Set(Value value) { return _mm_set1_pd(value); }
+    static Vector Equal(Vector left, Vector right) { return _mm_cmpeq_pd(left, right); }
+    static Vector NotEqual(Vector left, Vector right) { return _mm_cmpneq_pd(left, right); }
+    static Vector Greater(Vector left, Vector right) { return _mm_cmpgt_pd(left, right); }
+    static Vector InRange(Vector value, Vector minimum, Vector maximum) {
+        return _mm_and_pd(_mm_cmpge_pd(value, minimum), _mm_cmple_pd(value, maximum));
+    }
+    static DWORD Mask(Vector result) { return _mm_movemask_pd(result); }
+};
+
+// Walks the regions of a snapshot, for addresses asked in increasing order.
+struct RegionCursor {
+    const vector<MemoryRegion>& Regions;
+    size_t                      Index;
+
+    // The bytes at [address, address + size), nullptr if they aren't all in one region.
+    const BYTE* Find(DWORD address, DWORD size) {
+        while (Index < Regions.size() && ULONGLONG(Regions[Index].BaseAddress) + Regions[Index].Size <= address)
+            Index++;
+        if (Index == Regions.size())
+            return nullptr;
+        auto& region = Regions[Index];
+        if (address < region.BaseAddress || ULONGLONG(address) + size > ULONGLONG(region.BaseAddress) + region.Size)
+            return nullptr;
+        return region.Data + (address - region.BaseAddress);
+    }
+};
+
+template <typename T>
+T LoadValue(const BYTE* data) {
+    T value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// The values of the inclusive range that a T can hold, false if there are none.
+template <typename T>
+bool ToBounds(double minimum, double maximum, T& lower, T& upper) {
+    if constexpr (is_integral_v<T>) {
+        auto first = ceil(minimum);
+        auto last = floor(maximum);
+        if (first > last || first > numeric_limits<T>::max() || last < numeric_limits<T>::min())
+            return false;
+        lower = first < numeric_limits<T>::min() ? numeric_limits<T>::min() : T(first);
+        upper = last > numeric_limits<T>::max() ? numeric_limits<T>::max() : T(last);
+        return true;
+    }
+    else {
+        lower = T(minimum);
+        upper = T(maximum);
+        return minimum <= maximum;
+    }
+}
+
+// The bits of 64 values in a row whose comparison passes.
+template <typename Traits, typename VectorMatch>
+ULONGLONG MatchWord(const BYTE* previous, const BYTE* current, const VectorMatch& vectorMatch) {
+    ULONGLONG bits = 0;
+    for (DWORD i = 0; i < ValuesPerWord / Traits::Lanes; i++) {
+        auto result = vectorMatch(Traits::Load(previous + i * 16), Traits::Load(current + i * 16));
+        bits |= ULONGLONG(Traits::Mask(result)) << (i * Traits::Lanes);
+    }
+    return bits;
+}
+
+template <typename Traits, typename VectorMatch, typename ValueMatch>
+void Filter(Candidates& candidates, const vector<MemoryRegion>& previousRegions, const vector<MemoryRegion>& currentRegions,
+    const VectorMatch& vectorMatch, const ValueMatch& valueMatch) {
+    using Value = typename Traits::Value;
+    constexpr auto valueSize = DWORD(sizeof(Value));
+    RegionCursor previous{ previousRegions, 0 };
+    RegionCursor current{ currentRegions, 0 };
+    for (auto& region : candidates.Regions) {
+        auto valueCount = region.Size / valueSize;
+        for (DWORD i = 0; i < valueCount; i += ValuesPerWord) {
+            auto& word = candidates.Bits[region.FirstWord + i / ValuesPerWord];
+            // most words are empty after the first filters, they cost nothing
+            if (word == 0)
+                continue;
+            auto bitCount = valueCount - i < ValuesPerWord ? valueCount - i : ValuesPerWord;
+            auto address = region.BaseAddress + i * valueSize;
+            auto previousData = previous.Find(address, bitCount * valueSize);
+            auto currentData = current.Find(address, bitCount * valueSize);
+            if (previousData == nullptr || currentData == nullptr) {
+                word = 0;
+                continue;
+            }
+            if (bitCount == ValuesPerWord) {
+                word &= MatchWord<Traits>(previousData, currentData, vectorMatch);
+                continue;
+            }
+            // the end of a region that isn't a multiple of 64 values, not worth vectorizing
+            for (DWORD bit = 0; bit < bitCount; bit++) {
+                auto offset = bit * valueSize;
+                if (!valueMatch(LoadValue<Value>(previousData + offset), LoadValue<Value>(currentData + offset)))
+                    word &= ~(1ULL << bit);
+            }
+        }
+    }
+}
+
+template <typename Traits>
+void ApplyTyped(Candidates& candidates, const vector<MemoryRegion>& previousRegions, const vector<MemoryRegion>& currentRegions,
+    ValueFilter filter, double minimum, double maximum) {
+    using Value = typename Traits::Value;
+    using Vector = typename Traits::Vector;
+    switch (filter) {
+        case ValueFilter::Changed:
+            Filter<Traits>(candidates, previousRegions, currentRegions,
+                [](Vector previous, Vector current) { return Traits::NotEqual(previous, current); },
+                [](Value previous, Value current) { return previous != current; });
+            break;
+        case ValueFilter::Unchanged:
+            Filter<Traits>(candidates, previousRegions, currentRegions,
+                [](Vector previous, Vector current) { return Traits::Equal(previous, current); },
+                [](Value previous, Value current) { return previous == current; });
+            break;
+        case ValueFilter::Increased:
+            Filter<Traits>(candidates, previousRegions, currentRegions,
+                [](Vector previous, Vector current) { return Traits::Greater(current, previous); },
+                [](Value previous, Value current) { return current > previous; });
+            break;
+        case ValueFilter::Decreased:
+            Filter<Traits>(candidates, previousRegions, currentRegions,
+                [](Vector previous, Vector current) { return Traits::Greater(previous, current); },
+                [](Value previous, Value current) { return current < previous; });
+            break;
+        case ValueFilter::InRange: {
+            Value lower, upper;
+            if (!ToBounds(minimum, maximum, lower, upper)) {
+                fill(candidates.Bits.begin(), candidates.Bits.end(), 0);
+                break;
+            }
+            auto lowerVector = Traits::Set(lower);
+            auto upperVector = Traits::Set(upper);
+            // only the current values matter, the previous snapshot isn't needed
+            Filter<Traits>(candidates, currentRegions, currentRegions,
+                [&](Vector, Vector current) { return Traits::InRange(current, lowerVector, upperVector); },
+                [&](Value, Value current) { return current >= lower && current <= upper; });
+            break;
+        }
+    }
+}
+
+namespace common::valuescan {
+    DWORD ValueSize(PointDataType type) {
+        switch (type) {
+            case PointDataType::Int: return sizeof(IntTraits::Value);
+            case PointDataType::Float: return sizeof(FloatTraits::Value);
+            case PointDataType::Short: return sizeof(ShortTraits::Value);
+            case PointDataType::Double: return sizeof(DoubleTraits::Value);
+            default: return 0;
+        }
+    }
+
+    Candidates Start(memoryview::MemoryView& snapshot, PointDataType type) {
+        Candidates candidates{ .Type = type };
+        auto valueSize = ValueSize(type);
+        if (valueSize == 0)
+            return candidates;
+        size_t wordCount = 0;
+        for (auto& region : snapshot.ListRegions()) {
+            candidates.Regions.push_back({ region.BaseAddress, region.Size, wordCount });
+            wordCount += (region.Size / valueSize + ValuesPerWord - 1) / ValuesPerWord;
+        }
+        candidates.Bits.assign(wordCount, ~0ULL);
+        // no candidates past the end of a region
+        for (auto& region : candidates.Regions) {
+            auto valueCount = region.Size / valueSize;
+            if (valueCount % ValuesPerWord != 0)
+                candidates.Bits[region.FirstWord + valueCount / ValuesPerWord] = (1ULL << (valueCount % ValuesPerWord)) - 1;
+        }
+        return candidates;
+    }
+
+    void Apply(Candidates& candidates, memoryview::MemoryView& previous, memoryview::MemoryView& current, ValueFilter filter, double minimum, double maximum) {
+        auto previousRegions = previous.ListRegions();
+        auto currentRegions = current.ListRegions();
+        switch (candidates.Type) {
+            case PointDataType::Int:
+                ApplyTyped<IntTraits>(candidates, previousRegions, currentRegions, filter, minimum, maximum);
+                break;
+            case PointDataType::Float:
+                ApplyTyped<FloatTraits>(candidates, previousRegions, currentRegions, filter, minimum, maximum);
+                break;
+            case PointDataType::Short:
+                ApplyTyped<ShortTraits>(candidates, previousRegions, currentRegions, filter, minimum, maximum);
+                break;
+            case PointDataType::Double:
+                ApplyTyped<DoubleTraits>(candidates, previousRegions, currentRegions, filter, minimum, maximum);
+                break;
+            default:
+                break;
+        }
+    }
+
+    DWORD Count(const Candidates& candidates) {
+        DWORD count = 0;
+        for (auto word : candidates.Bits)
+            count += popcount(word);
+        return count;
+    }
+
+    vector<DWORD> List(const Candidates& candidates, DWORD maxCount) {
+        vector<DWORD> addresses;
+        auto valueSize = ValueSize(candidates.Type);
+        for (auto& region : candidates.Regions) {
+            auto wordCount = (region.Size / valueSize + ValuesPerWord - 1) / ValuesPerWord;
+            for (DWORD i = 0; i < wordCount; i++) {
+                for (auto word = candidates.Bits[region.FirstWord + i]; word != 0; word &= word - 1) {
+                    if (addresses.size() >= maxCount)
+                        return addresses;
+                    auto index = i * ValuesPerWord + countr_zero(word);
+                    addresses.push_back(region.BaseAddress + index * valueSize);
+                }
+            }
+        }
+        return addresses;
+    }
+}
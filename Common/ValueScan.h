@@ -0,0 +1,44 @@
+#pragma once
+#include "framework.h"
+#include <vector>
+#include "DataTypes.h"
+#include "MemoryView.h"
+
+/*
+Value scan: find the variable holding the X of the player position when nothing points at it yet.
+Start from every aligned value of a snapshot, then drop the ones that don't change like the position did between
+two snapshots, e.g. "increased" after moving right, or aren't in the range the position can be in.
+Candidates are kept as one bit per aligned value, 1 GB of snapshot takes 32 MB of bits with 4-byte values.
+*/
+namespace common::valuescan {
+    enum class ValueFilter {
+        Changed, Unchanged, Increased, Decreased, InRange,
+    };
+
+    struct CandidateRegion {
+        DWORD   BaseAddress;
+        DWORD   Size;
+        // index of the word of Candidates::Bits that holds the first value of the region
+        size_t  FirstWord;
+    };
+
+    struct Candidates {
+        PointDataType                   Type;
+        // the regions of the first snapshot, sorted by address
+        std::vector<CandidateRegion>    Regions;
+        // bit i of a region is set while its i-th value is still a candidate
+        std::vector<ULONGLONG>          Bits;
+    };
+
+    // Size of a value of the type, values are aligned to it. 0 for PointDataType::None.
+    DWORD ValueSize(PointDataType type);
+    // Every aligned value of the snapshot, for a variable whose value isn't known yet.
+    Candidates Start(memoryview::MemoryView& snapshot, PointDataType type);
+    // Keep the candidates whose value went from previous to current like the filter says.
+    // InRange only looks at current, for values between minimum and maximum included.
+    // Values missing from either snapshot are dropped. Both views must be snapshots.
+    void Apply(Candidates& candidates, memoryview::MemoryView& previous, memoryview::MemoryView& current, ValueFilter filter, double minimum, double maximum);
+    DWORD Count(const Candidates& candidates);
+    // The addresses of the first maxCount candidates.
+    std::vector<DWORD> List(const Candidates& candidates, DWORD maxCount);
+}
@@ -15,30 +15,34 @@ bool        g_hookApplied;
 HMODULE     g_targetModule;
 HMODULE     g_coreModule;
 HWND        g_hFocusWindow;
-bool        g_isMinimized;
-bool        g_leftMousePressed;
-bool        g_midMousePressed;
-bool        g_inputEnabled;
+DWORD       g_hookState;
 float       g_pixelRate = 1;
 FloatPoint  g_pixelOffset{1, 1};
-bool        g_showImGui;
+DWORD       g_frameCount;
 // for debugging purpose, not single source of truth
 POINT       g_playerPos;
 DoublePoint g_playerPosRaw;
 GameInput   g_gameInput;
 
+SharedConfig    g_sharedConfig;
+DWORD           g_sharedConfigSequence;
+DWORD           g_keyBindings;
+
 // configuration from main exe
 #pragma data_seg(".SHRCONF")
-GameConfigs gs_gameConfigs{};
-BYTE        gs_bombButton = 0x58; // VK_X
-BYTE        gs_extraButton = 0x43; // VK_C
-DWORD       gs_toggleOsCursorButton = 0x4D; // VK_M
-DWORD       gs_toggleImGuiButton = 0xC0; // VK_BACK_QUOTE
-WCHAR       gs_textureFilePath[MAX_PATH]{};
-DWORD       gs_textureBaseHeight = 480;
-WCHAR       gs_imGuiFontPath[MAX_PATH]{};
-DWORD       gs_imGuiBaseFontSize = 20;
-DWORD       gs_imGuiBaseVerticalResolution = 960;
+DWORD           gs_sharedConfigSequence = 0;
+SharedConfig    gs_sharedConfig{
+    .BombButton = 0x58, // VK_X
+    .ExtraButton = 0x43, // VK_C
+    .ToggleOsCursorButton = 0x4D, // VK_M
+    .ToggleImGuiButton = 0xC0, // VK_BACK_QUOTE
+    .TextureBaseHeight = 480,
+    .ImGuiBaseFontSize = 20,
+    .ImGuiBaseVerticalResolution = 960,
+    .MovementMode = MovementMode::Classic,
+    .InputThreadRate = 0,
+};
+DWORD           gs_guiProcessId = 0;
 #pragma data_seg()
 // make the above segment shared across processes
 #pragma comment(linker, "/SECTION:.SHRCONF,RWS")
\ No newline at end of file
@@ -15,26 +15,24 @@ extern bool         g_hookApplied;
 extern HMODULE      g_targetModule;
 extern HMODULE      g_coreModule;
 extern HWND         g_hFocusWindow;
-extern bool         g_isMinimized;
-extern bool         g_leftMousePressed;
-extern bool         g_midMousePressed;
-extern bool         g_inputEnabled;
+// the HookState flags, only accessed through common::hookstate
+extern DWORD        g_hookState;
 extern float        g_pixelRate;
 extern FloatPoint   g_pixelOffset;
-extern bool         g_showImGui;
+// counts presented frames, only accessed through callbackstore::FrameCount and TriggerPostRenderCallbacks
+extern DWORD        g_frameCount;
 // for debugging purpose, not single source of truth
 extern POINT        g_playerPos;
 extern DoublePoint  g_playerPosRaw;
 extern GameInput    g_gameInput;
 
-// configuration from main exe
-extern GameConfigs  gs_gameConfigs;
-extern BYTE         gs_bombButton;
-extern BYTE         gs_extraButton;
-extern DWORD        gs_toggleOsCursorButton;
-extern DWORD        gs_toggleImGuiButton;
-extern WCHAR        gs_textureFilePath[MAX_PATH];
-extern DWORD        gs_textureBaseHeight;
-extern WCHAR        gs_imGuiFontPath[MAX_PATH];
-extern DWORD        gs_imGuiBaseFontSize;
-extern DWORD        gs_imGuiBaseVerticalResolution;
\ No newline at end of file
+// configuration from main exe, only written through common::seqlock
+extern DWORD        gs_sharedConfigSequence;
+extern SharedConfig gs_sharedConfig;
+// the process that installed the hooks, they're removed when it exits
+extern DWORD        gs_guiProcessId;
+// consistent copy of gs_sharedConfig for this process, and the sequence it was taken at
+extern SharedConfig g_sharedConfig;
+extern DWORD        g_sharedConfigSequence;
+// the buttons of g_sharedConfig, only accessed through common::keybindings
+extern DWORD        g_keyBindings;
\ No newline at end of file
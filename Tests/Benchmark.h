@@ -0,0 +1,42 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+
+// Timing for the benchmarks, each one is an executable whose main calls Measure once per case.
+// ctest runs them with --quick, so they keep building and running without taking long.
+namespace benchmark {
+    inline double minimumSeconds = 1;
+
+    inline void ParseArguments(int argc, char** argv) {
+        for (int i = 1; i < argc; i++) {
+            if (std::string_view(argv[i]) == "--quick")
+                minimumSeconds = 0.01;
+        }
+    }
+
+    // keeps the compiler from dropping a result nothing reads
+    template <typename T>
+    inline void DoNotOptimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // Call body in doubling batches until minimumSeconds have passed, then print the time per call and per item.
+    template <typename Body>
+    void Measure(const char* name, double itemsPerCall, const char* itemName, Body&& body) {
+        using clock = std::chrono::steady_clock;
+        body();
+        size_t calls = 0;
+        auto start = clock::now();
+        std::chrono::duration<double> elapsed{};
+        for (size_t batch = 1; elapsed.count() < minimumSeconds; batch *= 2) {
+            for (size_t i = 0; i < batch; i++)
+                body();
+            calls += batch;
+            elapsed = clock::now() - start;
+        }
+        auto nanoseconds = elapsed.count() * 1e9;
+        printf("%-44s %14.1f ns/call %12.2f ns/%-8s %10zu calls\n",
+            name, nanoseconds / calls, nanoseconds / (calls * itemsPerCall), itemName, calls);
+    }
+}
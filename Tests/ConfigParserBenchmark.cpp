@@ -0,0 +1,48 @@
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "ConfigParser.h"
+
+namespace configparser = core::configparser;
+
+using namespace std;
+
+// every kind of line the shipped database has
+constexpr const char* SampleLines[]{
+    "; a comment\n",
+    "th06            [002CA6B8]              float      (0,0)          480          4:3           DirectInput\n",
+    "th09            [000A7D94][1B88]        float      (161,17)       480          4:3           DirectInput\n",
+    "\"Touhou Game\"   \"[sig:A1 ?? ?? ?? ?? 8B 48 04+1][1B88]\"  double  (32,16)  480  4:3  GetKeyboardState/SendInput\n",
+    "Danmakai        \"expr:first([module+23D5624], in([[[module+23D561C]+i*4]+7C], 116, 117, 118, 119) ? [[module+23D561C]+i*4]+B4 : 0)\"  float  (239.5,13.5)  540  16:9  SendMessage\n",
+    "LuaGame         LuaJIT/Detached/Pull    float      (0,0)          480          4:3           SendMessage\n",
+};
+
+string MakeDatabase(int lineCount) {
+    string text;
+    for (int i = 0; i < lineCount; i++)
+        text += SampleLines[i % ARRAYSIZE(SampleLines)];
+    return text;
+}
+
+int main(int argc, char** argv) {
+    benchmark::ParseArguments(argc, argv);
+    for (auto lineCount : { 1000, 100000 }) {
+        auto text = MakeDatabase(lineCount);
+        vector<GameConfig> gameConfigs;
+        gameConfigs.reserve(lineCount);
+        configparser::Diagnostics diagnostics;
+        auto name = "ParseGamesText/" + to_string(lineCount);
+        benchmark::Measure(name.c_str(), lineCount, "line", [&] {
+            gameConfigs.clear();
+            diagnostics.clear();
+            configparser::ParseGamesText(text, "Games.txt", gameConfigs, diagnostics);
+            benchmark::DoNotOptimize(gameConfigs.data());
+        });
+        if (diagnostics.size() > 0) {
+            printf("%s\n", configparser::FormatDiagnostic(diagnostics[0]).c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "Helper.Encoding.h"
+#include "ConfigParser.h"
+
+namespace encoding = common::helper::encoding;
+namespace configparser = core::configparser;
+
+using namespace std;
+using configparser::Diagnostics;
+
+constexpr auto IniPath = "ConfigParserIniTests.ini";
+constexpr auto VkCodesPath = "ConfigParserIniTests.VirtualKeyCodes.txt";
+
+// a complete ThMouseX.ini, a test replaces or appends lines
+constexpr auto ValidIni =
+    "BombButton = VK_X\n"
+    "ExtraButton = VK_C\n"
+    "ToggleOsCursorButton = VK_M\n"
+    "ToggleImGuiButton = VK_BACK_QUOTE\n"
+    "ImGuiFontPath = tahoma.ttf\n"
+    "ImGuiBaseFontSize = 20\n"
+    "ImGuiBaseVerticalResolution = 960\n"
+    "CursorTexture = Cursor.png ; trailing comment\n"
+    "CursorBaseHeight = 480\n";
+
+class ConfigParserIni : public testing::Test {
+protected:
+    SharedConfig config{};
+    Diagnostics diagnostics;
+
+    void TearDown() override {
+        remove(IniPath);
+        remove(VkCodesPath);
+    }
+
+    void Write(const char* path, const string& content) {
+        ofstream(path, ios::binary) << content;
+    }
+
+    void Parse(const string& ini) {
+        Write(IniPath, ini);
+        configparser::ParseGeneralFile(IniPath, VkCodesPath, config, diagnostics);
+    }
+
+    vector<string> Messages() {
+        vector<string> messages;
+        for (auto& diagnostic : diagnostics)
+            messages.push_back(configparser::FormatDiagnostic(diagnostic));
+        return messages;
+    }
+};
+
+TEST_F(ConfigParserIni, ParsesEveryKey) {
+    Parse(string(ValidIni) + "MovementMode = predictive\nInputThreadRate = 1000\n");
+    EXPECT_EQ(Messages(), vector<string>{});
+    EXPECT_EQ(config.BombButton, 0x58);
+    EXPECT_EQ(config.ExtraButton, 0x43);
+    EXPECT_EQ(config.ToggleOsCursorButton, 0x4D);
+    EXPECT_EQ(config.ToggleImGuiButton, 0xC0);
+    EXPECT_EQ(config.ImGuiBaseFontSize, 20u);
+    EXPECT_EQ(config.ImGuiBaseVerticalResolution, 960u);
+    EXPECT_EQ(config.TextureBaseHeight, 480u);
+    EXPECT_TRUE(encoding::ConvertToUtf8(config.TextureFilePath).ends_with("Cursor.png"));
+    EXPECT_EQ(config.MovementMode, MovementMode::Predictive);
+    EXPECT_EQ(config.InputThreadRate, 1000u);
+}
+
+TEST_F(ConfigParserIni, OptionalKeysHaveDefaults) {
+    config.MovementMode = MovementMode::Straight;
+    config.InputThreadRate = 500;
+    Parse(ValidIni);
+    EXPECT_EQ(Messages(), vector<string>{});
+    EXPECT_EQ(config.MovementMode, MovementMode::Classic);
+    EXPECT_EQ(config.InputThreadRate, 0u);
+}
+
+TEST_F(ConfigParserIni, ReportsEveryProblem) {
+    Parse(
+        "BombButton = VK_NOPE\n"
+        "ToggleOsCursorButton = VK_M\n"
+        "ToggleImGuiButton = VK_BACK_QUOTE\n"
+        "ImGuiFontPath =\n"
+        "ImGuiBaseFontSize = twenty\n"
+        "ImGuiBaseVerticalResolution = 960\n"
+        "CursorTexture = Cursor.png\n"
+        "CursorBaseHeight = 480\n"
+        "MovementMode = Sideways\n"
+        "InputThreadRate = 100\n"
+        "not a key\n");
+    EXPECT_EQ(Messages(), (vector<string>{
+        "ConfigParserIniTests.ini: invalid syntax: \"not a key\"",
+        "ConfigParserIniTests.ini: invalid BombButton: unknown key \"VK_NOPE\"",
+        "ConfigParserIniTests.ini: invalid ExtraButton: missing value",
+        "ConfigParserIniTests.ini: invalid ImGuiFontPath: empty path",
+        "ConfigParserIniTests.ini: invalid ImGuiBaseFontSize: invalid format",
+        "ConfigParserIniTests.ini: invalid MovementMode: unknown mode \"Sideways\"",
+        "ConfigParserIniTests.ini: invalid InputThreadRate: must be 0 or between 250 and 8000",
+    }));
+}
+
+TEST_F(ConfigParserIni, MissingFile) {
+    configparser::ParseGeneralFile("NoSuchFile.ini", VkCodesPath, config, diagnostics);
+    EXPECT_EQ(Messages(), vector<string>{ "NoSuchFile.ini: missing file" });
+}
+
+TEST_F(ConfigParserIni, ButtonsCanUseTheUserKeyNames) {
+    Write(VkCodesPath, "; comment\nMY_BOMB 0xBA\nVK_C 0x44\n");
+    Parse(string(ValidIni) + "BombButton = MY_BOMB\n");
+    // the second BombButton is a duplicate to inipp
+    ASSERT_EQ(Messages(), vector<string>{ "ConfigParserIniTests.ini: invalid syntax: \"BombButton = MY_BOMB\"" });
+    diagnostics.clear();
+    Parse("BombButton = MY_BOMB\n" + string(ValidIni).substr(string(ValidIni).find('\n') + 1));
+    EXPECT_EQ(Messages(), vector<string>{});
+    EXPECT_EQ(config.BombButton, 0xBA);
+    // a user entry takes precedence over the built-in name
+    EXPECT_EQ(config.ExtraButton, 0x44);
+}
+
+TEST_F(ConfigParserIni, ReportsBadUserKeyNames) {
+    Write(VkCodesPath, "MY_BOMB 0xBA\nMY_SHOT 0xZZ\n");
+    Parse(ValidIni);
+    EXPECT_EQ(Messages(), vector<string>{ "ConfigParserIniTests.VirtualKeyCodes.txt(2,9): invalid value: invalid format" });
+}
+
+// the tests run in the Tests directory, the shipped file is next to it
+TEST_F(ConfigParserIni, ShippedFileHasNoProblems) {
+    configparser::ParseGeneralFile("../ThMouseX/ThMouseX.ini", VkCodesPath, config, diagnostics);
+    EXPECT_EQ(Messages(), vector<string>{});
+}
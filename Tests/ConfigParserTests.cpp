@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include <climits>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Helper.h"
+#include "ConfigParser.h"
+
+namespace helper = common::helper;
+namespace configparser = core::configparser;
+
+using namespace std;
+using configparser::Diagnostics;
+
+vector<string_view> Tokenize(string_view line) {
+    vector<string_view> tokens;
+    while (true) {
+        auto token = configparser::NextToken(line);
+        if (token.empty() && line.empty())
+            return tokens;
+        tokens.push_back(token);
+    }
+}
+
+template <typename T>
+string MessageOf(const tuple<T, const char*>& result) {
+    return get<1>(result) ? get<1>(result) : "no error";
+}
+
+TEST(Tokenizer, SplitsOnAnyWhitespace) {
+    auto tokens = Tokenize(" th06\t[002CA6B8]  float\r");
+    ASSERT_EQ(tokens.size(), 3u);
+    EXPECT_EQ(tokens[0], "th06");
+    EXPECT_EQ(tokens[1], "[002CA6B8]");
+    EXPECT_EQ(tokens[2], "float");
+}
+
+TEST(Tokenizer, QuotedTokenKeepsSpaces) {
+    auto tokens = Tokenize("\"Touhou Game.exe\" next");
+    ASSERT_EQ(tokens.size(), 2u);
+    EXPECT_EQ(tokens[0], "Touhou Game.exe");
+    EXPECT_EQ(tokens[1], "next");
+}
+
+TEST(Tokenizer, UnterminatedQuoteTakesTheRestOfTheLine) {
+    auto tokens = Tokenize("\"Touhou Game.exe next");
+    ASSERT_EQ(tokens.size(), 1u);
+    EXPECT_EQ(tokens[0], "Touhou Game.exe next");
+}
+
+TEST(Tokenizer, MissingTokenPointsAtTheEndOfTheLine) {
+    string_view line = "th06   ";
+    configparser::NextToken(line);
+    auto missing = configparser::NextToken(line);
+    EXPECT_TRUE(missing.empty());
+    EXPECT_EQ(missing.data(), line.data());
+}
+
+TEST(Tokenizer, CommentLines) {
+    EXPECT_TRUE(configparser::IsCommentLine("; comment"));
+    EXPECT_TRUE(configparser::IsCommentLine("   ; indented comment"));
+    EXPECT_TRUE(configparser::IsCommentLine(" \t\r"));
+    EXPECT_TRUE(configparser::IsCommentLine(""));
+    EXPECT_FALSE(configparser::IsCommentLine("th06 ; trailing"));
+}
+
+TEST(Tokenizer, EqualsIgnoreCase) {
+    EXPECT_TRUE(configparser::EqualsIgnoreCase("DirectInput", "directinput"));
+    EXPECT_FALSE(configparser::EqualsIgnoreCase("DirectInput", "DirectInput8"));
+    EXPECT_FALSE(configparser::EqualsIgnoreCase("", "Int"));
+}
+
+TEST(ParseGamesText, ParsesEveryField) {
+    vector<GameConfig> gameConfigs;
+    Diagnostics diagnostics;
+    configparser::ParseGamesText(
+        "; comment\n"
+        "th09  [000A7D94][1B88]  float  (161,17)  480  4:3  DirectInput/SendInput\r\n",
+        "Games.txt", gameConfigs, diagnostics);
+    ASSERT_EQ(diagnostics.size(), 0u);
+    ASSERT_EQ(gameConfigs.size(), 1u);
+    auto& config = gameConfigs[0];
+    EXPECT_EQ(wstring(config.ProcessName), L"th09");
+    ASSERT_EQ(config.Address.Length, 2);
+    EXPECT_EQ(config.Address.Level[0], 0xA7D94u);
+    EXPECT_EQ(config.Address.Level[1], 0x1B88u);
+    EXPECT_EQ(config.PosDataType, PointDataType::Float);
+    EXPECT_EQ(config.BasePixelOffset.X, 161.f);
+    EXPECT_EQ(config.BasePixelOffset.Y, 17.f);
+    EXPECT_EQ(config.BaseHeight, 480u);
+    EXPECT_EQ(config.AspectRatio.X, 4.f);
+    EXPECT_EQ(config.AspectRatio.Y, 3.f);
+    EXPECT_EQ(config.InputMethods, InputMethod::DirectInput | InputMethod::SendInput);
+}
+
+TEST(ParseGamesText, SkipsTheBom) {
+    vector<GameConfig> gameConfigs;
+    Diagnostics diagnostics;
+    configparser::ParseGamesText("\xEF\xBB\xBFth06 [002CA6B8] float (0,0) 480 4:3 DirectInput", "Games.txt", gameConfigs, diagnostics);
+    ASSERT_EQ(gameConfigs.size(), 1u);
+    EXPECT_EQ(wstring(gameConfigs[0].ProcessName), L"th06");
+}
+
+TEST(ParseGamesText, ReportsEveryBadFieldWithItsLocation) {
+    vector<GameConfig> gameConfigs;
+    Diagnostics diagnostics;
+    configparser::ParseGamesText(
+        "th06 [002CA6B8] float (0,0) 480 4:3 DirectInput\n"
+        "th07 [000BE408] bool (32,16) 0 4:3\n",
+        "Games.txt", gameConfigs, diagnostics);
+    EXPECT_EQ(gameConfigs.size(), 1u);
+    ASSERT_EQ(diagnostics.size(), 3u);
+    EXPECT_EQ(configparser::FormatDiagnostic(diagnostics[0]), "Games.txt(2,17): invalid dataType: expected Int, Float, Short or Double");
+    EXPECT_EQ(configparser::FormatDiagnostic(diagnostics[1]), "Games.txt(2,30): invalid baseHeight: must be greater than 0");
+    EXPECT_EQ(configparser::FormatDiagnostic(diagnostics[2]), "Games.txt(2,35): invalid inputMethod: missing value");
+}
+
+TEST(ParseGamesFile, MissingFile) {
+    vector<GameConfig> gameConfigs;
+    Diagnostics diagnostics;
+    configparser::ParseGamesFile("NoSuchGames.txt", gameConfigs, diagnostics, true);
+    EXPECT_EQ(diagnostics.size(), 0u);
+    configparser::ParseGamesFile("NoSuchGames.txt", gameConfigs, diagnostics);
+    ASSERT_EQ(diagnostics.size(), 1u);
+    EXPECT_EQ(configparser::FormatDiagnostic(diagnostics[0]), "NoSuchGames.txt: missing file");
+}
+
+// the tests run in the Tests directory, the shipped file is next to it
+TEST(ParseGamesFile, ShippedDatabaseHasNoProblems) {
+    vector<GameConfig> gameConfigs;
+    Diagnostics diagnostics;
+    configparser::ParseGamesFile("../ThMouseX/Games.txt", gameConfigs, diagnostics);
+    for (auto& diagnostic : diagnostics)
+        ADD_FAILURE() << configparser::FormatDiagnostic(diagnostic);
+    EXPECT_GT(gameConfigs.size(), 0u);
+}
+
+// The numbers of the config files keep the rules of strtof, strtol and strtoul, which the files were written for.
+TEST(ConvertToNumber, AcceptsLeadingWhitespaceAndSign) {
+    EXPECT_EQ(helper::ConvertToLong(" \t+5", 10), tuple(5L, (const char*)nullptr));
+    EXPECT_EQ(helper::ConvertToLong("-5", 10), tuple(-5L, (const char*)nullptr));
+    EXPECT_EQ(helper::ConvertToFloat(" 1.5"), tuple(1.5f, (const char*)nullptr));
+}
+
+TEST(ConvertToNumber, SignGoesBeforeTheRadixPrefix) {
+    EXPECT_EQ(helper::ConvertToLong("-0x10", 16), tuple(-16L, (const char*)nullptr));
+    EXPECT_EQ(helper::ConvertToLong("0X1f", 16), tuple(31L, (const char*)nullptr));
+    EXPECT_EQ(helper::ConvertToULong("1f", 16), tuple(31UL, (const char*)nullptr));
+    EXPECT_EQ(MessageOf(helper::ConvertToLong("0x-10", 16)), "invalid format");
+}
+
+TEST(ConvertToNumber, BaseZeroPicksTheRadixFromThePrefix) {
+    EXPECT_EQ(helper::ConvertToLong("0x10", 0), tuple(16L, (const char*)nullptr));
+    EXPECT_EQ(helper::ConvertToLong("010", 0), tuple(8L, (const char*)nullptr));
+    EXPECT_EQ(helper::ConvertToLong("10", 0), tuple(10L, (const char*)nullptr));
+    EXPECT_EQ(helper::ConvertToLong("0", 0), tuple(0L, (const char*)nullptr));
+}
+
+TEST(ConvertToNumber, NegativeUnsignedWrapsAround) {
+    EXPECT_EQ(helper::ConvertToULong("-1", 10), tuple(ULONG_MAX, (const char*)nullptr));
+    EXPECT_EQ(helper::ConvertToULong("-0x10", 16), tuple(0UL - 16, (const char*)nullptr));
+}
+
+TEST(ConvertToNumber, HexFloats) {
+    EXPECT_EQ(helper::ConvertToFloat("0x1p3"), tuple(8.f, (const char*)nullptr));
+    EXPECT_EQ(helper::ConvertToFloat("-0x1.8p1"), tuple(-3.f, (const char*)nullptr));
+}
+
+TEST(ConvertToNumber, Limits) {
+    auto minimum = to_string(LONG_MIN);
+    EXPECT_EQ(helper::ConvertToLong(minimum, 10), tuple(LONG_MIN, (const char*)nullptr));
+    auto belowMinimum = minimum;
+    belowMinimum.back()++;
+    EXPECT_EQ(MessageOf(helper::ConvertToLong(belowMinimum, 10)), "out of range (type long)");
+    EXPECT_EQ(MessageOf(helper::ConvertToULong("99999999999999999999999", 10)), "out of range (type unsigned long)");
+    EXPECT_EQ(MessageOf(helper::ConvertToFloat("1e60")), "out of range (type float)");
+}
+
+TEST(ConvertToNumber, RejectsWhatStrtolDidNotConsume) {
+    for (auto input : { "", " ", "+", "-", "12abc", "1 ", "0x", "--1", "+-1" })
+        EXPECT_EQ(MessageOf(helper::ConvertToLong(input, 10)), "invalid format") << '"' << input << '"';
+    for (auto input : { "", "1.5f", "0x", "1,5" })
+        EXPECT_EQ(MessageOf(helper::ConvertToFloat(input)), "invalid format") << '"' << input << '"';
+}
+
+TEST(VkCodes, BuiltInNames) {
+    configparser::VkCodes none;
+    EXPECT_EQ(configparser::FindVkCode(none, "VK_X"), optional<BYTE>(0x58));
+    EXPECT_EQ(configparser::FindVkCode(none, "VK_BACK_QUOTE"), optional<BYTE>(0xC0));
+    EXPECT_EQ(configparser::FindVkCode(none, "vk_x"), nullopt);
+    EXPECT_EQ(configparser::FindVkCode(none, "VK_"), nullopt);
+}
+
+TEST(VkCodes, UserNamesTakePrecedence) {
+    configparser::VkCodes user{ { "MY_BOMB", 0xBA }, { "VK_X", 0x59 } };
+    EXPECT_EQ(configparser::FindVkCode(user, "MY_BOMB"), optional<BYTE>(0xBA));
+    EXPECT_EQ(configparser::FindVkCode(user, "VK_X"), optional<BYTE>(0x59));
+    EXPECT_EQ(configparser::FindVkCode(user, "VK_C"), optional<BYTE>(0x43));
+}
+
+// the template is only comments, so it changes nothing until a user adds to it
+TEST(VkCodes, ShippedTemplateIsEmpty) {
+    Diagnostics diagnostics;
+    auto vkCodes = configparser::ParseVkCodesFile("../ThMouseX/VirtualKeyCodes.txt", diagnostics);
+    EXPECT_EQ(diagnostics.size(), 0u);
+    EXPECT_EQ(vkCodes.size(), 0u);
+}
+
+TEST(VkCodes, MissingFileIsNoProblem) {
+    Diagnostics diagnostics;
+    auto vkCodes = configparser::ParseVkCodesFile("NoSuchVirtualKeyCodes.txt", diagnostics);
+    EXPECT_EQ(diagnostics.size(), 0u);
+    EXPECT_EQ(vkCodes.size(), 0u);
+}
@@ -0,0 +1,48 @@
+#include <cwchar>
+#include <format>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "DataTypes.h"
+#include "Variables.h"
+#include "GameConfigRegion.h"
+
+namespace gameconfigregion = core::gameconfigregion;
+
+using namespace std;
+
+// what core::Initialize did before the index: a reverse scan, so later entries win
+const GameConfig* FindLinear(const vector<GameConfig>& gameConfigs, const WCHAR* processName) {
+    for (auto i = gameConfigs.size(); i > 0; i--) {
+        if (_wcsicmp(gameConfigs[i - 1].ProcessName, processName) == 0)
+            return &gameConfigs[i - 1];
+    }
+    return nullptr;
+}
+
+// The index lookup goes through Find like a game process does, so it includes opening and mapping the region.
+int main(int argc, char** argv) {
+    benchmark::ParseArguments(argc, argv);
+    for (auto entryCount : { 128, 1000, 10000 }) {
+        vector<GameConfig> gameConfigs(entryCount);
+        for (int i = 0; i < entryCount; i++)
+            swprintf(gameConfigs[i].ProcessName, ARRAYSIZE(gameConfigs[i].ProcessName), L"Game%05d.exe", i);
+        auto region = gameconfigregion::Build(gameConfigs);
+        if (!gameconfigregion::Publish(region))
+            return 1;
+
+        // the first entry is the worst case of the reverse scan, a missing name is the worst case of both
+        for (auto processName : { L"game00000.EXE", L"NotAGame.exe" }) {
+            auto caseName = format("/{}/{}", entryCount, processName[0] == L'g' ? "first" : "missing");
+            benchmark::Measure(("LinearScan" + caseName).c_str(), 1, "lookup", [&] {
+                benchmark::DoNotOptimize(FindLinear(gameConfigs, processName));
+            });
+            GameConfig found;
+            benchmark::Measure(("IndexFind" + caseName).c_str(), 1, "lookup", [&] {
+                benchmark::DoNotOptimize(gameconfigregion::Find(gs_sharedConfig.GameConfigRegionName, processName, found));
+            });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <format>
+#include <string>
+#include <vector>
+
+#include "DataTypes.h"
+#include "Variables.h"
+#include "GameConfigRegion.h"
+
+namespace gameconfigregion = core::gameconfigregion;
+
+using namespace std;
+
+GameConfig MakeConfig(const WCHAR* processName, DWORD baseHeight) {
+    GameConfig config{};
+    wcscpy(config.ProcessName, processName);
+    config.Address.Length = 2;
+    config.Address.Level[0] = 0x2CA6B8;
+    config.Address.Level[1] = baseHeight;
+    config.Signature.Length = 3;
+    config.Signature.Bytes[0] = 0xA1;
+    config.Signature.Mask[0] = 0xFF;
+    config.Signature.Offset = 1;
+    config.PosDataType = PointDataType::Float;
+    config.BaseHeight = baseHeight;
+    config.InputMethods = InputMethod::DirectInput;
+    return config;
+}
+
+bool PublishAndFind(const vector<GameConfig>& gameConfigs, const WCHAR* processName, GameConfig& found) {
+    auto region = gameconfigregion::Build(gameConfigs);
+    if (!gameconfigregion::Publish(region))
+        return false;
+    return gameconfigregion::Find(gs_sharedConfig.GameConfigRegionName, processName, found);
+}
+
+TEST(GameConfigRegion, FindsEveryEntryWithAllItsFields) {
+    vector<GameConfig> gameConfigs;
+    for (int i = 0; i < 100; i++)
+        gameConfigs.push_back(MakeConfig(format(L"th{:02}.exe", i).c_str(), 400 + i));
+    for (int i = 0; i < 100; i++) {
+        GameConfig found;
+        ASSERT_TRUE(PublishAndFind(gameConfigs, gameConfigs[i].ProcessName, found)) << i;
+        EXPECT_EQ(wstring(found.ProcessName), wstring(gameConfigs[i].ProcessName));
+        EXPECT_EQ(found.BaseHeight, DWORD(400 + i));
+        ASSERT_EQ(found.Address.Length, 2);
+        EXPECT_EQ(found.Address.Level[1], DWORD(400 + i));
+        ASSERT_EQ(found.Signature.Length, 3);
+        EXPECT_EQ(found.Signature.Bytes[0], 0xA1);
+        EXPECT_EQ(found.Signature.Mask[0], 0xFF);
+        EXPECT_EQ(found.Signature.Offset, 1u);
+        EXPECT_EQ(found.InputMethods, InputMethod::DirectInput);
+    }
+}
+
+TEST(GameConfigRegion, MatchIgnoresCase) {
+    GameConfig found;
+    ASSERT_TRUE(PublishAndFind({ MakeConfig(L"TH06.exe", 480) }, L"th06.EXE", found));
+    EXPECT_EQ(found.BaseHeight, 480u);
+}
+
+// Games2.txt is read after Games.txt, so its entries override the earlier ones
+TEST(GameConfigRegion, LastEntryWins) {
+    GameConfig found;
+    vector<GameConfig> gameConfigs{ MakeConfig(L"th06.exe", 480), MakeConfig(L"th07.exe", 480), MakeConfig(L"TH06.EXE", 960) };
+    ASSERT_TRUE(PublishAndFind(gameConfigs, L"th06.exe", found));
+    EXPECT_EQ(found.BaseHeight, 960u);
+    EXPECT_EQ(wstring(found.ProcessName), L"TH06.EXE");
+}
+
+TEST(GameConfigRegion, UnknownProcess) {
+    GameConfig found;
+    EXPECT_FALSE(PublishAndFind({ MakeConfig(L"th06.exe", 480) }, L"th07.exe", found));
+    EXPECT_FALSE(PublishAndFind({}, L"th07.exe", found));
+    EXPECT_FALSE(gameconfigregion::Find(L"", L"th06.exe", found));
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "Helper.Memory.h"
+
+namespace memory = common::helper::memory;
+
+using namespace std;
+
+// how long a thread trusts the regions it found readable, see Helper.Memory.cpp
+constexpr auto RangesLifetime = chrono::milliseconds(16);
+const DWORD PageSize = DWORD(sysconf(_SC_PAGESIZE));
+
+// Pages of their own, so a test can change their protection without touching anything else.
+class Pages {
+public:
+    explicit Pages(DWORD count, int protection = PROT_READ | PROT_WRITE) : size(count * PageSize) {
+        memory = mmap(nullptr, size, protection, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        EXPECT_NE(memory, MAP_FAILED);
+    }
+    ~Pages() {
+        munmap(memory, size);
+    }
+    DWORD Address(DWORD page, DWORD offset = 0) const {
+        return DWORD(memory) + page * PageSize + offset;
+    }
+    void Protect(DWORD page, int protection) {
+        EXPECT_EQ(mprotect((char*)memory + page * PageSize, PageSize, protection), 0);
+    }
+private:
+    void* memory;
+    size_t size;
+};
+
+// Let the cache of this thread expire, so a test starts from what VirtualQuery says.
+void ExpireReadableRanges() {
+    this_thread::sleep_for(RangesLifetime + chrono::milliseconds(4));
+}
+
+TEST(ReadableRanges, ReadsMappedMemory) {
+    Pages pages(1);
+    *(DWORD*)pages.Address(0, 8) = 0x12345678;
+    DWORD value;
+    ASSERT_TRUE(memory::TryReadDword(pages.Address(0, 8), value));
+    EXPECT_EQ(value, 0x12345678u);
+}
+
+TEST(ReadableRanges, NullAndLowAddressesAreUnreadable) {
+    DWORD value = 1;
+    EXPECT_FALSE(memory::TryReadDword(0, value));
+    EXPECT_FALSE(memory::TryReadDword(0x10, value));
+    EXPECT_FALSE(memory::IsReadable(0xFFFC, 4));
+    EXPECT_EQ(value, 1u);
+}
+
+TEST(ReadableRanges, ReadSpansAdjacentRegions) {
+    Pages pages(3);
+    // different protections make separate regions
+    pages.Protect(1, PROT_READ);
+    pages.Protect(2, PROT_NONE);
+    EXPECT_TRUE(memory::IsReadable(pages.Address(0, PageSize - 2), 4));
+    EXPECT_TRUE(memory::IsReadable(pages.Address(0), 2 * PageSize));
+    EXPECT_FALSE(memory::IsReadable(pages.Address(1, PageSize - 2), 4));
+    EXPECT_FALSE(memory::IsReadable(pages.Address(2), 1));
+}
+
+TEST(ReadableRanges, UnreadableRegionsArentRemembered) {
+    Pages pages(1, PROT_NONE);
+    EXPECT_FALSE(memory::IsReadable(pages.Address(0), 4));
+    pages.Protect(0, PROT_READ);
+    EXPECT_TRUE(memory::IsReadable(pages.Address(0), 4));
+}
+
+// A region the game frees stays trusted for at most the lifetime of the cache, nothing catches a fault on the read.
+TEST(ReadableRanges, ProtectedRegionIsForgottenAfterTheLifetime) {
+    Pages pages(1);
+    ExpireReadableRanges();
+    auto start = chrono::steady_clock::now();
+    EXPECT_TRUE(memory::IsReadable(pages.Address(0), 4));
+    pages.Protect(0, PROT_NONE);
+    auto stillTrusted = memory::IsReadable(pages.Address(0), 4);
+    if (chrono::steady_clock::now() - start < RangesLifetime)
+        EXPECT_TRUE(stillTrusted);
+    ExpireReadableRanges();
+    EXPECT_FALSE(memory::IsReadable(pages.Address(0), 4));
+}
+
+TEST(ReadableRanges, EachThreadHasItsOwnCache) {
+    Pages pages(1);
+    ExpireReadableRanges();
+    EXPECT_TRUE(memory::IsReadable(pages.Address(0), 4));
+    pages.Protect(0, PROT_NONE);
+    // a thread that never saw the region asks VirtualQuery
+    bool readableInOtherThread = true;
+    thread([&] { readableInOtherThread = memory::IsReadable(pages.Address(0), 4); }).join();
+    EXPECT_FALSE(readableInOtherThread);
+}
+
+// The input thread and a script on the game thread read at the same time, each through its own cache.
+TEST(ReadableRanges, ConcurrentReadersGetTheirValues) {
+    constexpr DWORD RegionCount = 64;
+    constexpr auto ThreadCount = 8;
+    constexpr auto ReadCount = 20000;
+    vector<unique_ptr<Pages>> regions;
+    for (DWORD i = 0; i < RegionCount; i++) {
+        regions.push_back(make_unique<Pages>(1));
+        *(DWORD*)regions.back()->Address(0, 16) = i + 1;
+    }
+    atomic<int> failures = 0;
+    vector<thread> threads;
+    for (auto t = 0; t < ThreadCount; t++) {
+        threads.emplace_back([&, t] {
+            for (auto n = 0; n < ReadCount; n++) {
+                auto i = DWORD(n * 7 + t) % RegionCount;
+                DWORD value;
+                if (!memory::TryReadDword(regions[i]->Address(0, 16), value) || value != i + 1)
+                    failures++;
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(failures, 0);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "DataTypes.h"
+#include "Variables.h"
+#include "HookState.h"
+
+namespace hookstate = common::hookstate;
+
+using namespace std;
+
+class HookStateTest : public testing::Test {
+protected:
+    void SetUp() override {
+        g_hookState = DWORD(HookState::None);
+    }
+};
+
+TEST_F(HookStateTest, SetAndToggleReturnTheirStates) {
+    EXPECT_EQ(hookstate::Set(HookState::InputEnabled | HookState::Minimized, true), HookState::None);
+    EXPECT_EQ(hookstate::Set(HookState::Minimized, false), HookState::InputEnabled | HookState::Minimized);
+    EXPECT_EQ(hookstate::Toggle(HookState::InputEnabled | HookState::ShowImGui), HookState::ShowImGui);
+    EXPECT_TRUE(hookstate::Has(hookstate::Load(), HookState::ShowImGui));
+    EXPECT_FALSE(hookstate::Has(hookstate::Load(), HookState::ShowImGui | HookState::InputEnabled));
+}
+
+// ToggleImGuiButton in MessageQueue: showing ImGui turns the input off in the same step
+HookState ToggleImGui(HookState current) {
+    if (hookstate::Has(current, HookState::ShowImGui))
+        return HookState(DWORD(current) & ~DWORD(HookState::ShowImGui));
+    return HookState(DWORD(current | HookState::ShowImGui) & ~DWORD(HookState::InputEnabled));
+}
+
+// Each thread owns some flags, and changes them the ways the message hooks do while the others change theirs.
+// No change is lost, and a reader never sees ImGui shown with the input on, which no writer makes.
+TEST_F(HookStateTest, ConcurrentChangesKeepEveryFlag) {
+    atomic<bool> stop = false;
+    atomic<DWORD> violations = 0;
+    vector<thread> threads;
+    threads.emplace_back([&] {
+        // an even number of changes, so each thread leaves its flags as they were
+        for (auto i = 0; !stop.load(memory_order_relaxed) || i % 2 != 0; i++)
+            hookstate::Update(ToggleImGui);
+    });
+    threads.emplace_back([&] {
+        while (!stop.load(memory_order_relaxed)) {
+            auto state = hookstate::Update([](HookState current) {
+                if (hookstate::Has(current, HookState::ShowImGui))
+                    return current;
+                return HookState(DWORD(current) ^ DWORD(HookState::InputEnabled));
+            });
+            if (hookstate::Has(state, HookState::ShowImGui | HookState::InputEnabled))
+                violations++;
+        }
+    });
+    for (auto flag : { HookState::LeftMousePressed, HookState::MidMousePressed, HookState::Minimized }) {
+        threads.emplace_back([&, flag] {
+            for (auto i = 0; !stop.load(memory_order_relaxed) || i % 2 != 0; i++) {
+                auto value = i % 2 == 0;
+                // nobody else changes this flag, so it's what this thread made it before and after each change
+                if (i % 4 < 2) {
+                    if (hookstate::Has(hookstate::Set(flag, value), flag) == value)
+                        violations++;
+                }
+                else if (hookstate::Has(hookstate::Toggle(flag), flag) != value) {
+                    violations++;
+                }
+                if (hookstate::Has(hookstate::Load(), flag) != value)
+                    violations++;
+            }
+        });
+    }
+    threads.emplace_back([&] {
+        while (!stop.load(memory_order_relaxed)) {
+            if (hookstate::Has(hookstate::Load(), HookState::ShowImGui | HookState::InputEnabled))
+                violations++;
+        }
+    });
+    // long enough for the threads to be preempted in the middle of their changes many times, even on one core
+    this_thread::sleep_for(chrono::milliseconds(300));
+    stop = true;
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(violations.load(), 0u);
+    auto state = hookstate::Load();
+    EXPECT_FALSE(hookstate::Has(state, HookState::ShowImGui));
+    EXPECT_FALSE(hookstate::Has(state, HookState::LeftMousePressed));
+    EXPECT_FALSE(hookstate::Has(state, HookState::MidMousePressed));
+    EXPECT_FALSE(hookstate::Has(state, HookState::Minimized));
+}
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "DataTypes.h"
+#include "Helper.Encoding.h"
+#include "InputLog.h"
+#include "MovementControl.h"
+#include "InputDecision.h"
+
+namespace encoding = common::helper::encoding;
+namespace inputlog = common::inputlog;
+namespace inputdecision = core::inputdecision;
+namespace movementcontrol = core::movementcontrol;
+
+using namespace std;
+using inputlog::Frame;
+
+// A log file of its own for each test, removed afterwards.
+class InputLogFile : public testing::Test {
+protected:
+    string path = testing::TempDir() + testing::UnitTest::GetInstance()->current_test_info()->name() + ".inputlog";
+    wstring widePath = encoding::ConvertToUtf16(path.c_str());
+
+    void TearDown() override {
+        remove(path.c_str());
+    }
+
+    void Write(const vector<Frame>& frames) {
+        inputlog::Writer writer;
+        ASSERT_TRUE(inputlog::Open(writer, widePath.c_str()));
+        for (auto& frame : frames)
+            ASSERT_TRUE(inputlog::Append(writer, frame));
+        ASSERT_TRUE(inputlog::Close(writer));
+    }
+
+    vector<BYTE> Content() {
+        vector<BYTE> content;
+        auto file = fopen(path.c_str(), "rb");
+        if (file == nullptr)
+            return content;
+        for (int byte; (byte = fgetc(file)) != EOF;)
+            content.push_back(BYTE(byte));
+        fclose(file);
+        return content;
+    }
+
+    void Overwrite(const vector<BYTE>& content) {
+        auto file = fopen(path.c_str(), "wb");
+        ASSERT_NE(file, nullptr);
+        fwrite(content.data(), 1, content.size(), file);
+        fclose(file);
+    }
+};
+
+void ExpectSameFrame(const Frame& actual, const Frame& expected, size_t index) {
+    EXPECT_EQ(actual.FrameCount, expected.FrameCount) << index;
+    EXPECT_EQ(actual.InputEnabled, expected.InputEnabled) << index;
+    EXPECT_EQ(actual.ShowImGui, expected.ShowImGui) << index;
+    EXPECT_EQ(actual.LeftPressed, expected.LeftPressed) << index;
+    EXPECT_EQ(actual.MidPressed, expected.MidPressed) << index;
+    EXPECT_EQ(actual.HasPosition, expected.HasPosition) << index;
+    EXPECT_EQ(actual.MousePosition.x, expected.MousePosition.x) << index;
+    EXPECT_EQ(actual.MousePosition.y, expected.MousePosition.y) << index;
+    EXPECT_EQ(memcmp(&actual.PlayerPositionRaw, &expected.PlayerPositionRaw, sizeof(DoublePoint)), 0) << index;
+    EXPECT_EQ(actual.ClientSize.cx, expected.ClientSize.cx) << index;
+    EXPECT_EQ(actual.ClientSize.cy, expected.ClientSize.cy) << index;
+    EXPECT_EQ(memcmp(&actual.AspectRatio, &expected.AspectRatio, sizeof(FloatPoint)), 0) << index;
+    EXPECT_EQ(memcmp(&actual.PixelRate, &expected.PixelRate, sizeof(float)), 0) << index;
+    EXPECT_EQ(memcmp(&actual.PixelOffset, &expected.PixelOffset, sizeof(FloatPoint)), 0) << index;
+    EXPECT_EQ(actual.MovementMode, expected.MovementMode) << index;
+    EXPECT_EQ(actual.GameInput, expected.GameInput) << index;
+}
+
+// Each field changes now and then, by a little or by a lot, the way they do in a game.
+vector<Frame> RandomFrames(size_t count) {
+    mt19937 random(23);
+    auto chance = [&](int percent) { return uniform_int_distribution<int>(0, 99)(random) < percent; };
+    auto small = [&] { return LONG(uniform_int_distribution<int>(-60, 60)(random)); };
+    auto large = [&] { return LONG(uniform_int_distribution<int>(-0x7FFF'FFFF, 0x7FFF'FFFF)(random)); };
+    vector<Frame> frames;
+    Frame frame{
+        .FrameCount = 0xFFFF'FF00,
+        .ClientSize = { 640, 480 },
+        .AspectRatio = { 4, 3 },
+        .PixelRate = 1,
+    };
+    for (size_t i = 0; i < count; i++) {
+        // up by one most of the time, it wraps around too
+        frame.FrameCount = DWORD(uint32_t(frame.FrameCount + (chance(90) ? 1 : uniform_int_distribution<int>(-5, 5)(random))));
+        if (chance(5)) {
+            frame.InputEnabled = chance(80);
+            frame.ShowImGui = chance(20);
+            frame.LeftPressed = chance(10);
+            frame.MidPressed = chance(10);
+            frame.HasPosition = chance(90);
+            frame.MovementMode = MovementMode(uniform_int_distribution<int>(0, 3)(random));
+        }
+        if (chance(60)) {
+            // LONG is 32 bits in the game
+            frame.MousePosition.x = LONG(int32_t(frame.MousePosition.x + (chance(95) ? small() : large())));
+            frame.MousePosition.y = LONG(int32_t(frame.MousePosition.y + (chance(95) ? small() : large())));
+        }
+        if (chance(70))
+            frame.PlayerPositionRaw.X += uniform_real_distribution<double>(-5, 5)(random);
+        if (chance(70))
+            frame.PlayerPositionRaw.Y = float(uniform_real_distribution<double>(0, 448)(random));
+        if (chance(1))
+            frame.ClientSize = { LONG(uniform_int_distribution<int>(1, 4000)(random)), LONG(uniform_int_distribution<int>(1, 3000)(random)) };
+        if (chance(1)) {
+            frame.PixelRate = uniform_real_distribution<float>(0.25f, 4)(random);
+            frame.PixelOffset = { uniform_real_distribution<float>(-100, 100)(random), uniform_real_distribution<float>(-100, 100)(random) };
+        }
+        if (chance(30))
+            frame.GameInput = GameInput(uniform_int_distribution<int>(0, 0xF7)(random));
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+TEST_F(InputLogFile, RoundTripsEveryField) {
+    // more than the buffer of the writer holds, so it's flushed along the way
+    auto frames = RandomFrames(50000);
+    Write(frames);
+    vector<Frame> read;
+    ASSERT_TRUE(inputlog::Read(widePath.c_str(), read));
+    ASSERT_EQ(read.size(), frames.size());
+    for (size_t i = 0; i < frames.size(); i++)
+        ExpectSameFrame(read[i], frames[i], i);
+}
+
+// The bytes the game writes on Windows, so a log recorded there reads the same in this build with its 64-bit DWORD.
+TEST_F(InputLogFile, LayoutIsTheSameOnEveryBuild) {
+    Frame first{ .FrameCount = 0, .MousePosition = { 1, -1 } };
+    Frame second = first;
+    second.FrameCount = 1;
+    second.MousePosition = { 3, -2 };
+    second.GameInput = GameInput::MOVE_RIGHT;
+    Write({ first, second });
+    const vector<BYTE> expected{
+        'T', 'X', 'I', 'L', 1, 0, 0, 0,
+        // a zeroed frame comes before the first one, so frame 0 is a frame count 1 less than expected
+        0x05, 0x01, 0x02, 0x01,
+        0x84, 0x04, 0x01, 0x40,
+    };
+    EXPECT_EQ(Content(), expected);
+}
+
+// what the header of InputLog.h says
+TEST_F(InputLogFile, FrameWhereOnlyTheCursorMovedIsSmall) {
+    Frame frame{ .FrameCount = 10, .HasPosition = true, .MousePosition = { 320, 240 }, .PlayerPositionRaw = { 192, 400 } };
+    Write({ frame });
+    auto before = Content().size();
+    auto next = frame;
+    next.FrameCount++;
+    next.MousePosition = { 321, 238 };
+    Write({ frame, next });
+    EXPECT_EQ(Content().size() - before, 3u);
+}
+
+TEST_F(InputLogFile, EmptyLog) {
+    Write({});
+    vector<Frame> read{ Frame{} };
+    ASSERT_TRUE(inputlog::Read(widePath.c_str(), read));
+    EXPECT_TRUE(read.empty());
+}
+
+TEST_F(InputLogFile, CutShortIsBadFormat) {
+    Write(RandomFrames(100));
+    auto content = Content();
+    // the last frame ends on the last byte, every shorter log ends within a frame or a header
+    for (auto size : { size_t(0), size_t(7), content.size() - 1 }) {
+        Overwrite(vector<BYTE>(content.begin(), content.begin() + size));
+        vector<Frame> read;
+        EXPECT_FALSE(inputlog::Read(widePath.c_str(), read)) << size;
+        EXPECT_EQ(GetLastError(), DWORD(ERROR_BAD_FORMAT)) << size;
+    }
+}
+
+TEST_F(InputLogFile, OtherFileIsBadFormat) {
+    Overwrite({ 'M', 'Z', 0x90, 0, 3, 0, 0, 0, 4, 0 });
+    vector<Frame> read;
+    EXPECT_FALSE(inputlog::Read(widePath.c_str(), read));
+    EXPECT_EQ(GetLastError(), DWORD(ERROR_BAD_FORMAT));
+}
+
+// A log recorded from the inputs the decision made replays to the same inputs, in each movement mode.
+TEST_F(InputLogFile, ReplayComputesTheRecordedInputs) {
+    for (auto mode : { MovementMode::Classic, MovementMode::Predictive, MovementMode::Proportional, MovementMode::Straight }) {
+        vector<Frame> frames;
+        movementcontrol::MovementState state{};
+        DoublePoint player{ 192, 400 };
+        for (DWORD i = 0; i < 600; i++) {
+            Frame frame{
+                .FrameCount = i,
+                .InputEnabled = i % 200 < 180,
+                .HasPosition = true,
+                .MousePosition = { LONG(320 + 150 * (i / 100 % 2)), LONG(240 + i % 100) },
+                .PlayerPositionRaw = player,
+                .ClientSize = { 640, 480 },
+                .AspectRatio = { 4, 3 },
+                .PixelRate = 1,
+                .PixelOffset = { 32, 16 },
+                .MovementMode = mode,
+            };
+            frame.GameInput = inputdecision::Replay(frame, state);
+            frames.push_back(frame);
+            // a game that applies the keys on the next frame
+            auto has = [&](GameInput flag) { return (frame.GameInput & flag) == flag; };
+            auto speed = has(GameInput::USE_FOCUS) ? 2.0 : 4.5;
+            player.X += speed * (int(has(GameInput::MOVE_RIGHT)) - int(has(GameInput::MOVE_LEFT)));
+            player.Y += speed * (int(has(GameInput::MOVE_DOWN)) - int(has(GameInput::MOVE_UP)));
+        }
+        Write(frames);
+        vector<Frame> read;
+        ASSERT_TRUE(inputlog::Read(widePath.c_str(), read));
+        ASSERT_EQ(read.size(), frames.size());
+        movementcontrol::MovementState replayState{};
+        auto moves = 0;
+        for (size_t i = 0; i < read.size(); i++) {
+            auto input = inputdecision::Replay(read[i], replayState);
+            EXPECT_EQ(input, frames[i].GameInput) << int(mode) << " " << i;
+            moves += input != GameInput::NONE;
+        }
+        EXPECT_GT(moves, 0) << int(mode);
+    }
+}
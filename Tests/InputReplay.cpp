@@ -0,0 +1,79 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <format>
+
+#include "DataTypes.h"
+#include "Helper.Encoding.h"
+#include "InputLog.h"
+#include "MovementControl.h"
+#include "InputDecision.h"
+
+namespace encoding = common::helper::encoding;
+namespace inputlog = common::inputlog;
+namespace inputdecision = core::inputdecision;
+namespace movementcontrol = core::movementcontrol;
+
+using namespace std;
+
+// the differing frames after that many are only counted, like ThMouseXGUI --replay
+constexpr DWORD MaxPrintedDivergences = 20;
+
+string FormatInput(GameInput input) {
+    constexpr pair<GameInput, const char*> names[]{
+        { GameInput::USE_BOMB, "USE_BOMB" }, { GameInput::USE_SPECIAL, "USE_SPECIAL" }, { GameInput::USE_FOCUS, "USE_FOCUS" },
+        { GameInput::MOVE_LEFT, "MOVE_LEFT" }, { GameInput::MOVE_RIGHT, "MOVE_RIGHT" },
+        { GameInput::MOVE_UP, "MOVE_UP" }, { GameInput::MOVE_DOWN, "MOVE_DOWN" },
+    };
+    string result;
+    for (auto& [flag, name] : names) {
+        if ((input & flag) != flag)
+            continue;
+        if (!result.empty())
+            result += '|';
+        result += name;
+    }
+    return result.empty() ? "NONE" : result;
+}
+
+// ThMouseXGUI --replay without Windows: computes the input of each frame of an input log recorded in the game again,
+// and prints the frames where it differs from the recorded one. Fails when one does, or when the log can't be read.
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fputs("Usage: input-replay <input log>\n", stderr);
+        return 2;
+    }
+    vector<inputlog::Frame> frames;
+    if (!inputlog::Read(encoding::ConvertToUtf16(argv[1]).c_str(), frames)) {
+        fprintf(stderr, "Failed to read the input log (error %lu).\n", GetLastError());
+        return 1;
+    }
+
+    movementcontrol::MovementState state{};
+    vector<GameInput> inputs(frames.size());
+    chrono::steady_clock::duration slowest{};
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < frames.size(); i++) {
+        auto frameStart = chrono::steady_clock::now();
+        inputs[i] = inputdecision::Replay(frames[i], state);
+        slowest = max(slowest, chrono::steady_clock::now() - frameStart);
+    }
+    auto elapsed = chrono::steady_clock::now() - start;
+
+    string report;
+    DWORD divergenceCount = 0;
+    for (size_t i = 0; i < frames.size(); i++) {
+        if (inputs[i] == frames[i].GameInput)
+            continue;
+        if (++divergenceCount <= MaxPrintedDivergences) {
+            report += format("; frame {} (#{}): recorded {}, replayed {}\n", i, frames[i].FrameCount,
+                FormatInput(frames[i].GameInput), FormatInput(inputs[i]));
+        }
+    }
+    auto average = frames.empty() ? 0 : chrono::duration<double, nano>(elapsed).count() / frames.size();
+    report = format("; {}: {} frames, {} differ\n; {:.0f} ns per frame on average, {:.0f} ns at most\n",
+        argv[1], frames.size(), divergenceCount, average, chrono::duration<double, nano>(slowest).count()) + report;
+    fputs(report.c_str(), stdout);
+    return divergenceCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "DataTypes.h"
+#include "MovementControl.h"
+
+namespace movementcontrol = core::movementcontrol;
+
+using namespace std;
+using movementcontrol::MovementState;
+
+using Mover = GameInput (*)(MovementState& state, DoublePoint player, DoublePoint target);
+
+bool Has(GameInput input, GameInput flag) {
+    return (input & flag) == flag;
+}
+
+// A game that moves its player by the keys pressed Delay frames ago, at full or focus speed.
+struct Game {
+    double      Speed;
+    double      FocusSpeed;
+    DWORD       Delay;
+    // whether a diagonal is as fast as a straight move, like in Touhou games, or faster
+    bool        NormalizedDiagonal;
+    DoublePoint Player{ 320, 240 };
+    GameInput   Pressed[movementcontrol::MaxLatencyFrames]{};
+
+    void Step(GameInput input) {
+        for (DWORD i = 0; i + 1 < movementcontrol::MaxLatencyFrames; i++)
+            Pressed[i] = Pressed[i + 1];
+        Pressed[Delay] = input;
+        auto applied = Pressed[0];
+        auto directionX = int(Has(applied, GameInput::MOVE_RIGHT)) - int(Has(applied, GameInput::MOVE_LEFT));
+        auto directionY = int(Has(applied, GameInput::MOVE_DOWN)) - int(Has(applied, GameInput::MOVE_UP));
+        auto speed = Has(applied, GameInput::USE_FOCUS) ? FocusSpeed : Speed;
+        if (NormalizedDiagonal && directionX != 0 && directionY != 0)
+            speed /= sqrt(2.0);
+        Player.X += directionX * speed;
+        Player.Y += directionY * speed;
+    }
+
+    // Press what the mover says for that many frames, returns the last input.
+    GameInput Run(Mover mover, MovementState& state, DoublePoint target, int frames) {
+        auto input = GameInput::NONE;
+        for (auto frame = 0; frame < frames; frame++) {
+            input = mover(state, Player, target);
+            Step(input);
+        }
+        return input;
+    }
+
+    // Move a bit and come back, so the mover knows the speed and the latency like it does in a game.
+    void WarmUp(Mover mover, MovementState& state) {
+        auto start = Player;
+        Run(mover, state, { start.X + 40, start.Y + 40 }, 40);
+        Run(mover, state, start, 40);
+    }
+};
+
+double DeviationFromLine(DoublePoint position, DoublePoint origin, DoublePoint target) {
+    auto lineX = target.X - origin.X;
+    auto lineY = target.Y - origin.Y;
+    return abs((position.X - origin.X) * lineY - (position.Y - origin.Y) * lineX) / hypot(lineX, lineY);
+}
+
+TEST(MoveClassic, PressesUntilWithinAPixel) {
+    EXPECT_EQ(movementcontrol::MoveClassic({ 100, 100 }, { 101, 99 }), GameInput::NONE);
+    EXPECT_EQ(movementcontrol::MoveClassic({ 100, 100 }, { 110, 100 }), GameInput::MOVE_RIGHT);
+    EXPECT_EQ(movementcontrol::MoveClassic({ 100, 100 }, { 90, 90 }), GameInput::MOVE_LEFT | GameInput::MOVE_UP);
+}
+
+// Classic keeps pressing until the late keys take it past the cursor, and it never comes to rest.
+TEST(MoveClassic, OscillatesWhenKeysAreLate) {
+    Game game{ .Speed = 4.5, .FocusSpeed = 2, .Delay = 2 };
+    auto target = DoublePoint{ game.Player.X + 100, game.Player.Y };
+    auto classic = [](MovementState&, DoublePoint player, DoublePoint target) {
+        return movementcontrol::MoveClassic({ lrint(player.X), lrint(player.Y) }, { lrint(target.X), lrint(target.Y) });
+    };
+    MovementState state{};
+    game.Run(classic, state, target, 100);
+    auto pressedFrames = 0;
+    for (auto frame = 0; frame < 20; frame++)
+        pressedFrames += game.Run(classic, state, target, 1) != GameInput::NONE;
+    EXPECT_GT(pressedFrames, 10);
+}
+
+TEST(MovePredictive, LearnsTheSpeedAndTheLatency) {
+    for (DWORD delay : { 0, 1, 3 }) {
+        Game game{ .Speed = 4.5, .FocusSpeed = 2, .Delay = delay };
+        MovementState state{};
+        game.WarmUp(movementcontrol::MovePredictive, state);
+        EXPECT_EQ(state.Latency, delay);
+        EXPECT_DOUBLE_EQ(state.Step.X, 4.5);
+        EXPECT_DOUBLE_EQ(state.Step.Y, 4.5);
+    }
+}
+
+TEST(MovePredictive, ComesToRestWithinHalfAStep) {
+    for (DWORD delay : { 0, 1, 3 }) {
+        Game game{ .Speed = 9, .FocusSpeed = 4, .Delay = delay };
+        MovementState state{};
+        game.WarmUp(movementcontrol::MovePredictive, state);
+        DoublePoint target{ game.Player.X + 123, game.Player.Y - 77 };
+        game.Run(movementcontrol::MovePredictive, state, target, 60);
+        auto rest = game.Player;
+        EXPECT_EQ(game.Run(movementcontrol::MovePredictive, state, target, 10), GameInput::NONE) << delay;
+        EXPECT_EQ(game.Player.X, rest.X) << delay;
+        EXPECT_EQ(game.Player.Y, rest.Y) << delay;
+        EXPECT_LE(abs(target.X - rest.X), 9 / 2.0) << delay;
+        EXPECT_LE(abs(target.Y - rest.Y), 9 / 2.0) << delay;
+    }
+}
+
+TEST(MovePredictive, ResetKeepsTheLatency) {
+    Game game{ .Speed = 4.5, .FocusSpeed = 2, .Delay = 2 };
+    MovementState state{};
+    game.WarmUp(movementcontrol::MovePredictive, state);
+    movementcontrol::Reset(state);
+    EXPECT_EQ(state.Latency, 2u);
+    EXPECT_FALSE(state.HasLastPosition);
+    EXPECT_EQ(state.Step.X, 0);
+}
+
+// a respawn moves the player further than it can go in a frame, that isn't a speed to learn
+TEST(MovePredictive, JumpIsNotMovement) {
+    Game game{ .Speed = 4.5, .FocusSpeed = 2, .Delay = 1 };
+    MovementState state{};
+    game.WarmUp(movementcontrol::MovePredictive, state);
+    movementcontrol::MovePredictive(state, { game.Player.X + 200, game.Player.Y }, game.Player);
+    EXPECT_EQ(state.Step.X, 0);
+    EXPECT_EQ(state.Latency, 1u);
+}
+
+// far from the cursor at full speed, the last few pixels at focus speed
+TEST(MoveProportional, HoldsFocusCloseToTheCursor) {
+    Game game{ .Speed = 9, .FocusSpeed = 4, .Delay = 1 };
+    MovementState state{};
+    game.WarmUp(movementcontrol::MoveProportional, state);
+    // 11 full steps and a focus step
+    DoublePoint target{ game.Player.X + 103, game.Player.Y };
+    auto first = game.Run(movementcontrol::MoveProportional, state, target, 1);
+    EXPECT_EQ(first, GameInput::MOVE_RIGHT);
+    auto focusFrames = 0;
+    for (auto frame = 0; frame < 40; frame++) {
+        auto input = game.Run(movementcontrol::MoveProportional, state, target, 1);
+        focusFrames += Has(input, GameInput::MOVE_RIGHT | GameInput::USE_FOCUS);
+    }
+    EXPECT_GT(focusFrames, 0);
+    EXPECT_LE(abs(target.X - game.Player.X), 4 / 2.0);
+}
+
+// Slower than the focus speed, the keys are pressed on some frames only, and on average the player keeps up.
+TEST(MoveProportional, FollowsASlowCursorAtItsSpeed) {
+    Game game{ .Speed = 4.5, .FocusSpeed = 2, .Delay = 1 };
+    MovementState state{};
+    game.WarmUp(movementcontrol::MoveProportional, state);
+    DoublePoint cursor = game.Player;
+    auto pressedFrames = 0;
+    auto maxLag = 0.0;
+    for (auto frame = 0; frame < 200; frame++) {
+        cursor.X += 0.5;
+        auto input = game.Run(movementcontrol::MoveProportional, state, cursor, 1);
+        if (frame >= 100) {
+            pressedFrames += input != GameInput::NONE;
+            maxLag = max(maxLag, abs(cursor.X - game.Player.X));
+        }
+    }
+    // a quarter of the frames at 2 px each
+    EXPECT_NEAR(pressedFrames, 25, 3);
+    EXPECT_LE(maxLag, 4);
+    EXPECT_EQ(game.Player.Y, 240);
+}
+
+TEST(MoveProportional, ComesToRestWithinHalfAFocusStep) {
+    Game game{ .Speed = 9, .FocusSpeed = 4, .Delay = 3, .NormalizedDiagonal = true };
+    MovementState state{};
+    game.WarmUp(movementcontrol::MoveProportional, state);
+    DoublePoint target{ game.Player.X - 97, game.Player.Y + 151 };
+    game.Run(movementcontrol::MoveProportional, state, target, 80);
+    auto rest = game.Player;
+    EXPECT_EQ(game.Run(movementcontrol::MoveProportional, state, target, 10), GameInput::NONE);
+    EXPECT_EQ(game.Player.X, rest.X);
+    EXPECT_EQ(game.Player.Y, rest.Y);
+    EXPECT_LE(hypot(target.X - rest.X, target.Y - rest.Y), 4 / 2.0 * sqrt(2.0));
+}
+
+TEST(MoveStraight, HorizontalTargetWithoutAVerticalPress) {
+    Game game{ .Speed = 4.5, .FocusSpeed = 2, .Delay = 0 };
+    MovementState state{};
+    game.WarmUp(movementcontrol::MoveStraight, state);
+    DoublePoint target{ game.Player.X + 150, game.Player.Y + 1 };
+    for (auto frame = 0; frame < 60; frame++) {
+        auto input = game.Run(movementcontrol::MoveStraight, state, target, 1);
+        EXPECT_FALSE(Has(input, GameInput::MOVE_UP) || Has(input, GameInput::MOVE_DOWN)) << frame;
+    }
+    EXPECT_LE(abs(target.X - game.Player.X), 4.5 / 2);
+}
+
+// Predictive goes diagonally until one axis is done, Straight stays within a step of the line.
+TEST(MoveStraight, FollowsTheLine) {
+    for (auto mover : { movementcontrol::MovePredictive, movementcontrol::MoveStraight }) {
+        Game game{ .Speed = 2, .FocusSpeed = 1, .Delay = 0 };
+        MovementState state{};
+        game.WarmUp(mover, state);
+        auto origin = game.Player;
+        DoublePoint target{ origin.X + 120, origin.Y + 60 };
+        auto maxDeviation = 0.0;
+        for (auto frame = 0; frame < 100; frame++) {
+            game.Run(mover, state, target, 1);
+            maxDeviation = max(maxDeviation, DeviationFromLine(game.Player, origin, target));
+        }
+        EXPECT_LE(hypot(target.X - game.Player.X, target.Y - game.Player.Y), 2 / 2.0 * sqrt(2.0));
+        if (mover == movementcontrol::MoveStraight)
+            EXPECT_LE(maxDeviation, 2);
+        else
+            EXPECT_GT(maxDeviation, 20);
+    }
+}
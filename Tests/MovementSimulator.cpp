@@ -0,0 +1,154 @@
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <format>
+
+#include "DataTypes.h"
+#include "MovementControl.h"
+
+namespace movementcontrol = core::movementcontrol;
+
+using namespace std;
+
+constexpr DWORD TrialCount = 200;
+constexpr DWORD TrialFrames = 400;
+// a player that stays close to the target for that many frames at the end of a trial has settled
+constexpr DWORD SettledFrames = 30;
+// frames of moving to a point nearby before a trial, so the modes know the speed and the delay like in a game
+constexpr DWORD WarmUpFrames = 60;
+
+// The player of a Touhou game: full or focused speed, diagonals as fast as straight moves,
+// and the keys applied some frames after they're pressed.
+struct SimulatedGame {
+    double  Speed;
+    DWORD   Delay;
+};
+
+struct SimulatedPlayer {
+    DoublePoint Position;
+    // the keys pressed but not applied yet, the oldest at Pressed[0]
+    GameInput   Pressed[movementcontrol::MaxLatencyFrames];
+};
+
+struct TrialResult {
+    bool    Settled;
+    // from the first frame to the one after which the player stayed close to the target
+    DWORD   SettleFrames;
+    // how far the player went past the target, along the line from where it started
+    double  Overshoot;
+};
+
+// A linear congruential generator, so the targets don't depend on the C runtime.
+DWORD NextRandom(DWORD& seed) {
+    seed = seed * 1664525 + 1013904223;
+    return seed >> 8;
+}
+
+bool Has(GameInput input, GameInput flag) {
+    return (input & flag) == flag;
+}
+
+void Step(const SimulatedGame& game, SimulatedPlayer& player, GameInput input) {
+    for (DWORD i = 0; i + 1 < movementcontrol::MaxLatencyFrames; i++)
+        player.Pressed[i] = player.Pressed[i + 1];
+    player.Pressed[game.Delay] = input;
+    auto applied = player.Pressed[0];
+    auto directionX = int(Has(applied, GameInput::MOVE_RIGHT)) - int(Has(applied, GameInput::MOVE_LEFT));
+    auto directionY = int(Has(applied, GameInput::MOVE_DOWN)) - int(Has(applied, GameInput::MOVE_UP));
+    auto speed = Has(applied, GameInput::USE_FOCUS) ? game.Speed / 2 : game.Speed;
+    if (directionX != 0 && directionY != 0)
+        speed /= sqrt(2.0);
+    player.Position.X += directionX * speed;
+    player.Position.Y += directionY * speed;
+}
+
+GameInput Decide(MovementMode mode, movementcontrol::MovementState& state, DoublePoint player, DoublePoint target) {
+    switch (mode) {
+        case MovementMode::Predictive: return movementcontrol::MovePredictive(state, player, target);
+        case MovementMode::Proportional: return movementcontrol::MoveProportional(state, player, target);
+        case MovementMode::Straight: return movementcontrol::MoveStraight(state, player, target);
+        default: return movementcontrol::MoveClassic({ lrint(player.X), lrint(player.Y) }, { lrint(target.X), lrint(target.Y) });
+    }
+}
+
+TrialResult RunTrial(MovementMode mode, const SimulatedGame& game, DoublePoint target) {
+    movementcontrol::MovementState state{};
+    SimulatedPlayer player{ .Position = { 320, 240 } };
+    DoublePoint warmUpTarget{ player.Position.X + 40, player.Position.Y };
+    for (DWORD frame = 0; frame < WarmUpFrames; frame++)
+        Step(game, player, Decide(mode, state, player.Position, warmUpTarget));
+
+    auto start = player.Position;
+    target = { start.X + target.X, start.Y + target.Y };
+    auto distance = hypot(target.X - start.X, target.Y - start.Y);
+    DoublePoint direction{ (target.X - start.X) / distance, (target.Y - start.Y) / distance };
+    auto reach = game.Speed / 2 > 1.5 ? game.Speed / 2 : 1.5;
+    TrialResult result{};
+    for (DWORD frame = 0; frame < TrialFrames; frame++) {
+        Step(game, player, Decide(mode, state, player.Position, target));
+        auto errorX = player.Position.X - target.X;
+        auto errorY = player.Position.Y - target.Y;
+        auto past = errorX * direction.X + errorY * direction.Y;
+        if (past > result.Overshoot)
+            result.Overshoot = past;
+        if (abs(errorX) > reach || abs(errorY) > reach)
+            result.SettleFrames = frame + 1;
+    }
+    result.Settled = result.SettleFrames + SettledFrames <= TrialFrames;
+    return result;
+}
+
+const char* NameOf(MovementMode mode) {
+    switch (mode) {
+        case MovementMode::Predictive: return "Predictive";
+        case MovementMode::Proportional: return "Proportional";
+        case MovementMode::Straight: return "Straight";
+        default: return "Classic";
+    }
+}
+
+/*
+Move a simulated player toward random targets with each movement mode, for several game speeds and key delays,
+and print how long it took to settle and how far it overshot. The targets are the same on every run.
+Fails when a trial of a mode other than Classic didn't settle, so it also runs as a test.
+*/
+int main() {
+    constexpr SimulatedGame games[]{
+        { 2, 0 }, { 2, 1 }, { 2, 3 },
+        { 4.5, 0 }, { 4.5, 1 }, { 4.5, 3 },
+        { 9, 0 }, { 9, 1 }, { 9, 3 },
+    };
+    constexpr MovementMode modes[]{
+        MovementMode::Classic, MovementMode::Predictive, MovementMode::Proportional, MovementMode::Straight,
+    };
+    auto allSettled = true;
+    string report = format("; {} targets 60 to 260 px away per case, settled = within max(1.5, speed / 2) px for the last {} of {} frames\n",
+        TrialCount, SettledFrames, TrialFrames);
+    report += "; speed  delay  mode          settled  frames to settle  overshoot mean / max\n";
+    for (auto& game : games) {
+        for (auto mode : modes) {
+            DWORD seed = 1;
+            DWORD settledCount = 0;
+            double settleFrames = 0, overshoot = 0, maxOvershoot = 0;
+            for (DWORD trial = 0; trial < TrialCount; trial++) {
+                auto angle = NextRandom(seed) % 3600 / 3600.0 * 2 * 3.14159265358979323846;
+                auto radius = 60.0 + NextRandom(seed) % 200;
+                auto result = RunTrial(mode, game, { radius * cos(angle), radius * sin(angle) });
+                if (result.Settled) {
+                    settledCount++;
+                    settleFrames += result.SettleFrames;
+                }
+                overshoot += result.Overshoot;
+                if (result.Overshoot > maxOvershoot)
+                    maxOvershoot = result.Overshoot;
+            }
+            if (mode != MovementMode::Classic && settledCount < TrialCount)
+                allSettled = false;
+            report += format("{:7.1f}  {:5}  {:<12}  {:3}/{:3}  {:16.1f}  {:9.1f} / {:.1f} px\n",
+                game.Speed, game.Delay, NameOf(mode), settledCount, TrialCount,
+                settledCount > 0 ? settleFrames / settledCount : 0, overshoot / TrialCount, maxOvershoot);
+        }
+    }
+    fputs(report.c_str(), stdout);
+    return allSettled ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+#include <cstring>
+#include <format>
+#include <memory>
+#include <vector>
+
+#include "Benchmark.h"
+#include "DataTypes.h"
+#include "Variables.h"
+#include "Helper.Memory.h"
+#include "PointerPath.h"
+
+namespace pointerpath = common::pointerpath;
+namespace memory = common::helper::memory;
+
+using namespace std;
+
+constexpr DWORD Ptr = sizeof(DWORD);
+constexpr DWORD CountOffset = 0x23D5624;
+constexpr DWORD PoolOffset = 0x23D561C;
+constexpr DWORD SlotCount = 300;
+constexpr DWORD PlayerSlot = 250;
+
+// the Danmakai expression written out in C++, with the same checked reads
+DWORD FindPlayer() {
+    auto module = DWORD(g_targetModule);
+    DWORD count, pool, object, type;
+    if (!memory::TryReadDword(module + CountOffset, count) || count == 0)
+        return 0;
+    for (DWORD i = 0; i < count; i++) {
+        if (!memory::TryReadDword(module + PoolOffset, pool) || pool == 0)
+            continue;
+        if (!memory::TryReadDword(pool + i * Ptr, object) || object == 0)
+            continue;
+        if (!memory::TryReadDword(object + 0x7C, type) || type == 0)
+            continue;
+        if (type == 0x116 || type == 0x117 || type == 0x118 || type == 0x119)
+            return object + 0xB4;
+    }
+    return 0;
+}
+
+// The expression of Danmakai in Games.txt, on a pool of 300 objects whose player is near the end.
+// Its pool steps are as wide as a pointer of the shim, the offsets are the real ones, so the module offsets stay wide constants.
+int main(int argc, char** argv) {
+    benchmark::ParseArguments(argc, argv);
+    auto module = make_unique<DWORD[]>(CountOffset / Ptr + 2);
+    vector<DWORD> objects(SlotCount * 0x100 / Ptr);
+    vector<DWORD> pool(SlotCount);
+    g_targetModule = HMODULE(module.get());
+    // the offsets aren't aligned to a DWORD of the shim
+    DWORD count = SlotCount;
+    auto poolAddress = DWORD(pool.data());
+    memcpy((char*)module.get() + CountOffset, &count, sizeof(count));
+    memcpy((char*)module.get() + PoolOffset, &poolAddress, sizeof(poolAddress));
+    for (DWORD slot = 0; slot < SlotCount; slot++) {
+        pool[slot] = DWORD(&objects[slot * 0x100 / Ptr]);
+        DWORD type = slot == PlayerSlot ? 0x118 : 0x5;
+        memcpy((void*)(pool[slot] + 0x7C), &type, sizeof(type));
+    }
+
+    PointerPath path;
+    auto source = format("first([module+23D5624], in([[[module+23D561C]+i*{0:X}]+7C], 116, 117, 118, 119) ? [[module+23D561C]+i*{0:X}]+B4 : 0)", Ptr);
+    auto [message, location] = pointerpath::Compile(source, path);
+    if (message != nullptr || pointerpath::Run(path) != FindPlayer() || FindPlayer() == 0)
+        return 1;
+
+    benchmark::Measure("PointerPath/RememberedSlot", 1, "run", [&] {
+        benchmark::DoNotOptimize(pointerpath::Run(path));
+    });
+    benchmark::Measure("PointerPath/FullScan", PlayerSlot + 1, "slot", [&] {
+        pointerpath::ResetLastHit();
+        benchmark::DoNotOptimize(pointerpath::Run(path));
+    });
+    benchmark::Measure("Native/FullScan", PlayerSlot + 1, "slot", [&] {
+        benchmark::DoNotOptimize(FindPlayer());
+    });
+    return 0;
+}
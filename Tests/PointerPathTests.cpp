@@ -0,0 +1,445 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Variables.h"
+#include "PointerPath.h"
+
+namespace pointerpath = common::pointerpath;
+
+using namespace std;
+
+// A DWORD of the shim is as wide as a pointer, so the expressions step through pointers with this.
+constexpr DWORD Ptr = sizeof(DWORD);
+
+// A game module with its memory zeroed, for the expressions to read through "module".
+class FakeModule {
+public:
+    explicit FakeModule(size_t size) : memory(new DWORD[(size + Ptr - 1) / Ptr]()) {
+        g_targetModule = HMODULE(memory.get());
+    }
+    ~FakeModule() {
+        g_targetModule = NULL;
+    }
+    DWORD Base() const {
+        return DWORD(memory.get());
+    }
+    // the offsets of a game needn't be aligned to a DWORD of the shim
+    void Set(DWORD offset, DWORD value) {
+        memcpy((char*)memory.get() + offset, &value, sizeof(value));
+    }
+private:
+    unique_ptr<DWORD[]> memory;
+};
+
+DWORD CompileAndRun(const string& source) {
+    PointerPath path;
+    auto [message, location] = pointerpath::Compile(source, path);
+    EXPECT_EQ(message, nullptr) << source << ": " << message << " at \"" << location << '"';
+    return pointerpath::Run(path);
+}
+
+struct CompileError {
+    const char* Source;
+    const char* Message;
+    const char* Location;
+};
+
+TEST(PointerPath, CompileErrorsPointAtTheirSource) {
+    const CompileError errors[]{
+        { "[module + 10", "expected ']'", "" },
+        { "module +", "expected a value", "" },
+        { "i", "'i' can only be used inside first()", "i" },
+        { "first(2, first(2, i))", "only one first() is supported", "first" },
+        { "first(2 i)", "expected ','", "i" },
+        { "in(module)", "expected ','", ")" },
+        { "1 ? 2", "expected ':'", "" },
+        { "module 5", "unexpected character", "5" },
+        { "xyz", "invalid format", "xyz" },
+    };
+    for (auto& error : errors) {
+        PointerPath path;
+        auto [message, location] = pointerpath::Compile(error.Source, path);
+        if (message == nullptr) {
+            ADD_FAILURE() << error.Source << ": compiled";
+            continue;
+        }
+        EXPECT_STREQ(message, error.Message) << error.Source;
+        EXPECT_EQ(location, error.Location) << error.Source;
+        EXPECT_EQ(path.Length, 0) << error.Source;
+    }
+}
+
+TEST(PointerPath, SizeIsLimited) {
+    auto source = string(POINTER_PATH_MAX_LEN, '[') + "module" + string(POINTER_PATH_MAX_LEN, ']');
+    PointerPath path;
+    auto [message, location] = pointerpath::Compile(source, path);
+    EXPECT_STREQ(message, "expression is too long");
+}
+
+TEST(PointerPath, DepthIsLimited) {
+    string source = "1";
+    for (int i = 0; i < 20; i++)
+        source = "(1 + " + source + ")";
+    PointerPath path;
+    auto [message, location] = pointerpath::Compile(source, path);
+    EXPECT_STREQ(message, "expression is nested too deeply");
+}
+
+TEST(PointerPath, Arithmetic) {
+    FakeModule module(0x100);
+    EXPECT_EQ(CompileAndRun("1 + 2 * 3"), 7u);
+    EXPECT_EQ(CompileAndRun("(1 + 2) * 3"), 9u);
+    EXPECT_EQ(CompileAndRun("10 - 1 - 1"), 0xEu);
+    EXPECT_EQ(CompileAndRun("module + 10"), module.Base() + 0x10);
+    EXPECT_EQ(CompileAndRun("FFFFFFFF + 2"), DWORD(0xFFFFFFFF) + 2);
+    EXPECT_EQ(CompileAndRun("2 < 3"), 1u);
+    EXPECT_EQ(CompileAndRun("3 < 2"), 0u);
+    EXPECT_EQ(CompileAndRun("3 == 3 ? 5 : 6"), 5u);
+    EXPECT_EQ(CompileAndRun("3 != 3 ? 5 : 1 ? 7 : 8"), 7u);
+    EXPECT_EQ(CompileAndRun("in(5, 1, 5)"), 1u);
+    EXPECT_EQ(CompileAndRun("in(5, 1, 2)"), 0u);
+}
+
+TEST(PointerPath, PointerChain) {
+    FakeModule module(0x1000);
+    module.Set(0x100, module.Base() + 0x200);
+    module.Set(0x200 + 2 * Ptr, 0x1234);
+    EXPECT_EQ(CompileAndRun(format("[[module + 100] + {:X}]", 2 * Ptr)), 0x1234u);
+    // the same as an offset that doesn't fit in an instruction
+    module.Set(0x100, module.Base() + 0x200 - 0x1000000);
+    EXPECT_EQ(CompileAndRun(format("[[module + 100] + {:X}]", 0x1000000 + 2 * Ptr)), 0x1234u);
+}
+
+TEST(PointerPath, NullPointerOutsideFirstGivesZero) {
+    FakeModule module(0x1000);
+    EXPECT_EQ(CompileAndRun("[[module + 100] + 8] + 1"), 0u);
+    // unreadable is the same as null
+    EXPECT_EQ(CompileAndRun("[10] + 1"), 0u);
+}
+
+// the shape of a player object found in a pool by its type
+class Pool : public testing::Test {
+protected:
+    static constexpr DWORD SlotCount = 6;
+    static constexpr DWORD CountOffset = 0x100;
+    static constexpr DWORD PoolOffset = 0x200;
+    static constexpr DWORD ObjectsOffset = 0x400;
+    static constexpr DWORD ObjectSize = 0x40;
+    static constexpr DWORD TypeOffset = 0x10;
+    static constexpr DWORD PositionOffset = 0x20;
+    FakeModule module{ 0x1000 };
+    PointerPath path;
+
+    void SetUp() override {
+        module.Set(CountOffset, SlotCount);
+        for (DWORD slot = 0; slot < SlotCount; slot++) {
+            module.Set(PoolOffset + slot * Ptr, module.Base() + ObjectsOffset + slot * ObjectSize);
+            SetType(slot, 1);
+        }
+        auto [message, location] = pointerpath::Compile(format("first([module + {:X}], [[module + {:X} + i * {:X}] + {:X}] == 7 ? [module + {:X} + i * {:X}] + {:X} : 0)",
+            CountOffset, PoolOffset, Ptr, TypeOffset, PoolOffset, Ptr, PositionOffset), path);
+        ASSERT_EQ(message, nullptr) << message;
+    }
+
+    void SetType(DWORD slot, DWORD type) {
+        module.Set(ObjectsOffset + slot * ObjectSize + TypeOffset, type);
+    }
+
+    DWORD PositionOf(DWORD slot) {
+        return module.Base() + ObjectsOffset + slot * ObjectSize + PositionOffset;
+    }
+};
+
+TEST_F(Pool, FindsTheFirstMatchingSlot) {
+    SetType(3, 7);
+    SetType(5, 7);
+    EXPECT_EQ(pointerpath::Run(path), PositionOf(3));
+}
+
+TEST_F(Pool, NoMatchGivesZero) {
+    EXPECT_EQ(pointerpath::Run(path), 0u);
+}
+
+TEST_F(Pool, NullSlotsAreSkipped) {
+    module.Set(PoolOffset + 1 * Ptr, 0);
+    module.Set(PoolOffset + 2 * Ptr, 0x10);
+    SetType(4, 7);
+    EXPECT_EQ(pointerpath::Run(path), PositionOf(4));
+}
+
+TEST_F(Pool, RemembersTheSlotItFound) {
+    SetType(2, 7);
+    SetType(4, 7);
+    // found by scanning from the start, then slot 2 stops matching, and the scan finds 4
+    EXPECT_EQ(pointerpath::Run(path), PositionOf(2));
+    SetType(2, 1);
+    EXPECT_EQ(pointerpath::Run(path), PositionOf(4));
+    // now 4 is tried first, even though 2 matches again
+    SetType(2, 7);
+    EXPECT_EQ(pointerpath::Run(path), PositionOf(4));
+    // a new path, or a reload, forgets it
+    pointerpath::ResetLastHit();
+    EXPECT_EQ(pointerpath::Run(path), PositionOf(2));
+}
+
+TEST_F(Pool, RememberedSlotBeyondTheCountIsIgnored) {
+    SetType(4, 7);
+    EXPECT_EQ(pointerpath::Run(path), PositionOf(4));
+    module.Set(CountOffset, 3);
+    EXPECT_EQ(pointerpath::Run(path), 0u);
+    module.Set(CountOffset, 0);
+    EXPECT_EQ(pointerpath::Run(path), 0u);
+}
+
+TEST_F(Pool, NullCountGivesZero) {
+    SetType(0, 7);
+    module.Set(CountOffset, 0);
+    EXPECT_EQ(pointerpath::Run(path), 0u);
+}
+
+/*
+Random expressions against a reference evaluator of the same language. Every read goes to the heap, whose slots hold
+0, pointers to other slots, or small numbers that are unreadable addresses, so the reference knows what each read gives.
+Each expression is run twice, the second run starts first() from the index the first run found.
+*/
+class RandomExpression {
+public:
+    static constexpr int HeapSlots = 128;
+    // the slots that can be pointed to or read at an offset from "module", the rest keeps every offset in the heap
+    static constexpr int LiveSlots = 64;
+    static constexpr int MaxOffsetSlots = 31;
+    static constexpr int MaxLoopCount = 8;
+
+    explicit RandomExpression(mt19937& random) : random(random) {}
+
+    // the source, and the result or nullopt when a null read ends the whole expression
+    struct Result {
+        string Source;
+        optional<DWORD> Value;
+    };
+
+    void FillHeap(DWORD* heap) {
+        this->heap = heap;
+        for (int slot = 0; slot < HeapSlots; slot++) {
+            auto kind = Uniform(0, 99);
+            if (slot >= LiveSlots || kind < 25)
+                heap[slot] = 0;
+            else if (kind < 70)
+                heap[slot] = DWORD(&heap[Uniform(0, LiveSlots - 1)]);
+            else
+                heap[slot] = Uniform(1, 0xFFF);
+        }
+    }
+
+    Result Make() {
+        hasLoop = false;
+        inLoop = false;
+        auto node = MakeValue(4);
+        return { node.Source, node.Evaluate() };
+    }
+
+private:
+    mt19937& random;
+    DWORD* heap;
+    bool hasLoop;
+    bool inLoop;
+    DWORD loopIndex;
+
+    DWORD Uniform(DWORD low, DWORD high) {
+        return uniform_int_distribution<DWORD>(low, high)(random);
+    }
+
+    // Each node is made with a function that evaluates it, so the tree doesn't need to be stored.
+    struct Node {
+        string Source;
+        function<optional<DWORD>()> Evaluate;
+    };
+
+    optional<DWORD> Read(DWORD address) {
+        auto heapBase = DWORD(heap);
+        if (address >= heapBase && address <= heapBase + (HeapSlots - 1) * Ptr) {
+            DWORD value;
+            memcpy(&value, (void*)address, sizeof(value));
+            if (value != 0)
+                return value;
+            return nullopt;
+        }
+        EXPECT_LT(address, 0x10000u) << "a read outside of the heap";
+        return nullopt;
+    }
+
+    Node Deref(Node address) {
+        return { "[" + address.Source + "]", [this, evaluate = address.Evaluate]() -> optional<DWORD> {
+            auto value = evaluate();
+            return value ? Read(*value) : nullopt;
+        } };
+    }
+
+    Node Binary(Node left, const char* op, Node right, DWORD (*apply)(DWORD, DWORD)) {
+        return { "(" + left.Source + " " + op + " " + right.Source + ")", [=]() -> optional<DWORD> {
+            auto leftValue = left.Evaluate();
+            if (!leftValue)
+                return nullopt;
+            auto rightValue = right.Evaluate();
+            if (!rightValue)
+                return nullopt;
+            return apply(*leftValue, *rightValue);
+        } };
+    }
+
+    Node Select(Node condition, Node then, Node otherwise) {
+        return { "(" + condition.Source + " ? " + then.Source + " : " + otherwise.Source + ")", [=]() -> optional<DWORD> {
+            auto conditionValue = condition.Evaluate();
+            if (!conditionValue)
+                return nullopt;
+            return *conditionValue != 0 ? then.Evaluate() : otherwise.Evaluate();
+        } };
+    }
+
+    Node Constant(DWORD value) {
+        return { format("{:X}", value), [=]() -> optional<DWORD> { return value; } };
+    }
+
+    Node Module() {
+        return { "module", [this]() -> optional<DWORD> { return DWORD(heap); } };
+    }
+
+    Node Index() {
+        return { "i", [this]() -> optional<DWORD> { return loopIndex; } };
+    }
+
+    Node Offset() {
+        return Constant(Uniform(0, MaxOffsetSlots) * Ptr);
+    }
+
+    // an expression whose value is read, so it stays in the heap or in the unreadable low addresses
+    Node Address(int depth) {
+        auto kind = Uniform(0, depth > 0 ? 4 : 1);
+        switch (kind) {
+            case 0:
+                return Binary(Module(), "+", Constant(Uniform(0, LiveSlots - 1) * Ptr), [](DWORD x, DWORD y) { return x + y; });
+            case 1:
+                if (inLoop)
+                    return Binary(Module(), "+", Binary(Index(), "*", Constant(Ptr), [](DWORD x, DWORD y) { return x * y; }), [](DWORD x, DWORD y) { return x + y; });
+                return Module();
+            case 2:
+                return Binary(Deref(Address(depth - 1)), "+", Offset(), [](DWORD x, DWORD y) { return x + y; });
+            case 3:
+                if (inLoop)
+                    return Binary(Deref(Address(depth - 1)), "+", Binary(Index(), "*", Constant(Ptr), [](DWORD x, DWORD y) { return x * y; }), [](DWORD x, DWORD y) { return x + y; });
+                return Deref(Address(depth - 1));
+            default:
+                return Select(MakeValue(depth - 1), Address(depth - 1), Address(depth - 1));
+        }
+    }
+
+    Node MakeValue(int depth) {
+        auto kind = Uniform(0, depth > 0 ? 12 : 4);
+        switch (kind) {
+            case 0: return Constant(Uniform(0, 0x1FF));
+            case 1: return Constant(Uniform(0x1000000, 0xFFFFFFFF));
+            case 2: return Module();
+            case 3: return inLoop ? Index() : Constant(Uniform(0, 3));
+            case 4: return Deref(Address(depth));
+            case 5: return Binary(MakeValue(depth - 1), "+", MakeValue(depth - 1), [](DWORD x, DWORD y) { return x + y; });
+            case 6: return Binary(MakeValue(depth - 1), "-", MakeValue(depth - 1), [](DWORD x, DWORD y) { return x - y; });
+            case 7: return Binary(MakeValue(depth - 1), "*", MakeValue(depth - 1), [](DWORD x, DWORD y) { return x * y; });
+            case 8: return Binary(MakeValue(depth - 1), "==", MakeValue(depth - 1), [](DWORD x, DWORD y) { return DWORD(x == y); });
+            case 9: return Binary(MakeValue(depth - 1), "!=", MakeValue(depth - 1), [](DWORD x, DWORD y) { return DWORD(x != y); });
+            case 10: return Binary(MakeValue(depth - 1), "<", MakeValue(depth - 1), [](DWORD x, DWORD y) { return DWORD(x < y); });
+            case 11: return Select(MakeValue(depth - 1), MakeValue(depth - 1), MakeValue(depth - 1));
+            default: return hasLoop || inLoop ? In(depth) : First(depth);
+        }
+    }
+
+    Node In(int depth) {
+        auto value = MakeValue(depth - 1);
+        vector<DWORD> constants;
+        auto source = "in(" + value.Source;
+        for (auto count = Uniform(1, 4); count > 0; count--) {
+            // small ones, so they sometimes match
+            constants.push_back(Uniform(0, 3));
+            source += format(", {:X}", constants.back());
+        }
+        return { source + ")", [=]() -> optional<DWORD> {
+            auto x = value.Evaluate();
+            if (!x)
+                return nullopt;
+            return DWORD(find(constants.begin(), constants.end(), *x) != constants.end());
+        } };
+    }
+
+    Node First(int depth) {
+        hasLoop = true;
+        auto count = Uniform(0, MaxLoopCount);
+        inLoop = true;
+        auto body = MakeValue(depth - 1);
+        inLoop = false;
+        return { format("first({:X}, {})", count, body.Source), [this, count, body]() -> optional<DWORD> {
+            for (loopIndex = 0; loopIndex < count; loopIndex++) {
+                // a null read only ends the current iteration
+                auto result = body.Evaluate();
+                if (result && *result != 0)
+                    return result;
+            }
+            return 0;
+        } };
+    }
+};
+
+TEST(PointerPath, MatchesAReferenceEvaluator) {
+    mt19937 random(20240611);
+    RandomExpression generator(random);
+    vector<DWORD> heap(RandomExpression::HeapSlots);
+    g_targetModule = HMODULE(heap.data());
+    auto checked = 0;
+    auto nullResults = 0;
+    for (auto attempt = 0; attempt < 20000 && checked < 3000; attempt++) {
+        if (attempt % 100 == 0)
+            generator.FillHeap(heap.data());
+        auto expression = generator.Make();
+        PointerPath path;
+        auto [message, location] = pointerpath::Compile(expression.Source, path);
+        if (message != nullptr) {
+            // the generator isn't bound by the size limits, everything else must compile
+            if (strcmp(message, "expression is too long") != 0 && strcmp(message, "expression is nested too deeply") != 0)
+                ADD_FAILURE() << expression.Source << ": " << message << " at \"" << location << '"';
+            continue;
+        }
+        nullResults += !expression.Value;
+        auto expected = expression.Value.value_or(0);
+        ASSERT_EQ(pointerpath::Run(path), expected) << expression.Source;
+        ASSERT_EQ(pointerpath::Run(path), expected) << expression.Source << " (second run)";
+        checked++;
+    }
+    g_targetModule = NULL;
+    EXPECT_EQ(checked, 3000);
+    // both the null reads and the rest are well covered
+    EXPECT_GT(nullResults, 300);
+    EXPECT_LT(nullResults, 2700);
+}
+
+// the expression of Danmakai in Games.txt, with its pool steps made as wide as a pointer of the shim
+TEST(PointerPath, DanmakaiPool) {
+    FakeModule module(0x23D5630);
+    vector<DWORD> objects(300 * 0x100 / Ptr);
+    auto pool = vector<DWORD>(300);
+    module.Set(0x23D5624, pool.size());
+    module.Set(0x23D561C, DWORD(pool.data()));
+    for (size_t slot = 0; slot < pool.size(); slot++) {
+        auto object = DWORD(&objects[slot * 0x100 / Ptr]);
+        pool[slot] = object;
+        DWORD type = slot == 250 ? 0x118 : 0x5;
+        memcpy((void*)(object + 0x7C), &type, sizeof(type));
+    }
+    auto source = format("first([module+23D5624], in([[[module+23D561C]+i*{0:X}]+7C], 116, 117, 118, 119) ? [[module+23D561C]+i*{0:X}]+B4 : 0)", Ptr);
+    EXPECT_EQ(CompileAndRun(source), pool[250] + 0xB4);
+}
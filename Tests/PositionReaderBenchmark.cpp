@@ -0,0 +1,77 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "DataTypes.h"
+#include "Variables.h"
+#include "Helper.Memory.h"
+#include "PositionReader.h"
+
+namespace positionreader = core::positionreader;
+namespace memory = common::helper::memory;
+
+using namespace std;
+
+constexpr DWORD PositionCount = 1024;
+constexpr FloatPoint AspectRatio{ 4, 3 };
+
+// CalculatePlayerPos before the reader: a branch on the data type, a division, and GetClientRect on every call
+DoublePoint ReadBranchy(PointDataType type, DWORD address) {
+    DoublePoint position{};
+    if (type == PointDataType::Int) {
+        IntPoint value{};
+        memory::TryRead(address, &value, sizeof(value));
+        position = { double(value.X), double(value.Y) };
+    }
+    else if (type == PointDataType::Float) {
+        FloatPoint value{};
+        memory::TryRead(address, &value, sizeof(value));
+        position = { value.X, value.Y };
+    }
+    else if (type == PointDataType::Short) {
+        ShortPoint value{};
+        memory::TryRead(address, &value, sizeof(value));
+        position = { double(value.X), double(value.Y) };
+    }
+    else if (type == PointDataType::Double) {
+        memory::TryRead(address, &position, sizeof(position));
+    }
+    RECT clientRect{};
+    GetClientRect(g_hFocusWindow, &clientRect);
+    auto realWidth = (clientRect.bottom - clientRect.top) * AspectRatio.X / AspectRatio.Y;
+    auto paddingX = (clientRect.right - clientRect.left - realWidth) / 2;
+    g_playerPosRaw = position;
+    return { position.X / g_pixelRate + g_pixelOffset.X + paddingX, position.Y / g_pixelRate + g_pixelOffset.Y };
+}
+
+// 1024 float positions read one after the other, the way the input thread reads one per frame.
+// GetClientRect of the shim fails without a syscall, so the old path is timed without what user32 costs on Windows.
+int main(int argc, char** argv) {
+    benchmark::ParseArguments(argc, argv);
+    g_pixelRate = 0.5f;
+    g_pixelOffset = { 32, 16 };
+    vector<FloatPoint> positions(PositionCount);
+    mt19937 random(20);
+    for (auto& position : positions)
+        position = { uniform_real_distribution<float>(0, 384)(random), uniform_real_distribution<float>(0, 448)(random) };
+
+    auto reader = positionreader::Make(PointDataType::Float, { 0, 0 }, AspectRatio, g_pixelRate, g_pixelOffset);
+    for (auto& position : positions) {
+        auto address = DWORD(&position);
+        auto before = ReadBranchy(PointDataType::Float, address);
+        auto after = reader.Read(reader, address);
+        if (lrint(before.X) != lrint(after.X) || lrint(before.Y) != lrint(after.Y))
+            return 1;
+    }
+
+    benchmark::Measure("Branchy/Read", PositionCount, "read", [&] {
+        for (auto& position : positions)
+            benchmark::DoNotOptimize(ReadBranchy(PointDataType::Float, DWORD(&position)));
+    });
+    benchmark::Measure("PositionReader/Read", PositionCount, "read", [&] {
+        for (auto& position : positions)
+            benchmark::DoNotOptimize(reader.Read(reader, DWORD(&position)));
+    });
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "DataTypes.h"
+#include "Variables.h"
+#include "PositionReader.h"
+
+namespace positionreader = core::positionreader;
+
+using namespace std;
+
+constexpr SIZE ClientSize{ 1280, 960 };
+// 16:9 in a 4:3 window, so there's padding on X
+constexpr FloatPoint AspectRatio{ 16, 9 };
+constexpr float PixelRate = 0.5f;
+constexpr FloatPoint PixelOffset{ 32, 16 };
+
+// how CalculatePlayerPos converted a position before the reader
+DoublePoint ConvertPosition(double x, double y) {
+    auto realWidth = ClientSize.cy * AspectRatio.X / AspectRatio.Y;
+    auto paddingX = (ClientSize.cx - realWidth) / 2;
+    return { x / PixelRate + PixelOffset.X + paddingX, y / PixelRate + PixelOffset.Y };
+}
+
+template <typename T>
+void ExpectConvertedLikeBefore(PointDataType type, T position) {
+    auto reader = positionreader::Make(type, ClientSize, AspectRatio, PixelRate, PixelOffset);
+    EXPECT_EQ(reader.Size, sizeof(T));
+    auto result = reader.Read(reader, DWORD(&position));
+    auto expected = ConvertPosition(position.X, position.Y);
+    EXPECT_DOUBLE_EQ(result.X, expected.X);
+    EXPECT_DOUBLE_EQ(result.Y, expected.Y);
+    EXPECT_EQ(lrint(result.X), lrint(expected.X));
+    EXPECT_EQ(lrint(result.Y), lrint(expected.Y));
+    EXPECT_EQ(g_playerPosRaw.X, double(position.X));
+    EXPECT_EQ(g_playerPosRaw.Y, double(position.Y));
+}
+
+TEST(PositionReader, EachDataTypeConvertsLikeBefore) {
+    ExpectConvertedLikeBefore(PointDataType::Int, IntPoint{ 192, -37 });
+    ExpectConvertedLikeBefore(PointDataType::Short, ShortPoint{ -5, 448 });
+    ExpectConvertedLikeBefore(PointDataType::Float, FloatPoint{ 191.75f, 383.25f });
+    ExpectConvertedLikeBefore(PointDataType::Double, DoublePoint{ 0.125, 447.875 });
+}
+
+TEST(PositionReader, NoPosition) {
+    auto reader = positionreader::Make(PointDataType::None, ClientSize, AspectRatio, PixelRate, PixelOffset);
+    EXPECT_EQ(reader.Size, 0u);
+    IntPoint position{ 100, 100 };
+    auto result = reader.Read(reader, DWORD(&position));
+    EXPECT_EQ(result.X, 0);
+    EXPECT_EQ(result.Y, 0);
+}
+
+TEST(PositionReader, KeepsWhatItWasMadeFrom) {
+    auto reader = positionreader::Make(PointDataType::Float, ClientSize, AspectRatio, PixelRate, PixelOffset);
+    EXPECT_EQ(reader.PixelRate, PixelRate);
+    EXPECT_EQ(reader.PixelOffset.X, PixelOffset.X);
+    EXPECT_EQ(reader.PixelOffset.Y, PixelOffset.Y);
+    EXPECT_EQ(reader.ClientSize.cx, ClientSize.cx);
+    EXPECT_EQ(reader.ClientSize.cy, ClientSize.cy);
+}
+
+// before the renderer measured anything the pixel rate is 0, that mustn't make infinities
+TEST(PositionReader, UnmeasuredPixelRate) {
+    auto reader = positionreader::Make(PointDataType::Int, ClientSize, AspectRatio, 0, {});
+    IntPoint position{ 100, 100 };
+    auto result = reader.Read(reader, DWORD(&position));
+    EXPECT_TRUE(isfinite(result.X));
+    EXPECT_TRUE(isfinite(result.Y));
+}
+
+// a position the game freed reads as 0 rather than crashing
+TEST(PositionReader, UnreadableAddress) {
+    auto reader = positionreader::Make(PointDataType::Int, ClientSize, AspectRatio, PixelRate, PixelOffset);
+    auto result = reader.Read(reader, 0x10);
+    auto expected = ConvertPosition(0, 0);
+    EXPECT_DOUBLE_EQ(result.X, expected.X);
+    EXPECT_DOUBLE_EQ(result.Y, expected.Y);
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "DataTypes.h"
+#include "KeyBindings.h"
+#include "SendKey.h"
+
+namespace keybindings = common::keybindings;
+namespace sendkey = core::sendkey;
+
+using namespace std;
+using sendkey::KeyTransition;
+
+constexpr BYTE BombKey = 'Z';
+constexpr BYTE ExtraKey = 'X';
+
+// the batches the sink got, one per call
+vector<vector<KeyTransition>> batches;
+
+void RecordBatch(const KeyTransition* transitions, UINT count) {
+    batches.emplace_back(transitions, transitions + count);
+}
+
+void IgnoreBatch(const KeyTransition*, UINT) {}
+
+class SendKeyTest : public testing::Test {
+protected:
+    sendkey::KeySink previousSink{};
+
+    void SetUp() override {
+        SharedConfig config{};
+        config.BombButton = BombKey;
+        config.ExtraButton = ExtraKey;
+        keybindings::Publish(config);
+        // release what an earlier test left pressed
+        previousSink = sendkey::SetKeySink(IgnoreBatch);
+        sendkey::SendKeys(GameInput::NONE);
+        sendkey::SetKeySink(RecordBatch);
+        batches.clear();
+    }
+
+    void TearDown() override {
+        sendkey::SetKeySink(IgnoreBatch);
+        sendkey::SendKeys(GameInput::NONE);
+        sendkey::SetKeySink(previousSink);
+    }
+};
+
+void ExpectBatch(const vector<KeyTransition>& batch, const vector<KeyTransition>& expected) {
+    ASSERT_EQ(batch.size(), expected.size());
+    for (size_t i = 0; i < batch.size(); i++) {
+        EXPECT_EQ(batch[i].VkCode, expected[i].VkCode) << i;
+        EXPECT_EQ(batch[i].Down, expected[i].Down) << i;
+    }
+}
+
+TEST_F(SendKeyTest, EveryKeyInOneCallInItsOrder) {
+    sendkey::SendKeys(GameInput::USE_BOMB | GameInput::USE_SPECIAL | GameInput::USE_FOCUS
+        | GameInput::MOVE_LEFT | GameInput::MOVE_RIGHT | GameInput::MOVE_UP | GameInput::MOVE_DOWN);
+    ASSERT_EQ(batches.size(), 1u);
+    ExpectBatch(batches[0], {
+        { BombKey, true }, { ExtraKey, true }, { VK_SHIFT, true },
+        { VK_LEFT, true }, { VK_RIGHT, true }, { VK_UP, true }, { VK_DOWN, true },
+    });
+}
+
+// nothing is sent for a frame whose keys are the same as the last one's
+TEST_F(SendKeyTest, OneCallPerFrameThatChangesAKey) {
+    auto focusLeft = GameInput::USE_FOCUS | GameInput::MOVE_LEFT;
+    sendkey::SendKeys(focusLeft);
+    sendkey::SendKeys(focusLeft);
+    sendkey::SendKeys(GameInput::NONE);
+    sendkey::SendKeys(GameInput::NONE);
+    ASSERT_EQ(batches.size(), 2u);
+    ExpectBatch(batches[0], { { VK_SHIFT, true }, { VK_LEFT, true } });
+    ExpectBatch(batches[1], { { VK_SHIFT, false }, { VK_LEFT, false } });
+}
+
+// a key that stays pressed from one frame to the next isn't sent again
+TEST_F(SendKeyTest, OnlyTheChangedKeysAreSent) {
+    sendkey::SendKeys(GameInput::USE_FOCUS | GameInput::MOVE_LEFT | GameInput::MOVE_UP);
+    sendkey::SendKeys(GameInput::USE_FOCUS | GameInput::MOVE_RIGHT | GameInput::MOVE_UP);
+    sendkey::SendKeys(GameInput::USE_BOMB | GameInput::MOVE_RIGHT);
+    ASSERT_EQ(batches.size(), 3u);
+    ExpectBatch(batches[1], { { VK_LEFT, false }, { VK_RIGHT, true } });
+    ExpectBatch(batches[2], { { BombKey, true }, { VK_SHIFT, false }, { VK_UP, false } });
+}
+
+TEST_F(SendKeyTest, UsesTheKeyBindingsOfTheFrame) {
+    SharedConfig config{};
+    config.BombButton = 'C';
+    config.ExtraButton = 'V';
+    keybindings::Publish(config);
+    sendkey::SendKeys(GameInput::USE_BOMB | GameInput::USE_SPECIAL);
+    ASSERT_EQ(batches.size(), 1u);
+    ExpectBatch(batches[0], { { 'C', true }, { 'V', true } });
+}
+
+TEST(KeyBindings, RoundTripsEveryButton) {
+    SharedConfig config{};
+    config.BombButton = 0x5A;
+    config.ExtraButton = 0xFE;
+    config.ToggleOsCursorButton = 0x82;
+    config.ToggleImGuiButton = 0x7B;
+    keybindings::Publish(config);
+    auto keyBindings = keybindings::Load();
+    EXPECT_EQ(keyBindings.BombButton, 0x5A);
+    EXPECT_EQ(keyBindings.ExtraButton, 0xFE);
+    EXPECT_EQ(keyBindings.ToggleOsCursorButton, 0x82);
+    EXPECT_EQ(keyBindings.ToggleImGuiButton, 0x7B);
+}
@@ -0,0 +1,51 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "Benchmark.h"
+#include "DataTypes.h"
+#include "SeqLock.h"
+
+namespace seqlock = common::seqlock;
+
+using namespace std;
+
+// What a reader of the shared config pays: the check each frame, and a copy when it changed,
+// alone and while another thread writes every millisecond, far more often than the GUI does.
+int main(int argc, char** argv) {
+    benchmark::ParseArguments(argc, argv);
+    DWORD sequence = 0;
+    SharedConfig shared{};
+    SharedConfig output;
+    DWORD outputSequence = 0;
+
+    benchmark::Measure("HasChanged", 1, "read", [&] {
+        benchmark::DoNotOptimize(seqlock::HasChanged(sequence, outputSequence));
+    });
+    benchmark::Measure("Read/NoWriter", 1, "read", [&] {
+        benchmark::DoNotOptimize(seqlock::Read(sequence, shared, output, outputSequence));
+    });
+    benchmark::Measure("PlainCopy/NoWriter", 1, "read", [&] {
+        output = shared;
+        benchmark::DoNotOptimize(output);
+    });
+
+    atomic<bool> stop = false;
+    thread writer([&] {
+        auto config = shared;
+        while (!stop.load(memory_order_relaxed)) {
+            config.InputThreadRate++;
+            seqlock::Write(sequence, shared, config);
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    });
+    DWORD failures = 0;
+    benchmark::Measure("Read/Writer", 1, "read", [&] {
+        failures += !seqlock::Read(sequence, shared, output, outputSequence);
+        benchmark::DoNotOptimize(output);
+    });
+    stop = true;
+    writer.join();
+    printf("reads that gave up while the writer ran: %u\n", failures);
+    return 0;
+}
@@ -0,0 +1,912 @@
+#include <windows.h>
+#include <tlhelp32.h>
+#include <cerrno>
+#include <cstdio>
+#include <cwctype>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <sched.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// The Win32 functions the portable sources call, on top of POSIX. Handles are pointers to an Object,
+// what the tests don't reach fails with ERROR_NOT_SUPPORTED.
+
+using namespace std;
+
+#define ERROR_INVALID_HANDLE 6L
+#define ERROR_ACCESS_DENIED 5L
+#define ERROR_INVALID_PARAMETER 87L
+#define ERROR_INSUFFICIENT_BUFFER 122L
+#define ERROR_NO_MORE_FILES 18L
+#define ERROR_FILE_INVALID 1006L
+#define CSTR_LESS_THAN 1
+#define CSTR_GREATER_THAN 3
+#define PF_XMMI64_INSTRUCTIONS_AVAILABLE 10
+#define PF_AVX2_INSTRUCTIONS_AVAILABLE 40
+
+struct Object {
+    virtual ~Object() = default;
+};
+
+struct FileObject : Object {
+    int     Descriptor;
+    bool    Owned;
+    FileObject(int descriptor, bool owned = true) : Descriptor(descriptor), Owned(owned) {}
+    ~FileObject() override {
+        if (Owned)
+            close(Descriptor);
+    }
+};
+
+// a named mapping without a file is shared memory of this process, the tests don't cross processes
+struct SharedMemory {
+    void*   Address;
+    size_t  Size;
+    ~SharedMemory() {
+        munmap(Address, Size);
+    }
+};
+
+struct MappingObject : Object {
+    int                         Descriptor = -1;
+    size_t                      Size = 0;
+    bool                        Writable = false;
+    shared_ptr<SharedMemory>    Memory;
+    ~MappingObject() override {
+        if (Descriptor >= 0)
+            close(Descriptor);
+    }
+};
+
+struct ProcessObject : Object {
+    pid_t   ProcessId;
+    explicit ProcessObject(pid_t processId) : ProcessId(processId) {}
+};
+
+struct ModuleSnapshot : Object {
+    vector<MODULEENTRY32W>  Modules;
+    size_t                  Next = 0;
+};
+
+struct MapsEntry {
+    uintptr_t   Begin;
+    uintptr_t   End;
+    DWORD       Protect;
+    DWORD       Type;
+    string      Path;
+};
+
+thread_local DWORD lastError;
+mutex sharedMemoriesMutex;
+map<wstring, weak_ptr<SharedMemory>> sharedMemories;
+mutex viewsMutex;
+// the views made by mmap, so UnmapViewOfFile knows their size
+map<const void*, size_t> views;
+
+#pragma region helpers
+DWORD ErrorFromErrno(int error) {
+    switch (error) {
+        case ENOENT: case ENOTDIR:
+            return ERROR_FILE_NOT_FOUND;
+        case EACCES: case EPERM:
+            return ERROR_ACCESS_DENIED;
+        case EBADF:
+            return ERROR_INVALID_HANDLE;
+        case EFAULT: case EIO:
+            return ERROR_PARTIAL_COPY;
+        case EINVAL: case ESRCH:
+            return ERROR_INVALID_PARAMETER;
+        case EFBIG:
+            return ERROR_FILE_TOO_LARGE;
+        default:
+            return ERROR_NOT_SUPPORTED;
+    }
+}
+
+BOOL FailWith(DWORD error) {
+    lastError = error;
+    return FALSE;
+}
+
+BOOL FailWithErrno() {
+    return FailWith(ErrorFromErrno(errno));
+}
+
+template <typename T>
+T* As(HANDLE handle) {
+    if (handle == NULL || handle == INVALID_HANDLE_VALUE)
+        return nullptr;
+    return dynamic_cast<T*>(static_cast<Object*>(handle));
+}
+
+// GetCurrentProcess() is INVALID_HANDLE_VALUE like on Windows
+pid_t ProcessIdOf(HANDLE process) {
+    if (process == GetCurrentProcess())
+        return getpid();
+    auto object = As<ProcessObject>(process);
+    return object ? object->ProcessId : -1;
+}
+
+// WCHAR strings are UTF-16 code units, as on Windows, stored in the wider wchar_t
+string ToUtf8(LPCWSTR input) {
+    string output;
+    auto size = WideCharToMultiByte(CP_UTF8, 0, input, -1, NULL, 0, NULL, NULL);
+    if (size <= 0)
+        return output;
+    output.resize(size);
+    WideCharToMultiByte(CP_UTF8, 0, input, -1, output.data(), size, NULL, NULL);
+    output.pop_back();
+    return output;
+}
+
+wstring ToUtf16(const char* input) {
+    wstring output;
+    auto size = MultiByteToWideChar(CP_UTF8, 0, input, -1, NULL, 0);
+    if (size <= 0)
+        return output;
+    output.resize(size);
+    MultiByteToWideChar(CP_UTF8, 0, input, -1, output.data(), size);
+    output.pop_back();
+    return output;
+}
+
+FILETIME ToFileTime(const timespec& time) {
+    constexpr ULONGLONG UnixEpochInFileTime = 116444736000000000ULL;
+    auto value = UnixEpochInFileTime + ULONGLONG(time.tv_sec) * 10000000 + ULONGLONG(time.tv_nsec) / 100;
+    return { DWORD(value & 0xFFFFFFFF), DWORD(value >> 32) };
+}
+
+DWORD ProtectFromMaps(string_view permissions) {
+    auto read = permissions[0] == 'r';
+    auto write = permissions[1] == 'w';
+    auto execute = permissions[2] == 'x';
+    if (execute)
+        return write ? PAGE_EXECUTE_READWRITE : read ? PAGE_EXECUTE_READ : PAGE_EXECUTE;
+    return write ? PAGE_READWRITE : read ? PAGE_READONLY : PAGE_NOACCESS;
+}
+
+vector<MapsEntry> ReadMaps(pid_t processId) {
+    vector<MapsEntry> entries;
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/maps", int(processId));
+    auto file = fopen(path, "r");
+    if (!file)
+        return entries;
+    char line[4096];
+    while (fgets(line, sizeof(line), file)) {
+        unsigned long begin, end, offset, inode;
+        char permissions[8], device[16];
+        int pathOffset = 0;
+        if (sscanf(line, "%lx-%lx %7s %lx %15s %lu %n", &begin, &end, permissions, &offset, device, &inode, &pathOffset) < 6)
+            continue;
+        string mappedPath = pathOffset > 0 ? line + pathOffset : "";
+        while (!mappedPath.empty() && (mappedPath.back() == '\n' || mappedPath.back() == ' '))
+            mappedPath.pop_back();
+        entries.push_back({ begin, end, ProtectFromMaps(permissions), inode != 0 ? DWORD(MEM_MAPPED) : DWORD(MEM_PRIVATE), mappedPath });
+    }
+    fclose(file);
+    return entries;
+}
+
+int OpenFlags(DWORD access, DWORD disposition) {
+    auto read = (access & GENERIC_READ) != 0;
+    auto write = (access & GENERIC_WRITE) != 0;
+    auto flags = read && write ? O_RDWR : write ? O_WRONLY : O_RDONLY;
+    if (disposition == CREATE_ALWAYS)
+        flags |= O_CREAT | O_TRUNC;
+    return flags | O_CLOEXEC;
+}
+#pragma endregion
+
+extern "C" {
+#pragma region errors and messages
+DWORD GetLastError() {
+    return lastError;
+}
+
+void SetLastError(DWORD error) {
+    lastError = error;
+}
+
+DWORD FormatMessageA(DWORD flags, LPCVOID, DWORD messageId, DWORD, LPSTR buffer, DWORD size, void*) {
+    char message[64];
+    auto length = snprintf(message, sizeof(message), "error %lu", messageId);
+    if ((flags & FORMAT_MESSAGE_ALLOCATE_BUFFER) != 0) {
+        auto allocated = (char*)malloc(length + 1);
+        memcpy(allocated, message, length + 1);
+        *(char**)buffer = allocated;
+        return DWORD(length);
+    }
+    if (DWORD(length) >= size)
+        return FailWith(ERROR_INSUFFICIENT_BUFFER);
+    memcpy(buffer, message, length + 1);
+    return DWORD(length);
+}
+
+HGLOBAL LocalFree(HGLOBAL memory) {
+    free(memory);
+    return NULL;
+}
+
+// there is nobody to click, the message goes to stderr
+int MessageBoxA(HWND, LPCSTR text, LPCSTR caption, UINT) {
+    fprintf(stderr, "%s: %s\n", caption, text);
+    return 1;
+}
+
+int MessageBoxW(HWND window, LPCWSTR text, LPCWSTR caption, UINT type) {
+    return MessageBoxA(window, ToUtf8(text).c_str(), ToUtf8(caption).c_str(), type);
+}
+
+HANDLE GetStdHandle(DWORD stdHandle) {
+    static FileObject output(STDOUT_FILENO, false);
+    if (stdHandle != STD_OUTPUT_HANDLE)
+        return INVALID_HANDLE_VALUE;
+    return &output;
+}
+
+BOOL AttachConsole(DWORD) {
+    return FailWith(ERROR_NOT_SUPPORTED);
+}
+#pragma endregion
+
+#pragma region files and mappings
+HANDLE CreateFileA(LPCSTR path, DWORD access, DWORD, void*, DWORD disposition, DWORD, HANDLE) {
+    auto descriptor = open(path, OpenFlags(access, disposition), 0644);
+    if (descriptor < 0) {
+        FailWithErrno();
+        return INVALID_HANDLE_VALUE;
+    }
+    return new FileObject(descriptor);
+}
+
+HANDLE CreateFileW(LPCWSTR path, DWORD access, DWORD shareMode, void* security, DWORD disposition, DWORD flags, HANDLE templateFile) {
+    return CreateFileA(ToUtf8(path).c_str(), access, shareMode, security, disposition, flags, templateFile);
+}
+
+BOOL ReadFile(HANDLE file, LPVOID buffer, DWORD size, LPDWORD read, void*) {
+    auto object = As<FileObject>(file);
+    if (!object)
+        return FailWith(ERROR_INVALID_HANDLE);
+    DWORD total = 0;
+    while (total < size) {
+        auto count = ::read(object->Descriptor, (char*)buffer + total, size - total);
+        if (count < 0)
+            return FailWithErrno();
+        if (count == 0)
+            break;
+        total += DWORD(count);
+    }
+    if (read)
+        *read = total;
+    return TRUE;
+}
+
+BOOL WriteFile(HANDLE file, LPCVOID buffer, DWORD size, LPDWORD written, void*) {
+    auto object = As<FileObject>(file);
+    if (!object)
+        return FailWith(ERROR_INVALID_HANDLE);
+    DWORD total = 0;
+    while (total < size) {
+        auto count = write(object->Descriptor, (const char*)buffer + total, size - total);
+        if (count < 0)
+            return FailWithErrno();
+        total += DWORD(count);
+    }
+    if (written)
+        *written = total;
+    return TRUE;
+}
+
+BOOL GetFileSizeEx(HANDLE file, LARGE_INTEGER* size) {
+    auto object = As<FileObject>(file);
+    if (!object)
+        return FailWith(ERROR_INVALID_HANDLE);
+    struct stat status;
+    if (fstat(object->Descriptor, &status) != 0)
+        return FailWithErrno();
+    size->QuadPart = status.st_size;
+    return TRUE;
+}
+
+BOOL GetFileTime(HANDLE file, FILETIME* creation, FILETIME* lastAccess, FILETIME* lastWrite) {
+    auto object = As<FileObject>(file);
+    if (!object)
+        return FailWith(ERROR_INVALID_HANDLE);
+    struct stat status;
+    if (fstat(object->Descriptor, &status) != 0)
+        return FailWithErrno();
+    if (creation)
+        *creation = ToFileTime(status.st_ctim);
+    if (lastAccess)
+        *lastAccess = ToFileTime(status.st_atim);
+    if (lastWrite)
+        *lastWrite = ToFileTime(status.st_mtim);
+    return TRUE;
+}
+
+BOOL GetFileAttributesExA(LPCSTR path, GET_FILEEX_INFO_LEVELS, LPVOID information) {
+    struct stat status;
+    if (stat(path, &status) != 0)
+        return FailWithErrno();
+    auto data = (WIN32_FILE_ATTRIBUTE_DATA*)information;
+    data->dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
+    data->ftCreationTime = ToFileTime(status.st_ctim);
+    data->ftLastAccessTime = ToFileTime(status.st_atim);
+    data->ftLastWriteTime = ToFileTime(status.st_mtim);
+    data->nFileSizeHigh = DWORD(ULONGLONG(status.st_size) >> 32);
+    data->nFileSizeLow = DWORD(status.st_size & 0xFFFFFFFF);
+    return TRUE;
+}
+
+BOOL DeleteFileA(LPCSTR path) {
+    return unlink(path) == 0 ? TRUE : FailWithErrno();
+}
+
+BOOL DeleteFileW(LPCWSTR path) {
+    return DeleteFileA(ToUtf8(path).c_str());
+}
+
+BOOL MoveFileExA(LPCSTR from, LPCSTR to, DWORD) {
+    return rename(from, to) == 0 ? TRUE : FailWithErrno();
+}
+
+BOOL MoveFileExW(LPCWSTR from, LPCWSTR to, DWORD flags) {
+    return MoveFileExA(ToUtf8(from).c_str(), ToUtf8(to).c_str(), flags);
+}
+
+DWORD GetFullPathNameW(LPCWSTR path, DWORD size, LPWSTR buffer, LPWSTR* filePart) {
+    wstring fullPath = path;
+    if (fullPath.empty() || fullPath[0] != L'/') {
+        char directory[4096];
+        if (!getcwd(directory, sizeof(directory)))
+            return FailWithErrno();
+        fullPath = ToUtf16(directory) + L"/" + fullPath;
+    }
+    if (fullPath.size() >= size)
+        return DWORD(fullPath.size() + 1);
+    wcscpy(buffer, fullPath.c_str());
+    if (filePart)
+        *filePart = buffer + fullPath.rfind(L'/') + 1;
+    return DWORD(fullPath.size());
+}
+
+HANDLE CreateFileMappingW(HANDLE file, void*, DWORD protect, DWORD sizeHigh, DWORD sizeLow, LPCWSTR name) {
+    auto size = size_t(ULONGLONG(sizeHigh) << 32 | sizeLow);
+    auto mapping = make_unique<MappingObject>();
+    mapping->Writable = (protect & (PAGE_READWRITE | PAGE_EXECUTE_READWRITE)) != 0;
+    if (file == INVALID_HANDLE_VALUE) {
+        if (size == 0) {
+            FailWith(ERROR_INVALID_PARAMETER);
+            return NULL;
+        }
+        lock_guard lock(sharedMemoriesMutex);
+        auto& shared = sharedMemories[name ? name : L""];
+        mapping->Memory = name ? shared.lock() : nullptr;
+        auto existing = mapping->Memory != nullptr;
+        if (!existing) {
+            auto address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+            if (address == MAP_FAILED) {
+                FailWithErrno();
+                return NULL;
+            }
+            mapping->Memory = make_shared<SharedMemory>(address, size);
+            if (name)
+                shared = mapping->Memory;
+        }
+        mapping->Size = mapping->Memory->Size;
+        lastError = existing ? ERROR_ALREADY_EXISTS : ERROR_SUCCESS;
+        return mapping.release();
+    }
+    auto fileObject = As<FileObject>(file);
+    if (!fileObject) {
+        FailWith(ERROR_INVALID_HANDLE);
+        return NULL;
+    }
+    struct stat status;
+    if (fstat(fileObject->Descriptor, &status) != 0) {
+        FailWithErrno();
+        return NULL;
+    }
+    if (size == 0)
+        size = size_t(status.st_size);
+    // like Windows, an empty file can't be mapped
+    if (size == 0) {
+        FailWith(ERROR_FILE_INVALID);
+        return NULL;
+    }
+    mapping->Descriptor = dup(fileObject->Descriptor);
+    mapping->Size = size;
+    lastError = ERROR_SUCCESS;
+    return mapping.release();
+}
+
+HANDLE CreateFileMappingA(HANDLE file, void* security, DWORD protect, DWORD sizeHigh, DWORD sizeLow, LPCSTR name) {
+    auto wideName = name ? ToUtf16(name) : wstring();
+    return CreateFileMappingW(file, security, protect, sizeHigh, sizeLow, name ? wideName.c_str() : NULL);
+}
+
+HANDLE OpenFileMappingW(DWORD access, BOOL, LPCWSTR name) {
+    lock_guard lock(sharedMemoriesMutex);
+    auto shared = sharedMemories.find(name);
+    auto memory = shared != sharedMemories.end() ? shared->second.lock() : nullptr;
+    if (!memory) {
+        FailWith(ERROR_FILE_NOT_FOUND);
+        return NULL;
+    }
+    auto mapping = new MappingObject();
+    mapping->Memory = memory;
+    mapping->Size = memory->Size;
+    mapping->Writable = (access & FILE_MAP_WRITE) != 0;
+    return mapping;
+}
+
+HANDLE OpenFileMappingA(DWORD access, BOOL inherit, LPCSTR name) {
+    return OpenFileMappingW(access, inherit, ToUtf16(name).c_str());
+}
+
+LPVOID MapViewOfFile(HANDLE mapping, DWORD access, DWORD offsetHigh, DWORD offsetLow, SIZE_T size) {
+    auto object = As<MappingObject>(mapping);
+    if (!object) {
+        FailWith(ERROR_INVALID_HANDLE);
+        return NULL;
+    }
+    auto offset = size_t(ULONGLONG(offsetHigh) << 32 | offsetLow);
+    if (size == 0)
+        size = object->Size - offset;
+    if (object->Memory)
+        return (BYTE*)object->Memory->Address + offset;
+    auto protection = PROT_READ | ((access & FILE_MAP_WRITE) != 0 ? PROT_WRITE : 0);
+    auto address = mmap(NULL, size, protection, MAP_SHARED, object->Descriptor, off_t(offset));
+    if (address == MAP_FAILED) {
+        FailWithErrno();
+        return NULL;
+    }
+    lock_guard lock(viewsMutex);
+    views[address] = size;
+    return address;
+}
+
+BOOL UnmapViewOfFile(LPCVOID address) {
+    lock_guard lock(viewsMutex);
+    auto view = views.find(address);
+    // views of shared memory live as long as the memory
+    if (view == views.end())
+        return TRUE;
+    munmap(const_cast<void*>(address), view->second);
+    views.erase(view);
+    return TRUE;
+}
+
+BOOL CloseHandle(HANDLE handle) {
+    auto object = As<Object>(handle);
+    if (!object)
+        return FailWith(ERROR_INVALID_HANDLE);
+    delete object;
+    return TRUE;
+}
+#pragma endregion
+
+#pragma region strings
+int MultiByteToWideChar(UINT codePage, DWORD, LPCSTR input, int inputSize, LPWSTR output, int outputSize) {
+    if (codePage != CP_UTF8)
+        return FailWith(ERROR_NOT_SUPPORTED);
+    auto size = inputSize < 0 ? strlen(input) + 1 : size_t(inputSize);
+    auto bytes = (const unsigned char*)input;
+    int count = 0;
+    auto put = [&](char32_t unit) {
+        if (outputSize > 0 && count < outputSize)
+            output[count] = wchar_t(unit);
+        count++;
+    };
+    for (size_t i = 0; i < size;) {
+        char32_t codePoint = bytes[i];
+        int length = codePoint < 0x80 ? 1 : codePoint >> 5 == 0x6 ? 2 : codePoint >> 4 == 0xE ? 3 : codePoint >> 3 == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > size) {
+            put(0xFFFD);
+            i++;
+            continue;
+        }
+        if (length > 1)
+            codePoint &= 0x7F >> length;
+        auto valid = true;
+        for (int j = 1; j < length; j++) {
+            valid = valid && bytes[i + j] >> 6 == 0x2;
+            codePoint = codePoint << 6 | (bytes[i + j] & 0x3F);
+        }
+        if (!valid) {
+            put(0xFFFD);
+            i++;
+            continue;
+        }
+        i += length;
+        if (codePoint >= 0x10000) {
+            put(0xD800 + ((codePoint - 0x10000) >> 10));
+            put(0xDC00 + ((codePoint - 0x10000) & 0x3FF));
+        }
+        else
+            put(codePoint);
+    }
+    if (outputSize > 0 && count > outputSize)
+        return FailWith(ERROR_INSUFFICIENT_BUFFER);
+    return count;
+}
+
+int WideCharToMultiByte(UINT codePage, DWORD, LPCWSTR input, int inputSize, LPSTR output, int outputSize, LPCSTR, BOOL*) {
+    if (codePage != CP_UTF8)
+        return FailWith(ERROR_NOT_SUPPORTED);
+    auto size = inputSize < 0 ? wcslen(input) + 1 : size_t(inputSize);
+    int count = 0;
+    auto put = [&](char32_t byte) {
+        if (outputSize > 0 && count < outputSize)
+            output[count] = char(byte);
+        count++;
+    };
+    for (size_t i = 0; i < size; i++) {
+        char32_t codePoint = char32_t(input[i]) & 0xFFFF;
+        if (codePoint >= 0xD800 && codePoint < 0xDC00 && i + 1 < size && (input[i + 1] & 0xFC00) == 0xDC00)
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (char32_t(input[++i]) & 0x3FF);
+        else if (codePoint >= 0xD800 && codePoint < 0xE000)
+            codePoint = 0xFFFD;
+        if (codePoint < 0x80)
+            put(codePoint);
+        else if (codePoint < 0x800) {
+            put(0xC0 | codePoint >> 6);
+            put(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000) {
+            put(0xE0 | codePoint >> 12);
+            put(0x80 | (codePoint >> 6 & 0x3F));
+            put(0x80 | (codePoint & 0x3F));
+        }
+        else {
+            put(0xF0 | codePoint >> 18);
+            put(0x80 | (codePoint >> 12 & 0x3F));
+            put(0x80 | (codePoint >> 6 & 0x3F));
+            put(0x80 | (codePoint & 0x3F));
+        }
+    }
+    if (outputSize > 0 && count > outputSize)
+        return FailWith(ERROR_INSUFFICIENT_BUFFER);
+    return count;
+}
+
+int LCMapStringEx(LPCWSTR, DWORD flags, LPCWSTR input, int inputSize, LPWSTR output, int outputSize, void*, void*, LPARAM) {
+    if (flags != LCMAP_UPPERCASE)
+        return FailWith(ERROR_NOT_SUPPORTED);
+    auto size = inputSize < 0 ? int(wcslen(input)) + 1 : inputSize;
+    if (outputSize == 0)
+        return size;
+    if (outputSize < size)
+        return FailWith(ERROR_INSUFFICIENT_BUFFER);
+    for (int i = 0; i < size; i++)
+        output[i] = towupper(input[i]);
+    return size;
+}
+
+int CompareStringOrdinal(LPCWSTR left, int leftSize, LPCWSTR right, int rightSize, BOOL ignoreCase) {
+    auto leftLength = leftSize < 0 ? wcslen(left) : size_t(leftSize);
+    auto rightLength = rightSize < 0 ? wcslen(right) : size_t(rightSize);
+    for (size_t i = 0; i < leftLength && i < rightLength; i++) {
+        auto leftChar = ignoreCase ? towupper(left[i]) : wint_t(left[i]);
+        auto rightChar = ignoreCase ? towupper(right[i]) : wint_t(right[i]);
+        if (leftChar != rightChar)
+            return leftChar < rightChar ? CSTR_LESS_THAN : CSTR_GREATER_THAN;
+    }
+    if (leftLength == rightLength)
+        return CSTR_EQUAL;
+    return leftLength < rightLength ? CSTR_LESS_THAN : CSTR_GREATER_THAN;
+}
+
+int lstrlenW(LPCWSTR string) {
+    return string ? int(wcslen(string)) : 0;
+}
+
+int _stricmp(const char* left, const char* right) {
+    return strcasecmp(left, right);
+}
+
+int _strnicmp(const char* left, const char* right, size_t size) {
+    return strncasecmp(left, right, size);
+}
+
+int _wcsicmp(const wchar_t* left, const wchar_t* right) {
+    return wcscasecmp(left, right);
+}
+
+int _wcsnicmp(const wchar_t* left, const wchar_t* right, size_t size) {
+    return wcsncasecmp(left, right, size);
+}
+#pragma endregion
+
+#pragma region processes and memory
+HANDLE GetCurrentProcess() {
+    return INVALID_HANDLE_VALUE;
+}
+
+DWORD GetCurrentProcessId() {
+    return DWORD(getpid());
+}
+
+DWORD GetCurrentThreadId() {
+    return DWORD(syscall(SYS_gettid));
+}
+
+HANDLE OpenProcess(DWORD, BOOL, DWORD processId) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%lu", processId);
+    if (access(path, F_OK) != 0) {
+        FailWith(ERROR_INVALID_PARAMETER);
+        return NULL;
+    }
+    return new ProcessObject(pid_t(processId));
+}
+
+// process_vm_readv, which also reads this process without faulting on an unreadable address
+BOOL ReadProcessMemory(HANDLE process, LPCVOID address, LPVOID buffer, SIZE_T size, SIZE_T* read) {
+    auto processId = ProcessIdOf(process);
+    if (processId < 0)
+        return FailWith(ERROR_INVALID_HANDLE);
+    iovec local{ buffer, size };
+    iovec remote{ const_cast<void*>(address), size };
+    auto count = process_vm_readv(processId, &local, 1, &remote, 1, 0);
+    if (read)
+        *read = count < 0 ? 0 : SIZE_T(count);
+    if (count < 0)
+        return FailWithErrno();
+    if (SIZE_T(count) != size)
+        return FailWith(ERROR_PARTIAL_COPY);
+    return TRUE;
+}
+
+// /proc/<pid>/maps, a mapping is a region, a gap between two is a free one
+SIZE_T VirtualQueryEx(HANDLE process, LPCVOID address, MEMORY_BASIC_INFORMATION* information, SIZE_T size) {
+    if (size < sizeof(*information))
+        return FailWith(ERROR_BAD_LENGTH);
+    auto processId = ProcessIdOf(process);
+    if (processId < 0)
+        return FailWith(ERROR_INVALID_HANDLE);
+    auto entries = ReadMaps(processId);
+    auto value = uintptr_t(address);
+    uintptr_t freeBegin = 0;
+    for (auto& entry : entries) {
+        if (value < entry.Begin) {
+            *information = {
+                .BaseAddress = PVOID(freeBegin),
+                .RegionSize = entry.Begin - freeBegin,
+                .State = MEM_FREE,
+                .Protect = PAGE_NOACCESS,
+            };
+            return sizeof(*information);
+        }
+        if (value < entry.End) {
+            *information = {
+                .BaseAddress = PVOID(entry.Begin),
+                .AllocationBase = PVOID(entry.Begin),
+                .AllocationProtect = entry.Protect,
+                .RegionSize = entry.End - entry.Begin,
+                .State = MEM_COMMIT,
+                .Protect = entry.Protect,
+                .Type = entry.Type,
+            };
+            return sizeof(*information);
+        }
+        freeBegin = entry.End;
+    }
+    return FailWith(ERROR_INVALID_PARAMETER);
+}
+
+SIZE_T VirtualQuery(LPCVOID address, MEMORY_BASIC_INFORMATION* information, SIZE_T size) {
+    return VirtualQueryEx(GetCurrentProcess(), address, information, size);
+}
+
+void GetSystemInfo(SYSTEM_INFO* information) {
+    *information = {
+        .dwPageSize = DWORD(sysconf(_SC_PAGESIZE)),
+        .lpMinimumApplicationAddress = LPVOID(0x10000),
+        .lpMaximumApplicationAddress = LPVOID(0x7FFFFFFEFFFF),
+        .dwActiveProcessorMask = 1,
+        .dwNumberOfProcessors = DWORD(sysconf(_SC_NPROCESSORS_ONLN)),
+        .dwAllocationGranularity = 0x10000,
+    };
+}
+
+BOOL IsProcessorFeaturePresent(DWORD feature) {
+    switch (feature) {
+        case PF_XMMI64_INSTRUCTIONS_AVAILABLE:
+            return __builtin_cpu_supports("sse2");
+        case PF_AVX2_INSTRUCTIONS_AVAILABLE:
+            return __builtin_cpu_supports("avx2");
+        default:
+            return FALSE;
+    }
+}
+
+// every mapped file is a module, the first one is the executable
+HANDLE CreateToolhelp32Snapshot(DWORD, DWORD processId) {
+    auto snapshot = make_unique<ModuleSnapshot>();
+    auto entries = ReadMaps(processId == 0 ? getpid() : pid_t(processId));
+    if (entries.empty()) {
+        FailWith(ERROR_INVALID_PARAMETER);
+        return INVALID_HANDLE_VALUE;
+    }
+    map<string, size_t> moduleIndexes;
+    for (auto& entry : entries) {
+        if (entry.Type != MEM_MAPPED || entry.Path.empty())
+            continue;
+        auto [found, added] = moduleIndexes.try_emplace(entry.Path, snapshot->Modules.size());
+        if (added) {
+            MODULEENTRY32W module{ .dwSize = sizeof(module), .th32ProcessID = processId, .modBaseAddr = (BYTE*)entry.Begin };
+            module.hModule = HMODULE(entry.Begin);
+            auto path = ToUtf16(entry.Path.c_str());
+            wcsncpy(module.szExePath, path.c_str(), MAX_PATH - 1);
+            wcsncpy(module.szModule, path.c_str() + path.rfind(L'/') + 1, MAX_MODULE_NAME32);
+            snapshot->Modules.push_back(module);
+        }
+        auto& module = snapshot->Modules[found->second];
+        module.modBaseSize = DWORD(entry.End - uintptr_t(module.modBaseAddr));
+    }
+    return snapshot.release();
+}
+
+BOOL Module32NextW(HANDLE snapshot, MODULEENTRY32W* module) {
+    auto object = As<ModuleSnapshot>(snapshot);
+    if (!object)
+        return FailWith(ERROR_INVALID_HANDLE);
+    if (object->Next >= object->Modules.size())
+        return FailWith(ERROR_NO_MORE_FILES);
+    *module = object->Modules[object->Next++];
+    return TRUE;
+}
+
+BOOL Module32FirstW(HANDLE snapshot, MODULEENTRY32W* module) {
+    auto object = As<ModuleSnapshot>(snapshot);
+    if (!object)
+        return FailWith(ERROR_INVALID_HANDLE);
+    object->Next = 0;
+    return Module32NextW(snapshot, module);
+}
+
+BOOL FreeLibrary(HMODULE) {
+    return FailWith(ERROR_NOT_SUPPORTED);
+}
+#pragma endregion
+
+#pragma region threads and time
+void Sleep(DWORD milliseconds) {
+    timespec duration{ time_t(milliseconds / 1000), long(milliseconds % 1000) * 1000000 };
+    nanosleep(&duration, NULL);
+}
+
+ULONGLONG GetTickCount64() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ULONGLONG(now.tv_sec) * 1000 + ULONGLONG(now.tv_nsec) / 1000000;
+}
+
+void GetLocalTime(SYSTEMTIME* time) {
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    tm local;
+    localtime_r(&now.tv_sec, &local);
+    *time = {
+        .wYear = WORD(local.tm_year + 1900),
+        .wMonth = WORD(local.tm_mon + 1),
+        .wDayOfWeek = WORD(local.tm_wday),
+        .wDay = WORD(local.tm_mday),
+        .wHour = WORD(local.tm_hour),
+        .wMinute = WORD(local.tm_min),
+        .wSecond = WORD(local.tm_sec),
+        .wMilliseconds = WORD(now.tv_nsec / 1000000),
+    };
+}
+
+// counted in nanoseconds
+BOOL QueryPerformanceCounter(LARGE_INTEGER* counter) {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    counter->QuadPart = LONGLONG(now.tv_sec) * 1000000000 + now.tv_nsec;
+    return TRUE;
+}
+
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency) {
+    frequency->QuadPart = 1000000000;
+    return TRUE;
+}
+#pragma endregion
+
+#pragma region windows and input
+// there are no windows, everything about them fails
+BOOL DestroyWindow(HWND) {
+    return FailWith(ERROR_NOT_SUPPORTED);
+}
+
+BOOL GetClientRect(HWND, RECT*) {
+    return FailWith(ERROR_NOT_SUPPORTED);
+}
+
+BOOL GetWindowRect(HWND, RECT*) {
+    return FailWith(ERROR_NOT_SUPPORTED);
+}
+
+BOOL ClientToScreen(HWND, POINT*) {
+    return FailWith(ERROR_NOT_SUPPORTED);
+}
+
+BOOL ScreenToClient(HWND, POINT*) {
+    return FailWith(ERROR_NOT_SUPPORTED);
+}
+
+BOOL AdjustWindowRectEx(RECT*, DWORD, BOOL, DWORD) {
+    return FailWith(ERROR_NOT_SUPPORTED);
+}
+
+LONG_PTR GetWindowLongPtrW(HWND, int) {
+    return FailWith(ERROR_NOT_SUPPORTED);
+}
+
+LONG_PTR SetWindowLongPtrW(HWND, int, LONG_PTR) {
+    return FailWith(ERROR_NOT_SUPPORTED);
+}
+
+BOOL SetWindowPos(HWND, HWND, int, int, int, int, UINT) {
+    return FailWith(ERROR_NOT_SUPPORTED);
+}
+
+HMENU GetMenu(HWND) {
+    FailWith(ERROR_NOT_SUPPORTED);
+    return NULL;
+}
+
+HMONITOR MonitorFromWindow(HWND, DWORD) {
+    FailWith(ERROR_NOT_SUPPORTED);
+    return NULL;
+}
+
+BOOL GetMonitorInfoW(HMONITOR, MONITORINFO*) {
+    return FailWith(ERROR_NOT_SUPPORTED);
+}
+
+BOOL GetCursorPos(POINT*) {
+    return FailWith(ERROR_NOT_SUPPORTED);
+}
+
+HWND GetForegroundWindow() {
+    return NULL;
+}
+
+DWORD GetWindowThreadProcessId(HWND, LPDWORD) {
+    FailWith(ERROR_NOT_SUPPORTED);
+    return 0;
+}
+
+LRESULT SendMessageW(HWND, UINT, WPARAM, LPARAM) {
+    FailWith(ERROR_NOT_SUPPORTED);
+    return 0;
+}
+
+BOOL PostMessageW(HWND, UINT, WPARAM, LPARAM) {
+    return FailWith(ERROR_NOT_SUPPORTED);
+}
+
+UINT SendInput(UINT, INPUT*, int) {
+    FailWith(ERROR_NOT_SUPPORTED);
+    return 0;
+}
+
+UINT MapVirtualKeyW(UINT, UINT) {
+    return 0;
+}
+#pragma endregion
+}
@@ -0,0 +1,3 @@
+#pragma once
+// the usages are defined in windows.h
+#include <windows.h>
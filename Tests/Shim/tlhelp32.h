@@ -0,0 +1,25 @@
+#pragma once
+#include <windows.h>
+
+#define TH32CS_SNAPMODULE 0x8
+#define TH32CS_SNAPMODULE32 0x10
+#define MAX_MODULE_NAME32 255
+
+typedef struct {
+    DWORD   dwSize;
+    DWORD   th32ModuleID;
+    DWORD   th32ProcessID;
+    DWORD   GlblcntUsage;
+    DWORD   ProccntUsage;
+    BYTE*   modBaseAddr;
+    DWORD   modBaseSize;
+    HMODULE hModule;
+    WCHAR   szModule[MAX_MODULE_NAME32 + 1];
+    WCHAR   szExePath[MAX_PATH];
+} MODULEENTRY32W;
+
+extern "C" {
+HANDLE CreateToolhelp32Snapshot(DWORD flags, DWORD processId);
+BOOL Module32FirstW(HANDLE snapshot, MODULEENTRY32W* module);
+BOOL Module32NextW(HANDLE snapshot, MODULEENTRY32W* module);
+}
@@ -0,0 +1,434 @@
+#pragma once
+// The part of the Win32 API the portable sources use, so they build on other platforms for the tests.
+// DWORD is unsigned long like in the SDK, which makes it pointer sized on LP64, as it is in the 32-bit DLL.
+// Windows.cpp implements what the tests reach on top of POSIX, everything else fails with ERROR_NOT_SUPPORTED.
+#include <cstdint>
+#include <cstddef>
+#include <cwchar>
+#include <cstring>
+#include <cstdlib>
+
+#define __declspec(x)
+#define __stdcall
+#define WINAPI
+#define CALLBACK
+#define APIENTRY
+
+#pragma region types
+typedef unsigned long       DWORD, *PDWORD, *LPDWORD;
+typedef unsigned char       BYTE, *PBYTE, UCHAR;
+typedef unsigned short      WORD;
+typedef int                 BOOL;
+typedef long                LONG;
+typedef short               SHORT;
+typedef unsigned int        UINT;
+typedef unsigned long       ULONG;
+typedef long long           LONGLONG;
+typedef unsigned long long  ULONGLONG;
+typedef float               FLOAT;
+typedef char                CHAR;
+typedef wchar_t             WCHAR;
+typedef long                HRESULT;
+typedef size_t              SIZE_T;
+typedef uintptr_t           WPARAM, DWORD_PTR, ULONG_PTR;
+typedef intptr_t            LPARAM, LRESULT, LONG_PTR;
+
+typedef void                *HANDLE, *PVOID, *LPVOID, *HGLOBAL, *HMONITOR, *HMENU;
+typedef const void          *LPCVOID;
+typedef const char          *LPCSTR;
+typedef char                *LPSTR, *PSTR;
+typedef const wchar_t       *LPCWSTR;
+typedef wchar_t             *LPWSTR, *PWSTR;
+typedef struct HINSTANCE__  *HINSTANCE, *HMODULE;
+typedef struct HWND__       *HWND;
+typedef struct HHOOK__      *HHOOK;
+typedef struct HCURSOR__    *HCURSOR;
+typedef struct HRAWINPUT__  *HRAWINPUT;
+
+typedef union {
+    struct { DWORD LowPart; LONG HighPart; };
+    LONGLONG QuadPart;
+} LARGE_INTEGER;
+typedef struct { DWORD dwLowDateTime; DWORD dwHighDateTime; } FILETIME;
+typedef struct { WORD wYear, wMonth, wDayOfWeek, wDay, wHour, wMinute, wSecond, wMilliseconds; } SYSTEMTIME;
+typedef struct {
+    DWORD dwFileAttributes;
+    FILETIME ftCreationTime, ftLastAccessTime, ftLastWriteTime;
+    DWORD nFileSizeHigh, nFileSizeLow;
+} WIN32_FILE_ATTRIBUTE_DATA;
+enum GET_FILEEX_INFO_LEVELS { GetFileExInfoStandard };
+
+typedef struct { LONG x, y; } POINT;
+typedef struct { LONG cx, cy; } SIZE;
+typedef struct { LONG left, top, right, bottom; } RECT;
+typedef struct { HWND hwnd; UINT message; WPARAM wParam; LPARAM lParam; DWORD time; POINT pt; } MSG, *PMSG;
+typedef struct { LRESULT lResult; LPARAM lParam; WPARAM wParam; UINT message; HWND hwnd; } CWPRETSTRUCT, *PCWPRETSTRUCT;
+typedef struct { DWORD cbSize; RECT rcMonitor; RECT rcWork; DWORD dwFlags; } MONITORINFO;
+
+typedef struct {
+    PVOID BaseAddress;
+    PVOID AllocationBase;
+    DWORD AllocationProtect;
+    SIZE_T RegionSize;
+    DWORD State;
+    DWORD Protect;
+    DWORD Type;
+} MEMORY_BASIC_INFORMATION;
+typedef struct {
+    WORD wProcessorArchitecture;
+    WORD wReserved;
+    DWORD dwPageSize;
+    LPVOID lpMinimumApplicationAddress;
+    LPVOID lpMaximumApplicationAddress;
+    DWORD_PTR dwActiveProcessorMask;
+    DWORD dwNumberOfProcessors;
+    DWORD dwProcessorType;
+    DWORD dwAllocationGranularity;
+    WORD wProcessorLevel;
+    WORD wProcessorRevision;
+} SYSTEM_INFO;
+
+typedef struct { WORD wVk; WORD wScan; DWORD dwFlags; DWORD time; ULONG_PTR dwExtraInfo; } KEYBDINPUT;
+typedef struct { LONG dx, dy; DWORD mouseData, dwFlags, time; ULONG_PTR dwExtraInfo; } MOUSEINPUT;
+typedef struct { DWORD type; union { MOUSEINPUT mi; KEYBDINPUT ki; }; } INPUT;
+typedef struct { WORD usUsagePage; WORD usUsage; DWORD dwFlags; HWND hwndTarget; } RAWINPUTDEVICE;
+typedef struct { DWORD dwType; DWORD dwSize; HANDLE hDevice; WPARAM wParam; } RAWINPUTHEADER;
+typedef struct {
+    WORD usFlags;
+    union { ULONG ulButtons; struct { WORD usButtonFlags; WORD usButtonData; }; };
+    ULONG ulRawButtons;
+    LONG lLastX;
+    LONG lLastY;
+    ULONG ulExtraInformation;
+} RAWMOUSE;
+typedef struct { RAWINPUTHEADER header; union { RAWMOUSE mouse; } data; } RAWINPUT;
+
+typedef struct { WORD e_magic; WORD e_unused[29]; LONG e_lfanew; } IMAGE_DOS_HEADER, *PIMAGE_DOS_HEADER;
+typedef struct { DWORD VirtualAddress; DWORD Size; } IMAGE_DATA_DIRECTORY;
+typedef struct {
+    WORD Machine;
+    WORD NumberOfSections;
+    DWORD TimeDateStamp;
+    DWORD PointerToSymbolTable;
+    DWORD NumberOfSymbols;
+    WORD SizeOfOptionalHeader;
+    WORD Characteristics;
+} IMAGE_FILE_HEADER;
+typedef struct { DWORD SizeOfImage; IMAGE_DATA_DIRECTORY DataDirectory[16]; } IMAGE_OPTIONAL_HEADER;
+typedef struct { DWORD Signature; IMAGE_FILE_HEADER FileHeader; IMAGE_OPTIONAL_HEADER OptionalHeader; } IMAGE_NT_HEADERS, *PIMAGE_NT_HEADERS;
+typedef struct {
+    BYTE Name[8];
+    union { DWORD VirtualSize; } Misc;
+    DWORD VirtualAddress;
+    DWORD SizeOfRawData;
+    DWORD PointerToRawData;
+    DWORD PointerToRelocations;
+    DWORD PointerToLinenumbers;
+    WORD NumberOfRelocations;
+    WORD NumberOfLinenumbers;
+    DWORD Characteristics;
+} IMAGE_SECTION_HEADER, *PIMAGE_SECTION_HEADER;
+typedef struct {
+    DWORD Characteristics;
+    DWORD TimeDateStamp;
+    DWORD ForwarderChain;
+    DWORD Name;
+    DWORD FirstThunk;
+} IMAGE_IMPORT_DESCRIPTOR, *PIMAGE_IMPORT_DESCRIPTOR;
+#pragma endregion
+
+#pragma region constants
+#define TRUE 1
+#define FALSE 0
+#define MAX_PATH 260
+#define MAXDWORD 0xffffffff
+#define INFINITE 0xFFFFFFFF
+#define INVALID_HANDLE_VALUE ((HANDLE)(intptr_t)-1)
+
+#define ERROR_SUCCESS 0L
+#define ERROR_FILE_NOT_FOUND 2L
+#define ERROR_BAD_FORMAT 11L
+#define ERROR_BAD_LENGTH 24L
+#define ERROR_NOT_SUPPORTED 50L
+#define ERROR_ALREADY_EXISTS 183L
+#define ERROR_FILENAME_EXCED_RANGE 206L
+#define ERROR_FILE_TOO_LARGE 223L
+#define ERROR_PARTIAL_COPY 299L
+#define ERROR_NOACCESS 998L
+
+#define MB_OK 0x0L
+#define MB_ICONERROR 0x10L
+#define MB_ICONWARNING 0x30L
+#define MB_ICONINFORMATION 0x40L
+
+#define GENERIC_READ 0x80000000
+#define GENERIC_WRITE 0x40000000
+#define FILE_SHARE_READ 0x1
+#define FILE_SHARE_WRITE 0x2
+#define FILE_SHARE_DELETE 0x4
+#define CREATE_ALWAYS 2
+#define OPEN_EXISTING 3
+#define FILE_ATTRIBUTE_NORMAL 0x80
+#define MOVEFILE_REPLACE_EXISTING 0x1
+#define FILE_MAP_WRITE 0x2
+#define FILE_MAP_READ 0x4
+#define FILE_MAP_ALL_ACCESS 0xF001F
+
+#define PAGE_NOACCESS 0x01
+#define PAGE_READONLY 0x02
+#define PAGE_READWRITE 0x04
+#define PAGE_WRITECOPY 0x08
+#define PAGE_EXECUTE 0x10
+#define PAGE_EXECUTE_READ 0x20
+#define PAGE_EXECUTE_READWRITE 0x40
+#define PAGE_EXECUTE_WRITECOPY 0x80
+#define PAGE_GUARD 0x100
+#define MEM_COMMIT 0x1000
+#define MEM_FREE 0x10000
+#define MEM_PRIVATE 0x20000
+#define MEM_MAPPED 0x40000
+#define MEM_IMAGE 0x1000000
+
+#define IMAGE_DIRECTORY_ENTRY_IMPORT 1
+#define IMAGE_SCN_CNT_CODE 0x20
+#define IMAGE_SCN_MEM_EXECUTE 0x20000000
+#define IMAGE_SCN_MEM_READ 0x40000000
+#define IMAGE_FIRST_SECTION(nt) ((PIMAGE_SECTION_HEADER)((nt) + 1))
+
+#define PROCESS_VM_READ 0x10
+#define PROCESS_QUERY_INFORMATION 0x400
+#define PROCESS_QUERY_LIMITED_INFORMATION 0x1000
+#define SYNCHRONIZE 0x00100000L
+#define TIMER_ALL_ACCESS 0x1F0003
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x2
+#define WAIT_OBJECT_0 0
+#define THREAD_PRIORITY_ABOVE_NORMAL 1
+#define THREAD_PRIORITY_HIGHEST 2
+#define GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS 0x4
+#define STD_OUTPUT_HANDLE ((DWORD)-11)
+#define ATTACH_PARENT_PROCESS ((DWORD)-1)
+
+#define CP_UTF8 65001
+#define LOCALE_NAME_INVARIANT L""
+#define LCMAP_UPPERCASE 0x200
+#define CSTR_EQUAL 2
+#define FORMAT_MESSAGE_ALLOCATE_BUFFER 0x100
+#define FORMAT_MESSAGE_IGNORE_INSERTS 0x200
+#define FORMAT_MESSAGE_FROM_SYSTEM 0x1000
+#define LANG_NEUTRAL 0x00
+#define SUBLANG_DEFAULT 0x01
+#define MAKELANGID(p, s) ((((WORD)(s)) << 10) | (WORD)(p))
+
+#define WM_NULL 0x0000
+#define WM_MOVE 0x0003
+#define WM_SIZE 0x0005
+#define WM_SETCURSOR 0x0020
+#define WM_INPUT 0x00FF
+#define WM_KEYDOWN 0x0100
+#define WM_KEYUP 0x0101
+#define WM_LBUTTONDOWN 0x0201
+#define WM_LBUTTONUP 0x0202
+#define WM_RBUTTONDOWN 0x0204
+#define WM_RBUTTONUP 0x0205
+#define WM_MBUTTONDOWN 0x0207
+#define WM_MBUTTONUP 0x0208
+#define WM_APP 0x8000
+#define SIZE_RESTORED 0
+#define SIZE_MINIMIZED 1
+#define HC_ACTION 0
+#define HTCLIENT 1
+
+#define INPUT_KEYBOARD 1
+#define KEYEVENTF_EXTENDEDKEY 0x1
+#define KEYEVENTF_KEYUP 0x2
+#define MAPVK_VK_TO_VSC 0
+#define RID_INPUT 0x10000003
+#define RIM_TYPEMOUSE 0
+#define RIDEV_INPUTSINK 0x100
+#define MOUSE_MOVE_ABSOLUTE 1
+#define SPI_GETMOUSE 0x3
+#define SPI_GETMOUSESPEED 0x70
+
+#define GWL_STYLE (-16)
+#define GWL_EXSTYLE (-20)
+#define WS_MAXIMIZEBOX 0x00010000L
+#define WS_MINIMIZEBOX 0x00020000L
+#define WS_SIZEBOX 0x00040000L
+#define WS_SYSMENU 0x00080000L
+#define WS_CAPTION 0x00C00000L
+#define WS_EX_DLGMODALFRAME 0x1L
+#define WS_EX_CLIENTEDGE 0x200L
+#define WS_EX_STATICEDGE 0x20000L
+#define SWP_NOZORDER 0x4
+#define SWP_FRAMECHANGED 0x20
+#define SWP_NOOWNERZORDER 0x200
+#define SWP_NOREPOSITION SWP_NOOWNERZORDER
+#define MONITOR_DEFAULTTOPRIMARY 0x1
+
+#define VK_SHIFT 0x10
+#define VK_PRIOR 0x21
+#define VK_NEXT 0x22
+#define VK_END 0x23
+#define VK_HOME 0x24
+#define VK_LEFT 0x25
+#define VK_UP 0x26
+#define VK_RIGHT 0x27
+#define VK_DOWN 0x28
+#define VK_INSERT 0x2D
+#define VK_DELETE 0x2E
+#define VK_LWIN 0x5B
+#define VK_RWIN 0x5C
+#define VK_APPS 0x5D
+#define VK_SLEEP 0x5F
+#define VK_DIVIDE 0x6F
+#define VK_LSHIFT 0xA0
+#define VK_RCONTROL 0xA3
+#define VK_RMENU 0xA5
+#define VK_BROWSER_BACK 0xA6
+#define VK_BROWSER_FORWARD 0xA7
+#define VK_BROWSER_REFRESH 0xA8
+#define VK_BROWSER_STOP 0xA9
+#define VK_BROWSER_SEARCH 0xAA
+#define VK_BROWSER_FAVORITES 0xAB
+#define VK_BROWSER_HOME 0xAC
+#define VK_VOLUME_MUTE 0xAD
+#define VK_VOLUME_DOWN 0xAE
+#define VK_VOLUME_UP 0xAF
+#define VK_MEDIA_NEXT_TRACK 0xB0
+#define VK_MEDIA_PREV_TRACK 0xB1
+#define VK_MEDIA_STOP 0xB2
+#define VK_MEDIA_PLAY_PAUSE 0xB3
+#define VK_LAUNCH_MAIL 0xB4
+#define VK_LAUNCH_MEDIA_SELECT 0xB5
+#define VK_LAUNCH_APP1 0xB6
+#define VK_LAUNCH_APP2 0xB7
+
+#define HID_USAGE_PAGE_GENERIC 0x01
+#define HID_USAGE_GENERIC_MOUSE 0x02
+
+#define EXCEPTION_ACCESS_VIOLATION 0xC0000005UL
+#define EXCEPTION_CONTINUE_SEARCH 0
+#define EXCEPTION_EXECUTE_HANDLER 1
+#pragma endregion
+
+#pragma region macros
+#define ARRAYSIZE(a) (sizeof(a) / sizeof((a)[0]))
+#define LOWORD(l) ((WORD)((DWORD_PTR)(l) & 0xffff))
+#define HIWORD(l) ((WORD)(((DWORD_PTR)(l) >> 16) & 0xffff))
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+#define UNREFERENCED_PARAMETER(p) (void)(p)
+#define YieldProcessor() ((void)0)
+#pragma endregion
+
+extern "C" {
+#pragma region errors and messages
+DWORD GetLastError();
+void SetLastError(DWORD error);
+DWORD FormatMessageA(DWORD flags, LPCVOID source, DWORD messageId, DWORD languageId, LPSTR buffer, DWORD size, void* arguments);
+HGLOBAL LocalFree(HGLOBAL memory);
+int MessageBoxA(HWND window, LPCSTR text, LPCSTR caption, UINT type);
+int MessageBoxW(HWND window, LPCWSTR text, LPCWSTR caption, UINT type);
+HANDLE GetStdHandle(DWORD stdHandle);
+BOOL AttachConsole(DWORD processId);
+#pragma endregion
+
+#pragma region files and mappings
+HANDLE CreateFileA(LPCSTR path, DWORD access, DWORD shareMode, void* security, DWORD disposition, DWORD flags, HANDLE templateFile);
+HANDLE CreateFileW(LPCWSTR path, DWORD access, DWORD shareMode, void* security, DWORD disposition, DWORD flags, HANDLE templateFile);
+BOOL ReadFile(HANDLE file, LPVOID buffer, DWORD size, LPDWORD read, void* overlapped);
+BOOL WriteFile(HANDLE file, LPCVOID buffer, DWORD size, LPDWORD written, void* overlapped);
+BOOL GetFileSizeEx(HANDLE file, LARGE_INTEGER* size);
+BOOL GetFileTime(HANDLE file, FILETIME* creation, FILETIME* lastAccess, FILETIME* lastWrite);
+BOOL GetFileAttributesExA(LPCSTR path, GET_FILEEX_INFO_LEVELS level, LPVOID information);
+BOOL DeleteFileA(LPCSTR path);
+BOOL DeleteFileW(LPCWSTR path);
+BOOL MoveFileExA(LPCSTR from, LPCSTR to, DWORD flags);
+BOOL MoveFileExW(LPCWSTR from, LPCWSTR to, DWORD flags);
+DWORD GetFullPathNameW(LPCWSTR path, DWORD size, LPWSTR buffer, LPWSTR* filePart);
+HANDLE CreateFileMappingA(HANDLE file, void* security, DWORD protect, DWORD sizeHigh, DWORD sizeLow, LPCSTR name);
+HANDLE CreateFileMappingW(HANDLE file, void* security, DWORD protect, DWORD sizeHigh, DWORD sizeLow, LPCWSTR name);
+HANDLE OpenFileMappingA(DWORD access, BOOL inherit, LPCSTR name);
+HANDLE OpenFileMappingW(DWORD access, BOOL inherit, LPCWSTR name);
+LPVOID MapViewOfFile(HANDLE mapping, DWORD access, DWORD offsetHigh, DWORD offsetLow, SIZE_T size);
+BOOL UnmapViewOfFile(LPCVOID address);
+BOOL CloseHandle(HANDLE handle);
+#pragma endregion
+
+#pragma region strings
+int MultiByteToWideChar(UINT codePage, DWORD flags, LPCSTR input, int inputSize, LPWSTR output, int outputSize);
+int WideCharToMultiByte(UINT codePage, DWORD flags, LPCWSTR input, int inputSize, LPSTR output, int outputSize, LPCSTR defaultChar, BOOL* usedDefaultChar);
+int LCMapStringEx(LPCWSTR locale, DWORD flags, LPCWSTR input, int inputSize, LPWSTR output, int outputSize, void* version, void* reserved, LPARAM sortHandle);
+int CompareStringOrdinal(LPCWSTR left, int leftSize, LPCWSTR right, int rightSize, BOOL ignoreCase);
+int lstrlenW(LPCWSTR string);
+int _stricmp(const char* left, const char* right);
+int _strnicmp(const char* left, const char* right, size_t size);
+int _wcsicmp(const wchar_t* left, const wchar_t* right);
+int _wcsnicmp(const wchar_t* left, const wchar_t* right, size_t size);
+#pragma endregion
+
+#pragma region processes and memory
+HANDLE GetCurrentProcess();
+DWORD GetCurrentProcessId();
+DWORD GetCurrentThreadId();
+HANDLE OpenProcess(DWORD access, BOOL inherit, DWORD processId);
+BOOL ReadProcessMemory(HANDLE process, LPCVOID address, LPVOID buffer, SIZE_T size, SIZE_T* read);
+SIZE_T VirtualQuery(LPCVOID address, MEMORY_BASIC_INFORMATION* information, SIZE_T size);
+SIZE_T VirtualQueryEx(HANDLE process, LPCVOID address, MEMORY_BASIC_INFORMATION* information, SIZE_T size);
+void GetSystemInfo(SYSTEM_INFO* information);
+BOOL IsProcessorFeaturePresent(DWORD feature);
+HMODULE GetModuleHandleA(LPCSTR name);
+HMODULE GetModuleHandleW(LPCWSTR name);
+BOOL GetModuleHandleExW(DWORD flags, LPCWSTR name, HMODULE* module);
+DWORD GetModuleFileNameW(HMODULE module, LPWSTR path, DWORD size);
+HMODULE LoadLibraryW(LPCWSTR path);
+BOOL FreeLibrary(HMODULE module);
+[[noreturn]] void FreeLibraryAndExitThread(HMODULE module, DWORD exitCode);
+void* GetProcAddress(HMODULE module, LPCSTR name);
+#pragma endregion
+
+#pragma region threads and time
+HANDLE CreateThread(void* security, SIZE_T stackSize, DWORD (*start)(LPVOID), LPVOID parameter, DWORD flags, LPDWORD threadId);
+BOOL SetThreadPriority(HANDLE thread, int priority);
+HANDLE CreateEventW(void* security, BOOL manualReset, BOOL initialState, LPCWSTR name);
+BOOL SetEvent(HANDLE event);
+HANDLE CreateWaitableTimerExW(void* security, LPCWSTR name, DWORD flags, DWORD access);
+BOOL SetWaitableTimer(HANDLE timer, const LARGE_INTEGER* dueTime, LONG period, void* completion, void* argument, BOOL resume);
+DWORD WaitForSingleObject(HANDLE handle, DWORD milliseconds);
+DWORD WaitForMultipleObjects(DWORD count, const HANDLE* handles, BOOL waitAll, DWORD milliseconds);
+void Sleep(DWORD milliseconds);
+ULONGLONG GetTickCount64();
+void GetLocalTime(SYSTEMTIME* time);
+BOOL QueryPerformanceCounter(LARGE_INTEGER* counter);
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency);
+#pragma endregion
+
+#pragma region windows and input
+HWND GetForegroundWindow();
+DWORD GetWindowThreadProcessId(HWND window, LPDWORD processId);
+BOOL IsIconic(HWND window);
+BOOL DestroyWindow(HWND window);
+BOOL GetClientRect(HWND window, RECT* rect);
+BOOL GetWindowRect(HWND window, RECT* rect);
+BOOL ClientToScreen(HWND window, POINT* point);
+BOOL ScreenToClient(HWND window, POINT* point);
+BOOL AdjustWindowRectEx(RECT* rect, DWORD style, BOOL menu, DWORD exStyle);
+LONG_PTR GetWindowLongPtrW(HWND window, int index);
+LONG_PTR SetWindowLongPtrW(HWND window, int index, LONG_PTR value);
+BOOL SetWindowPos(HWND window, HWND insertAfter, int x, int y, int cx, int cy, UINT flags);
+HMENU GetMenu(HWND window);
+HMONITOR MonitorFromWindow(HWND window, DWORD flags);
+BOOL GetMonitorInfoW(HMONITOR monitor, MONITORINFO* information);
+BOOL GetCursorPos(POINT* point);
+BOOL GetPhysicalCursorPos(POINT* point);
+BOOL SystemParametersInfoW(UINT action, UINT param, PVOID value, UINT winIni);
+LRESULT SendMessageW(HWND window, UINT message, WPARAM wParam, LPARAM lParam);
+BOOL PostMessageW(HWND window, UINT message, WPARAM wParam, LPARAM lParam);
+UINT SendInput(UINT count, INPUT* inputs, int size);
+UINT MapVirtualKeyW(UINT code, UINT mapType);
+LRESULT CallNextHookEx(HHOOK hook, int code, WPARAM wParam, LPARAM lParam);
+UINT GetRawInputData(HRAWINPUT rawInput, UINT command, LPVOID data, UINT* size, UINT headerSize);
+BOOL RegisterRawInputDevices(const RAWINPUTDEVICE* devices, UINT count, UINT size);
+UINT GetRegisteredRawInputDevices(RAWINPUTDEVICE* devices, UINT* count, UINT size);
+#pragma endregion
+}
@@ -0,0 +1,3 @@
+#pragma once
+// the error codes are defined in windows.h
+#include <windows.h>
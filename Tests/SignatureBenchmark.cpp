@@ -0,0 +1,54 @@
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Signature.h"
+
+namespace signature = common::signature;
+
+using namespace std;
+
+// the byte-by-byte search Find replaced
+const BYTE* FindByteByByte(const Signature& signature, const BYTE* begin, const BYTE* end) {
+    for (auto position = begin; end - position >= signature.Length; position++) {
+        auto i = 0;
+        while (i < signature.Length && ((position[i] ^ signature.Bytes[i]) & signature.Mask[i]) == 0)
+            i++;
+        if (i == signature.Length)
+            return position;
+    }
+    return nullptr;
+}
+
+// A 64 MB module of random code bytes with the signature only at its end, the worst case of a scan when a game starts.
+// memchr for a byte that isn't there reads the whole buffer too, as a bound of what a scan can reach.
+int main(int argc, char** argv) {
+    benchmark::ParseArguments(argc, argv);
+    constexpr size_t Size = 64 << 20;
+    constexpr double Megabytes = Size / double(1 << 20);
+    vector<BYTE> module(Size);
+    mt19937 random(13);
+    for (auto& byte : module)
+        byte = BYTE(uniform_int_distribution<int>(0, 0xFD)(random));
+    const BYTE instruction[]{ 0x8B, 0x0D, 0x11, 0x22, 0x33, 0x44, 0x85, 0xC9 };
+    memcpy(module.data() + Size - sizeof(instruction), instruction, sizeof(instruction));
+
+    Signature pattern;
+    auto [message, location] = signature::Parse("8B 0D ?? ?? ?? ?? 85 C9", pattern);
+    auto begin = module.data();
+    auto end = begin + Size;
+    if (message != nullptr || signature::Find(pattern, begin, end) != end - sizeof(instruction))
+        return 1;
+
+    benchmark::Measure("Signature/Find", Megabytes, "MB", [&] {
+        benchmark::DoNotOptimize(signature::Find(pattern, begin, end));
+    });
+    benchmark::Measure("ByteByByte/Find", Megabytes, "MB", [&] {
+        benchmark::DoNotOptimize(FindByteByByte(pattern, begin, end));
+    });
+    benchmark::Measure("memchr/MissingByte", Megabytes, "MB", [&] {
+        benchmark::DoNotOptimize(memchr(begin, 0xFE, Size));
+    });
+    return 0;
+}
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Signature.h"
+
+namespace signature = common::signature;
+
+using namespace std;
+
+Signature ParseOrFail(string_view source) {
+    Signature result;
+    auto [message, location] = signature::Parse(source, result);
+    EXPECT_EQ(message, nullptr) << source << ": " << message << " at \"" << location << '"';
+    return result;
+}
+
+TEST(SignatureParse, BytesWildcardsAndOffset) {
+    auto result = ParseOrFail("A1 ?? ?? ?? ?? 8B 4? 04+1");
+    ASSERT_EQ(result.Length, 8);
+    EXPECT_EQ(result.Bytes[0], 0xA1);
+    EXPECT_EQ(result.Mask[0], 0xFF);
+    EXPECT_EQ(result.Mask[1], 0x00);
+    EXPECT_EQ(result.Bytes[6], 0x40);
+    EXPECT_EQ(result.Mask[6], 0xF0);
+    EXPECT_EQ(result.Offset, 1u);
+}
+
+TEST(SignatureParse, SpacesAndOffsetAreOptional) {
+    auto result = ParseOrFail("a1??8b");
+    EXPECT_EQ(result.Length, 3);
+    EXPECT_EQ(result.Bytes[2], 0x8B);
+    EXPECT_EQ(result.Offset, 0u);
+}
+
+struct ParseError {
+    const char* Source;
+    const char* Message;
+    const char* Location;
+};
+
+TEST(SignatureParse, ErrorsPointAtTheirSource) {
+    auto tooLong = string(33 * 2, 'A');
+    const ParseError errors[]{
+        { "A1 8 B", "expected the second digit of the byte", " " },
+        { "A1 8", "expected the second digit of the byte", "8" },
+        { "A1 G8", "expected a hexadecimal digit or ?", "G" },
+        { "A1+x", "invalid format", "x" },
+        { "+4", "expected a byte pattern", "" },
+        { "?? ?F", "needs at least one byte without wildcards", "?? ?F" },
+        { tooLong.c_str(), "too many bytes, at most 32 are allowed", "AA" },
+    };
+    for (auto& error : errors) {
+        Signature result;
+        auto [message, location] = signature::Parse(error.Source, result);
+        if (message == nullptr) {
+            ADD_FAILURE() << error.Source << ": parsed";
+            continue;
+        }
+        EXPECT_STREQ(message, error.Message) << error.Source;
+        EXPECT_EQ(location, error.Location) << error.Source;
+    }
+}
+
+// Bytes that end where an unreadable page starts, so a scan that reads past the end crashes the test.
+class GuardedBuffer {
+public:
+    explicit GuardedBuffer(size_t size) {
+        auto pageSize = size_t(sysconf(_SC_PAGESIZE));
+        mappedSize = (size + pageSize - 1) / pageSize * pageSize + pageSize;
+        mapped = (BYTE*)mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        EXPECT_NE(mapped, MAP_FAILED);
+        EXPECT_EQ(mprotect(mapped + mappedSize - pageSize, pageSize, PROT_NONE), 0);
+        begin = mapped + mappedSize - pageSize - size;
+        end = begin + size;
+    }
+    ~GuardedBuffer() {
+        munmap(mapped, mappedSize);
+    }
+    BYTE* begin;
+    BYTE* end;
+private:
+    BYTE* mapped;
+    size_t mappedSize;
+};
+
+const BYTE* FindNaive(const Signature& signature, const BYTE* begin, const BYTE* end) {
+    for (auto position = begin; end - position >= signature.Length; position++) {
+        auto i = 0;
+        while (i < signature.Length && ((position[i] ^ signature.Bytes[i]) & signature.Mask[i]) == 0)
+            i++;
+        if (i == signature.Length)
+            return position;
+    }
+    return nullptr;
+}
+
+TEST(SignatureFind, FirstMatchAnywhereInTheBuffer) {
+    auto pattern = ParseOrFail("8B 0D ?? ?? ?? ?? 85 C9");
+    // the vector loops take 64 and 32 bytes, around these sizes the scan changes from one loop to the next
+    for (size_t size : { 8, 31, 32, 33, 63, 64, 65, 95, 96, 127, 128, 129, 200 }) {
+        for (size_t at = 0; at + pattern.Length <= size; at++) {
+            GuardedBuffer buffer(size);
+            memset(buffer.begin, 0x90, size);
+            const BYTE bytes[]{ 0x8B, 0x0D, 0x11, 0x22, 0x33, 0x44, 0x85, 0xC9 };
+            memcpy(buffer.begin + at, bytes, sizeof(bytes));
+            EXPECT_EQ(signature::Find(pattern, buffer.begin, buffer.end), buffer.begin + at) << size << " " << at;
+        }
+    }
+}
+
+TEST(SignatureFind, NoMatch) {
+    auto pattern = ParseOrFail("8B 0D");
+    GuardedBuffer buffer(100);
+    memset(buffer.begin, 0x8B, 100);
+    EXPECT_EQ(signature::Find(pattern, buffer.begin, buffer.end), nullptr);
+    EXPECT_EQ(signature::Find(pattern, buffer.begin, buffer.begin + 1), nullptr);
+    EXPECT_EQ(signature::Find(pattern, buffer.begin, buffer.begin), nullptr);
+}
+
+// Both anchors are bytes without wildcards, a byte with one wildcard nibble is checked afterwards.
+TEST(SignatureFind, PartialWildcardBytes) {
+    auto pattern = ParseOrFail("4? 8B ?5");
+    GuardedBuffer buffer(64);
+    memset(buffer.begin, 0, 64);
+    const BYTE miss[]{ 0x50, 0x8B, 0x45 };
+    const BYTE hit[]{ 0x47, 0x8B, 0xF5 };
+    memcpy(buffer.begin + 10, miss, sizeof(miss));
+    memcpy(buffer.begin + 40, hit, sizeof(hit));
+    EXPECT_EQ(signature::Find(pattern, buffer.begin, buffer.end), buffer.begin + 40);
+}
+
+// Random patterns over few distinct bytes, so the anchors match often and candidates are rejected often.
+TEST(SignatureFind, MatchesANaiveSearch) {
+    mt19937 random(1013);
+    auto byteOf = [&] { return BYTE(uniform_int_distribution<int>(0, 3)(random) * 0x11); };
+    for (auto n = 0; n < 20000; n++) {
+        Signature pattern{ .Length = uniform_int_distribution<int>(1, SIGNATURE_MAX_LEN)(random) };
+        for (auto i = 0; i < pattern.Length; i++) {
+            auto kind = uniform_int_distribution<int>(0, 9)(random);
+            pattern.Bytes[i] = byteOf();
+            pattern.Mask[i] = kind < 6 ? 0xFF : kind < 8 ? 0x00 : kind == 8 ? 0xF0 : 0x0F;
+            pattern.Bytes[i] &= pattern.Mask[i];
+        }
+        auto size = uniform_int_distribution<size_t>(0, 300)(random);
+        GuardedBuffer buffer(size);
+        for (auto position = buffer.begin; position < buffer.end; position++)
+            *position = byteOf();
+        // some of the time, make sure there is a match
+        if (size >= size_t(pattern.Length) && n % 2 == 0) {
+            auto at = uniform_int_distribution<size_t>(0, size - pattern.Length)(random);
+            for (auto i = 0; i < pattern.Length; i++)
+                buffer.begin[at + i] = (buffer.begin[at + i] & ~pattern.Mask[i]) | pattern.Bytes[i];
+        }
+        ASSERT_EQ(signature::Find(pattern, buffer.begin, buffer.end), FindNaive(pattern, buffer.begin, buffer.end)) << n;
+    }
+}
+
+// A module with the headers Resolve walks and one section at 0x1000.
+class FakeModule : public testing::Test {
+protected:
+    static constexpr DWORD SectionAddress = 0x1000;
+    static constexpr DWORD SectionSize = 0x1000;
+    vector<BYTE> image = vector<BYTE>(SectionAddress + SectionSize);
+    HMODULE module = HMODULE(image.data());
+
+    void SetUp() override {
+        auto dosHeader = (PIMAGE_DOS_HEADER)image.data();
+        dosHeader->e_lfanew = 0x40;
+        auto ntHeaders = (PIMAGE_NT_HEADERS)(image.data() + dosHeader->e_lfanew);
+        ntHeaders->FileHeader.NumberOfSections = 1;
+        auto section = IMAGE_FIRST_SECTION(ntHeaders);
+        section->VirtualAddress = SectionAddress;
+        section->Misc.VirtualSize = SectionSize;
+        section->Characteristics = IMAGE_SCN_MEM_READ;
+    }
+
+    // "mov ecx, [address]" at the offset of the section, with an address in the module
+    void PlaceInstruction(DWORD offset, DWORD rva) {
+        auto code = image.data() + SectionAddress + offset;
+        code[0] = 0x8B;
+        code[1] = 0x0D;
+        auto address = DWORD(image.data()) + rva;
+        memcpy(code + 2, &address, sizeof(address));
+    }
+};
+
+TEST_F(FakeModule, ResolveGivesTheRvaOfTheAddress) {
+    PlaceInstruction(0x123, 0x1800);
+    EXPECT_EQ(signature::Resolve(ParseOrFail("8B 0D+2"), module), 0x1800u);
+}
+
+TEST_F(FakeModule, ApplyToFillsInTheFirstOffset) {
+    PlaceInstruction(0x40, 0x1A00);
+    GameConfig gameConfig{};
+    gameConfig.Signature = ParseOrFail("8B 0D+2");
+    gameConfig.Address = { .Length = 2, .Level = { 0, 0x10 } };
+    EXPECT_TRUE(signature::ApplyTo(gameConfig, module));
+    EXPECT_EQ(gameConfig.Address.Level[0], 0x1A00u);
+    EXPECT_EQ(gameConfig.Address.Length, 2);
+}
+
+TEST_F(FakeModule, ApplyToEmptiesTheChainWhenNotFound) {
+    GameConfig gameConfig{};
+    gameConfig.Signature = ParseOrFail("8B 0D+2");
+    gameConfig.Address = { .Length = 2, .Level = { 0, 0x10 } };
+    EXPECT_FALSE(signature::ApplyTo(gameConfig, module));
+    EXPECT_EQ(gameConfig.Address.Length, 0);
+}
+
+TEST_F(FakeModule, ApplyToKeepsAChainWithoutSignature) {
+    GameConfig gameConfig{};
+    gameConfig.Address = { .Length = 1, .Level = { 0x1234 } };
+    EXPECT_TRUE(signature::ApplyTo(gameConfig, module));
+    EXPECT_EQ(gameConfig.Address.Level[0], 0x1234u);
+}
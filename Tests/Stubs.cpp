@@ -0,0 +1,32 @@
+#include "framework.h"
+#include "Lua.h"
+#include "LuaJIT.h"
+#include "NeoLua.h"
+#include "InputDetermine.h"
+
+// The script engines aren't part of the test build, a config of the tests never selects a script.
+// Neither is the input computation, which needs the hooks, the tests give SendKey their input themselves.
+
+namespace common::lua {
+    DWORD GetPositionAddress() {
+        return NULL;
+    }
+}
+
+namespace common::luajit {
+    DWORD GetPositionAddress() {
+        return NULL;
+    }
+}
+
+namespace common::neolua {
+    DWORD GetPositionAddress() {
+        return NULL;
+    }
+}
+
+namespace core::inputdetermine {
+    GameInput DetermineGameInput() {
+        return GameInput::NONE;
+    }
+}
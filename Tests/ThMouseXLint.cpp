@@ -0,0 +1,37 @@
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+#include "ConfigParser.h"
+
+namespace configparser = core::configparser;
+
+using namespace std;
+
+// thmousex-lint [directory]
+// Check Games.txt, Games2.txt, ThMouseX.ini and VirtualKeyCodes.txt of the directory, the current one by default,
+// the way ThMouseXGUI --lint does. Prints one line per problem, and exits with 1 when there is any.
+int main(int argc, char** argv) {
+    if (argc > 2) {
+        fprintf(stderr, "usage: thmousex-lint [directory]\n");
+        return 2;
+    }
+    if (argc == 2) {
+        error_code error;
+        filesystem::current_path(argv[1], error);
+        if (error) {
+            fprintf(stderr, "%s: %s\n", argv[1], error.message().c_str());
+            return 2;
+        }
+    }
+    vector<GameConfig> gameConfigs;
+    SharedConfig config{};
+    configparser::Diagnostics diagnostics;
+    configparser::ParseGamesFile("Games.txt", gameConfigs, diagnostics);
+    configparser::ParseGamesFile("Games2.txt", gameConfigs, diagnostics, true);
+    configparser::ParseGeneralFile("ThMouseX.ini", "VirtualKeyCodes.txt", config, diagnostics);
+    for (auto& diagnostic : diagnostics)
+        printf("%s\n", configparser::FormatDiagnostic(diagnostic).c_str());
+    return diagnostics.size() == 0 ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#include "framework.h"
+#include <format>
+#include <fstream>
+#include <string>
+#include <inipp.h>
+
+#include "../Common/macro.h"
+#include "../Common/Helper.h"
+#include "../Common/Helper.Encoding.h"
+#include "ConfigParser.h"
+
+namespace helper = common::helper;
+namespace encoding = common::helper::encoding;
+
+#define INI_GET_BUTTON(section, ini_key, buttonNames, output) INI_GET_BUTTON_IMPL(__COUNTER__, section, ini_key, buttonNames, output)
+#define INI_GET_BUTTON_IMPL(counter, section, ini_key, buttonNames, output) \
+std::string MAKE_UNIQUE_VAR(counter); \
+if (!inipp::get_value(section, ini_key, MAKE_UNIQUE_VAR(counter))) \
+    AddDiagnostic(diagnostics, iniPath, ini_key, "missing value"); \
+else { \
+    auto vkCode = FindVkCode(buttonNames, MAKE_UNIQUE_VAR(counter)); \
+    if (!vkCode) \
+        AddDiagnostic(diagnostics, iniPath, ini_key, std::format("unknown key \"{}\"", MAKE_UNIQUE_VAR(counter))); \
+    else \
+        output = *vkCode; \
+}0
+
+#define INI_GET_WSTR_PATH(section, ini_key, output) INI_GET_WSTR_PATH_IMPL(__COUNTER__, section, ini_key, output)
+#define INI_GET_WSTR_PATH_IMPL(counter, section, ini_key, output) \
+std::string MAKE_UNIQUE_VAR(counter); \
+if (!inipp::get_value(section, ini_key, MAKE_UNIQUE_VAR(counter))) \
+    AddDiagnostic(diagnostics, iniPath, ini_key, "missing value"); \
+else if (MAKE_UNIQUE_VAR(counter).size() == 0) \
+    AddDiagnostic(diagnostics, iniPath, ini_key, "empty path"); \
+else { \
+    auto wStr = encoding::ConvertToUtf16(MAKE_UNIQUE_VAR(counter).c_str()); \
+    GetFullPathNameW(wStr.c_str(), ARRAYSIZE(output), output, NULL); \
+}0
+
+#define INI_GET_ULONG(section, ini_key, output) INI_GET_ULONG_IMPL(__COUNTER__, section, ini_key, output)
+#define INI_GET_ULONG_IMPL(counter, section, ini_key, output) \
+std::string MAKE_UNIQUE_VAR(counter); \
+if (!inipp::get_value(section, ini_key, MAKE_UNIQUE_VAR(counter))) \
+    AddDiagnostic(diagnostics, iniPath, ini_key, "missing value"); \
+else { \
+    auto [value, convMessage] = helper::ConvertToULong(MAKE_UNIQUE_VAR(counter), 10); \
+    if (convMessage != nullptr) \
+        AddDiagnostic(diagnostics, iniPath, ini_key, convMessage); \
+    else \
+        output = value; \
+}0
+
+using namespace std;
+using namespace core::configparser;
+
+// the input thread publishes inputs that are at most 8 ms old, so it can't be slower than that,
+// and its timer can't wait much less than the inverse of the maximum
+constexpr DWORD MinInputThreadRate = 250;
+constexpr DWORD MaxInputThreadRate = 8000;
+
+namespace core::configparser {
+    void ParseGeneralFile(const char* iniPath, const char* vkCodesPath, SharedConfig& config, Diagnostics& diagnostics) {
+        auto vkCodes = ParseVkCodesFile(vkCodesPath, diagnostics);
+
+        ifstream iniFile(iniPath);
+        if (!iniFile) {
+            AddDiagnostic(diagnostics, iniPath, nullptr, "missing file");
+            return;
+        }
+
+        inipp::Ini<char> ini;
+        ini.parse(iniFile);
+        for (auto& invalidLine : ini.errors)
+            AddDiagnostic(diagnostics, iniPath, nullptr, format("invalid syntax: \"{}\"", invalidLine));
+
+        ini.strip_trailing_comments();
+        auto& defaultSection = ini.sections[""];
+
+        INI_GET_BUTTON(defaultSection, "BombButton", vkCodes, config.BombButton);
+        INI_GET_BUTTON(defaultSection, "ExtraButton", vkCodes, config.ExtraButton);
+
+        INI_GET_BUTTON(defaultSection, "ToggleOsCursorButton", vkCodes, config.ToggleOsCursorButton);
+        INI_GET_BUTTON(defaultSection, "ToggleImGuiButton", vkCodes, config.ToggleImGuiButton);
+
+        INI_GET_WSTR_PATH(defaultSection, "ImGuiFontPath", config.ImGuiFontPath);
+        INI_GET_ULONG(defaultSection, "ImGuiBaseFontSize", config.ImGuiBaseFontSize);
+        INI_GET_ULONG(defaultSection, "ImGuiBaseVerticalResolution", config.ImGuiBaseVerticalResolution);
+
+        INI_GET_WSTR_PATH(defaultSection, "CursorTexture", config.TextureFilePath);
+        INI_GET_ULONG(defaultSection, "CursorBaseHeight", config.TextureBaseHeight);
+
+        // optional, the ini files of older versions don't have it
+        config.MovementMode = MovementMode::Classic;
+        string movementMode;
+        if (inipp::get_value(defaultSection, "MovementMode", movementMode)) {
+            auto mode = FindMovementMode(movementMode);
+            if (!mode)
+                AddDiagnostic(diagnostics, iniPath, "MovementMode", format("unknown mode \"{}\"", movementMode));
+            else
+                config.MovementMode = *mode;
+        }
+
+        // optional too
+        config.InputThreadRate = 0;
+        string inputThreadRate;
+        if (inipp::get_value(defaultSection, "InputThreadRate", inputThreadRate)) {
+            auto [rate, convMessage] = helper::ConvertToULong(inputThreadRate, 10);
+            if (convMessage != nullptr)
+                AddDiagnostic(diagnostics, iniPath, "InputThreadRate", convMessage);
+            else if (rate != 0 && (rate < MinInputThreadRate || rate > MaxInputThreadRate))
+                AddDiagnostic(diagnostics, iniPath, "InputThreadRate", format("must be 0 or between {} and {}", MinInputThreadRate, MaxInputThreadRate));
+            else
+                config.InputThreadRate = rate;
+        }
+    }
+}
@@ -0,0 +1,378 @@
+#include "framework.h"
+#include <format>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../Common/macro.h"
+#include "../Common/Helper.h"
+#include "../Common/Helper.Encoding.h"
+#include "../Common/PointerPath.h"
+#include "../Common/Signature.h"
+#include "VirtualKeyCodes.h"
+#include "ConfigParser.h"
+
+namespace helper = common::helper;
+namespace encoding = common::helper::encoding;
+namespace pointerpath = common::pointerpath;
+namespace signature = common::signature;
+
+#define PointerPathPrefix "expr:"
+#define SignaturePrefix "sig:"
+
+using namespace std;
+using namespace core::configparser;
+
+#pragma region method declaration
+bool ExtractProcessName(string_view token, GameConfig& gameConfig, LineContext& context);
+bool ExtractPositionRVA(string_view token, GameConfig& gameConfig, LineContext& context);
+bool ExtractDataType(string_view token, GameConfig& gameConfig, LineContext& context);
+bool ExtractOffset(string_view token, GameConfig& gameConfig, LineContext& context);
+bool ExtractBaseHeight(string_view token, GameConfig& gameConfig, LineContext& context);
+bool ExtractAspectRatio(string_view token, GameConfig& gameConfig, LineContext& context);
+bool ExtractInputMethod(string_view token, GameConfig& gameConfig, LineContext& context);
+#pragma endregion
+
+constexpr auto Whitespaces = " \t\r\v\f";
+
+namespace core::configparser {
+    void AddDiagnostic(Diagnostics& diagnostics, const char* filePath, const char* field, string message) {
+        diagnostics.push_back({ filePath, 0, 0, field, move(message) });
+    }
+
+    bool AddDiagnostic(LineContext& context, string_view token, const char* field, string message) {
+        auto column = int(token.data() - context.Content.data()) + 1;
+        context.Output.push_back({ context.FilePath, context.Line, column, field, token.empty() ? "missing value" : move(message) });
+        return false;
+    }
+
+    string FormatDiagnostic(const ConfigDiagnostic& diagnostic) {
+        auto location = diagnostic.Line > 0
+            ? format("{}({},{})", diagnostic.FilePath, diagnostic.Line, diagnostic.Column)
+            : string(diagnostic.FilePath);
+        if (diagnostic.Field != nullptr)
+            return format("{}: invalid {}: {}", location, diagnostic.Field, diagnostic.Message);
+        return format("{}: {}", location, diagnostic.Message);
+    }
+
+    bool IsCommentLine(string_view line) {
+        auto firstChrIdx = line.find_first_not_of(Whitespaces);
+        return firstChrIdx == string_view::npos || line[firstChrIdx] == ';';
+    }
+
+    // Escape sequences are not supported, because '"' and '\' cannot appear in a file name anyway.
+    string_view NextToken(string_view& line) {
+        auto tokenIdx = line.find_first_not_of(Whitespaces);
+        if (tokenIdx == string_view::npos) {
+            // still point into the line, so a missing field can be located
+            line.remove_prefix(line.size());
+            return line;
+        }
+        line.remove_prefix(tokenIdx);
+        string_view token;
+        if (line[0] == '"') {
+            auto closingIdx = line.find('"', 1);
+            token = line.substr(1, closingIdx == string_view::npos ? string_view::npos : closingIdx - 1);
+            line.remove_prefix(closingIdx == string_view::npos ? line.size() : closingIdx + 1);
+        }
+        else {
+            auto tokenEnd = line.find_first_of(Whitespaces);
+            token = line.substr(0, tokenEnd);
+            line.remove_prefix(token.size());
+        }
+        return token;
+    }
+
+    bool EqualsIgnoreCase(string_view left, string_view right) {
+        return left.size() == right.size() && _strnicmp(left.data(), right.data(), left.size()) == 0;
+    }
+
+    void ParseGamesText(string_view content, const char* gameConfigPath, vector<GameConfig>& gameConfigs, Diagnostics& diagnostics) {
+        if (content.starts_with("\xEF\xBB\xBF"))
+            content.remove_prefix(3);
+
+        LineContext context{ gameConfigPath, 0, {}, diagnostics };
+        while (content.size() > 0) {
+            context.Line++;
+            auto lineEnd = content.find('\n');
+            auto line = content.substr(0, lineEnd);
+            content.remove_prefix(lineEnd == string_view::npos ? content.size() : lineEnd + 1);
+            if (IsCommentLine(line))
+                continue;
+            context.Content = line;
+
+            // check every field even after one fails, so a single pass reports everything
+            GameConfig gameConfig{};
+            auto valid = ExtractProcessName(NextToken(line), gameConfig, context);
+            valid &= ExtractPositionRVA(NextToken(line), gameConfig, context);
+            valid &= ExtractDataType(NextToken(line), gameConfig, context);
+            valid &= ExtractOffset(NextToken(line), gameConfig, context);
+            valid &= ExtractBaseHeight(NextToken(line), gameConfig, context);
+            valid &= ExtractAspectRatio(NextToken(line), gameConfig, context);
+            valid &= ExtractInputMethod(NextToken(line), gameConfig, context);
+
+            if (valid)
+                gameConfigs.push_back(gameConfig);
+        }
+    }
+
+    void ParseGamesFile(const char* gameConfigPath, vector<GameConfig>& gameConfigs, Diagnostics& diagnostics, bool overriding) {
+        Handle gamesFile(CreateFileA(gameConfigPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL));
+        if (gamesFile.get() == INVALID_HANDLE_VALUE) {
+            if (!overriding)
+                AddDiagnostic(diagnostics, gameConfigPath, nullptr, "missing file");
+            return;
+        }
+        // map the whole file and tokenize it in place, an empty file cannot be mapped so it's skipped
+        LARGE_INTEGER fileSize{};
+        if (GetFileSizeEx(gamesFile.get(), &fileSize) == FALSE) {
+            AddDiagnostic(diagnostics, gameConfigPath, nullptr, format("failed to read the file (error {})", GetLastError()));
+            return;
+        }
+        if (fileSize.QuadPart == 0)
+            return;
+        Handle mapping(CreateFileMappingA(gamesFile.get(), NULL, PAGE_READONLY, 0, 0, NULL));
+        MappedView view(mapping ? MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0) : NULL);
+        if (!view) {
+            AddDiagnostic(diagnostics, gameConfigPath, nullptr, format("failed to map the file (error {})", GetLastError()));
+            return;
+        }
+        ParseGamesText(string_view((const char*)view.get(), size_t(fileSize.QuadPart)), gameConfigPath, gameConfigs, diagnostics);
+    }
+
+    VkCodes ParseVkCodesFile(const char* vkCodesPath, Diagnostics& diagnostics) {
+        VkCodes vkCodes;
+        string line;
+
+        ifstream vkcodeFile(vkCodesPath);
+        if (!vkcodeFile)
+            return vkCodes;
+
+        LineContext context{ vkCodesPath, 0, {}, diagnostics };
+        while (getline(vkcodeFile, line)) {
+            context.Line++;
+            context.Content = line;
+            auto lineView = string_view(line);
+
+            auto key = NextToken(lineView);
+            if (key.empty() || key.starts_with(";"))
+                continue;
+
+            auto valueStr = NextToken(lineView);
+            auto [value, convMessage] = helper::ConvertToULong(valueStr, 0);
+            if (convMessage != nullptr) {
+                AddDiagnostic(context, valueStr, "value", convMessage);
+                continue;
+            }
+            vkCodes[string(key)] = (BYTE)value;
+        }
+
+        return vkCodes;
+    }
+
+    optional<BYTE> FindVkCode(const VkCodes& userVkCodes, string_view name) {
+        if (!userVkCodes.empty()) {
+            auto userVkCode = userVkCodes.find(name);
+            if (userVkCode != userVkCodes.end())
+                return userVkCode->second;
+        }
+        auto vkCode = ranges::lower_bound(VirtualKeyCodes, name, {}, &VkCodeName::Name);
+        if (vkCode == ranges::end(VirtualKeyCodes) || vkCode->Name != name)
+            return nullopt;
+        return vkCode->Code;
+    }
+
+    optional<MovementMode> FindMovementMode(string_view name) {
+        constexpr pair<const char*, MovementMode> modes[]{
+            { "Classic", MovementMode::Classic },
+            { "Predictive", MovementMode::Predictive },
+            { "Proportional", MovementMode::Proportional },
+            { "Straight", MovementMode::Straight },
+        };
+        for (auto& [modeName, mode] : modes) {
+            if (EqualsIgnoreCase(name, modeName))
+                return mode;
+        }
+        return nullopt;
+    }
+}
+
+bool ExtractProcessName(string_view token, GameConfig& gameConfig, LineContext& context) {
+    auto maxSize = ARRAYSIZE(gameConfig.ProcessName) - 1;
+    auto size = encoding::ConvertToUtf16(token, gameConfig.ProcessName, int(maxSize));
+    if (size_t(size) > maxSize) {
+        return AddDiagnostic(context, token, "processName", format("longer than {} characters", maxSize));
+    }
+    return true;
+}
+
+bool ExtractPositionRVA(string_view token, GameConfig& gameConfig, LineContext& context) {
+    if (token.starts_with(PointerPathPrefix)) {
+        auto [message, location] = pointerpath::Compile(token.substr(strlen(PointerPathPrefix)), gameConfig.Path);
+        if (message == nullptr)
+            return true;
+        // an error at the end of the expression points at its last character
+        if (location.empty())
+            location = token.substr(token.size() - 1);
+        return AddDiagnostic(context, location, "positionRVA", message);
+    }
+
+    string_view segments[3]{};
+    auto scriptingConfig = token;
+    for (auto& segment : segments) {
+        auto slashIdx = scriptingConfig.find('/');
+        segment = scriptingConfig.substr(0, slashIdx);
+        if (slashIdx == string_view::npos)
+            break;
+        scriptingConfig.remove_prefix(slashIdx + 1);
+    }
+
+    if (EqualsIgnoreCase(segments[0], "LuaJIT"))
+        gameConfig.ScriptType = ScriptType::LuaJIT;
+    else if (EqualsIgnoreCase(segments[0], "NeoLua"))
+        gameConfig.ScriptType = ScriptType::NeoLua;
+    else if (EqualsIgnoreCase(segments[0], "Lua"))
+        gameConfig.ScriptType = ScriptType::Lua;
+
+    if (EqualsIgnoreCase(segments[1], "Detached"))
+        gameConfig.ScriptRunPlace = ScriptRunPlace::Detached;
+    else if (EqualsIgnoreCase(segments[1], "Attached"))
+        gameConfig.ScriptRunPlace = ScriptRunPlace::Attached;
+
+    if (EqualsIgnoreCase(segments[2], "Pull"))
+        gameConfig.ScriptPositionGetMethod = ScriptPositionGetMethod::Pull;
+    else if (EqualsIgnoreCase(segments[2], "Push"))
+        gameConfig.ScriptPositionGetMethod = ScriptPositionGetMethod::Push;
+
+    if (gameConfig.ScriptType != ScriptType::None)
+        return true;
+
+    auto& address = gameConfig.Address;
+    auto pointerChain = token;
+    while (address.Length < ADDRESS_CHAIN_MAX_LEN) {
+        auto leftBoundIdx = pointerChain.find('[');
+        if (leftBoundIdx == string_view::npos)
+            break;
+        auto rightBoundIdx = pointerChain.find(']', leftBoundIdx + 1);
+        if (rightBoundIdx == string_view::npos)
+            break;
+
+        auto offsetStr = pointerChain.substr(leftBoundIdx + 1, rightBoundIdx - leftBoundIdx - 1);
+        if (offsetStr.starts_with(SignaturePrefix)) {
+            if (address.Length > 0)
+                return AddDiagnostic(context, offsetStr, "positionRVA", "only the first offset can be a signature");
+            auto [message, location] = signature::Parse(offsetStr.substr(strlen(SignaturePrefix)), gameConfig.Signature);
+            if (message != nullptr)
+                return AddDiagnostic(context, location.empty() ? offsetStr.substr(offsetStr.size() - 1) : location, "positionRVA", message);
+            // filled in from the signature once the game starts
+            address.Level[address.Length++] = 0;
+            pointerChain.remove_prefix(rightBoundIdx + 1);
+            continue;
+        }
+        auto [offset, convMessage] = helper::ConvertToULong(offsetStr, 16);
+        if (convMessage != nullptr)
+            return AddDiagnostic(context, offsetStr, "positionRVA", convMessage);
+
+        address.Level[address.Length++] = offset;
+        pointerChain.remove_prefix(rightBoundIdx + 1);
+    }
+
+    if (address.Length == 0)
+        return AddDiagnostic(context, token, "positionRVA", "found no address offset");
+
+    return true;
+}
+
+bool ExtractDataType(string_view token, GameConfig& gameConfig, LineContext& context) {
+    if (EqualsIgnoreCase(token, "Int"))
+        gameConfig.PosDataType = PointDataType::Int;
+    else if (EqualsIgnoreCase(token, "Float"))
+        gameConfig.PosDataType = PointDataType::Float;
+    else if (EqualsIgnoreCase(token, "Short"))
+        gameConfig.PosDataType = PointDataType::Short;
+    else if (EqualsIgnoreCase(token, "Double"))
+        gameConfig.PosDataType = PointDataType::Double;
+    else
+        return AddDiagnostic(context, token, "dataType", "expected Int, Float, Short or Double");
+
+    return true;
+}
+
+bool ExtractOffset(string_view token, GameConfig& gameConfig, LineContext& context) {
+    if (!token.starts_with('(') || !token.ends_with(')'))
+        return AddDiagnostic(context, token, "offset", "expected wrapping '(' and ')'");
+    auto commaIdx = token.find(',');
+    if (commaIdx == string_view::npos)
+        return AddDiagnostic(context, token, "offset", "expected separating comma ','");
+
+    auto offsetXStr = token.substr(1, commaIdx - 1);
+    auto [offsetX, convMessage] = helper::ConvertToFloat(offsetXStr);
+    if (convMessage != nullptr)
+        return AddDiagnostic(context, offsetXStr, "offset", format("X: {}", convMessage));
+
+    auto offsetYStr = token.substr(commaIdx + 1, token.length() - commaIdx - 2);
+    auto [offsetY, convMessage2] = helper::ConvertToFloat(offsetYStr);
+    if (convMessage2 != nullptr)
+        return AddDiagnostic(context, offsetYStr, "offset", format("Y: {}", convMessage2));
+
+    gameConfig.BasePixelOffset = FloatPoint(offsetX, offsetY);
+    return true;
+}
+
+bool ExtractBaseHeight(string_view token, GameConfig& gameConfig, LineContext& context) {
+    auto [baseHeight, convMessage] = helper::ConvertToULong(token, 10);
+    if (convMessage != nullptr)
+        return AddDiagnostic(context, token, "baseHeight", convMessage);
+    if (baseHeight == 0)
+        return AddDiagnostic(context, token, "baseHeight", "must be greater than 0");
+
+    static_assert(is_same<decltype(gameConfig.BaseHeight), decltype(baseHeight)>());
+    gameConfig.BaseHeight = baseHeight;
+    return true;
+}
+
+bool ExtractAspectRatio(string_view token, GameConfig& gameConfig, LineContext& context) {
+    auto colonIdx = token.find(':');
+    if (colonIdx == string_view::npos)
+        return AddDiagnostic(context, token, "aspectRatio", "expected separating ':'");
+
+    auto ratioXStr = token.substr(0, colonIdx);
+    auto [ratioX, convMessage] = helper::ConvertToFloat(ratioXStr);
+    if (convMessage != nullptr)
+        return AddDiagnostic(context, ratioXStr, "aspectRatio", format("X: {}", convMessage));
+
+    auto ratioYStr = token.substr(colonIdx + 1);
+    auto [ratioY, convMessage2] = helper::ConvertToFloat(ratioYStr);
+    if (convMessage2 != nullptr)
+        return AddDiagnostic(context, ratioYStr, "aspectRatio", format("Y: {}", convMessage2));
+
+    gameConfig.AspectRatio = FloatPoint(ratioX, ratioY);
+    return true;
+}
+
+bool ExtractInputMethod(string_view token, GameConfig& gameConfig, LineContext& context) {
+    auto inputMethods = InputMethod::None;
+    auto inputMethodList = token;
+    while (inputMethodList.size() > 0) {
+        auto slashIdx = inputMethodList.find('/');
+        auto inputMethod = inputMethodList.substr(0, slashIdx);
+        inputMethodList.remove_prefix(slashIdx == string_view::npos ? inputMethodList.size() : slashIdx + 1);
+        if (EqualsIgnoreCase(inputMethod, "DirectInput"))
+            inputMethods |= InputMethod::DirectInput;
+        else if (EqualsIgnoreCase(inputMethod, "GetKeyboardState"))
+            inputMethods |= InputMethod::GetKeyboardState;
+        else if (EqualsIgnoreCase(inputMethod, "SendInput"))
+            inputMethods |= InputMethod::SendInput;
+        else if (EqualsIgnoreCase(inputMethod, "SendMessage"))
+            inputMethods |= InputMethod::SendMsg;
+    }
+
+    if (inputMethods == InputMethod::None)
+        return AddDiagnostic(context, token, "inputMethod", "expected DirectInput, GetKeyboardState, SendInput or SendMessage");
+
+    gameConfig.InputMethods = inputMethods;
+    return true;
+}
+
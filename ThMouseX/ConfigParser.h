@@ -0,0 +1,57 @@
+#pragma once
+#include "framework.h"
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../Common/DataTypes.h"
+
+// Parsing of the config files without any UI, so the GUI, the linter and the tests share it.
+namespace core::configparser {
+    struct ConfigDiagnostic {
+        const char*     FilePath;
+        // 1-based, 0 when the problem is not tied to a line
+        int             Line;
+        // 1-based byte offset in the line
+        int             Column;
+        // nullptr when the problem is not tied to a field
+        const char*     Field;
+        std::string     Message;
+    };
+    typedef std::vector<ConfigDiagnostic> Diagnostics;
+    // key names of VirtualKeyCodes.txt
+    typedef std::unordered_map<std::string, BYTE, string_hash, std::equal_to<>> VkCodes;
+
+    // the line being parsed, so a field can report where it is
+    struct LineContext {
+        const char*         FilePath;
+        int                 Line;
+        std::string_view    Content;
+        Diagnostics&        Output;
+    };
+
+    void AddDiagnostic(Diagnostics& diagnostics, const char* filePath, const char* field, std::string message);
+    // token must point into context.Content, always returns false so a field extractor can return it
+    bool AddDiagnostic(LineContext& context, std::string_view token, const char* field, std::string message);
+    // "file(line,column): invalid field: message"
+    std::string FormatDiagnostic(const ConfigDiagnostic& diagnostic);
+
+    bool IsCommentLine(std::string_view line);
+    // Take the next whitespace-separated token off the line, a token wrapped in "" can contain spaces.
+    std::string_view NextToken(std::string_view& line);
+    bool EqualsIgnoreCase(std::string_view left, std::string_view right);
+
+    // Parse the lines of a Games.txt, the valid ones are appended to gameConfigs and every problem to diagnostics.
+    void ParseGamesText(std::string_view content, const char* gameConfigPath, std::vector<GameConfig>& gameConfigs, Diagnostics& diagnostics);
+    // A missing file is only a problem when it isn't overriding another one.
+    void ParseGamesFile(const char* gameConfigPath, std::vector<GameConfig>& gameConfigs, Diagnostics& diagnostics, bool overriding = false);
+
+    // Parse ThMouseX.ini into config, its buttons can also use the key names of the optional VirtualKeyCodes.txt.
+    void ParseGeneralFile(const char* iniPath, const char* vkCodesPath, SharedConfig& config, Diagnostics& diagnostics);
+    // Read the optional user extension of the built-in key names, its entries take precedence.
+    VkCodes ParseVkCodesFile(const char* vkCodesPath, Diagnostics& diagnostics);
+    std::optional<BYTE> FindVkCode(const VkCodes& userVkCodes, std::string_view name);
+    std::optional<MovementMode> FindMovementMode(std::string_view name);
+}
@@ -3,5 +3,7 @@
 
 namespace core::configuration {
     DLLEXPORT_C bool ReadGamesFile();
+    DLLEXPORT_C bool CompileGamesFile();
+    DLLEXPORT_C bool LintConfigFiles();
     DLLEXPORT_C bool ReadGeneralConfigFile();
 }
\ No newline at end of file
@@ -25,7 +25,10 @@
 #include "../Common/Helper.Encoding.h"
 #include "../Common/Helper.Graphics.h"
 #include "../Common/Log.h"
+#include "../Common/HookState.h"
 #include "Direct3D11.h"
+#include "InputDetermine.h"
+#include "RawInput.h"
 
 #include "AdditiveToneShader.hshader"
 
@@ -36,6 +39,9 @@ namespace encoding = common::helper::encoding;
 namespace graphics = common::helper::graphics;
 namespace note = common::log;
 namespace imguioverlay = core::imguioverlay;
+namespace inputdetermine = core::inputdetermine;
+namespace rawinput = core::rawinput;
+namespace hookstate = common::hookstate;
 
 #define TAG "[DirectX11] "
 
@@ -212,9 +218,10 @@ namespace core::directx11 {
             return;
         }
         g_hFocusWindow = desc.OutputWindow;
-        g_isMinimized = IsIconic(g_hFocusWindow);
+        hookstate::Set(HookState::Minimized, IsIconic(g_hFocusWindow));
 
-        if (gs_textureFilePath[0] && SUCCEEDED(CreateWICTextureFromFile(device, gs_textureFilePath, NULL, &cursorTexture))) {
+        auto& config = inputdetermine::ReadConfig();
+        if (config.Shared.TextureFilePath[0] && SUCCEEDED(CreateWICTextureFromFile(device, config.Shared.TextureFilePath, NULL, &cursorTexture))) {
             ComPtr<ID3D11Resource> resource;
             cursorTexture->GetResource(&resource);
             ComPtr<ID3D11Texture2D> pTextureInterface;
@@ -264,9 +271,10 @@ namespace core::directx11 {
             note::LastErrorToFile(TAG "PrepareMeasurement: GetClientRect failed");
             return;
         }
-        g_pixelRate = float(g_currentConfig.BaseHeight) / clientSize.height();
-        g_pixelOffset.X = g_currentConfig.BasePixelOffset.X / g_pixelRate;
-        g_pixelOffset.Y = g_currentConfig.BasePixelOffset.Y / g_pixelRate;
+        auto& config = inputdetermine::ReadConfig();
+        g_pixelRate = float(config.Game.BaseHeight) / clientSize.height();
+        g_pixelOffset.X = config.Game.BasePixelOffset.X / g_pixelRate;
+        g_pixelOffset.Y = config.Game.BasePixelOffset.Y / g_pixelRate;
         imGuiMousePosScaleX = float(clientSize.width()) / desc.BufferDesc.Width;
         imGuiMousePosScaleY = float(clientSize.height()) / desc.BufferDesc.Height;
     }
@@ -289,7 +297,8 @@ namespace core::directx11 {
             return;
         }
 
-        auto scale = float(desc.BufferDesc.Height) / gs_textureBaseHeight;
+        auto& config = inputdetermine::ReadConfig();
+        auto scale = float(desc.BufferDesc.Height) / config.Shared.TextureBaseHeight;
         cursorScale = XMVECTORF32{scale, scale};
 
         RECTSIZE clientSize{};
@@ -307,7 +316,7 @@ namespace core::directx11 {
         auto dx11State = graphics::SaveDx11State(swapChain, context);
 
         // scale mouse cursor's position from screen coordinate to D3D coordinate
-        auto pointerPosition = helper::GetPointerPosition();
+        auto pointerPosition = rawinput::GetPointerPosition();
         XMVECTOR cursorPositionD3D = XMVECTORF32{float(pointerPosition.x), float(pointerPosition.y)};
         if (d3dScale != 0.f && d3dScale != 1.f) {
             cursorPositionD3D = XMVectorScale(cursorPositionD3D, d3dScale);
@@ -321,7 +330,8 @@ namespace core::directx11 {
         static UCHAR tone = 0;
         static auto toneStage = WhiteInc;
         auto usePixelShader = false;
-        if (g_inputEnabled) {
+        auto inputEnabled = hookstate::Has(hookstate::Load(), HookState::InputEnabled);
+        if (inputEnabled) {
             helper::CalculateNextTone(_ref tone, _ref toneStage);
             if (toneStage == WhiteInc || toneStage == WhiteDec)
                 // default behaviour: texture color * diffuse color
@@ -334,7 +344,7 @@ namespace core::directx11 {
         auto sortMode = SpriteSortMode_Deferred;
         auto m_states = std::make_unique<CommonStates>(device);
         spriteBatch->Begin(sortMode, m_states->NonPremultiplied(), NULL, NULL, NULL, setCustomShaders, scalingMatrixD3D);
-        auto color = g_inputEnabled ? ToneColor(tone) : RGBA(255, 200, 200, 128);
+        auto color = inputEnabled ? ToneColor(tone) : RGBA(255, 200, 200, 128);
         spriteBatch->Draw(cursorTexture, cursorPositionD3D, NULL, color, 0, cursorPivot, 1, SpriteEffects_None);
         spriteBatch->End();
         
@@ -368,11 +378,12 @@ namespace core::directx11 {
             return;
         }
 
-        imguioverlay::Configure(float(desc.BufferDesc.Height) / gs_imGuiBaseVerticalResolution);
+        auto& config = inputdetermine::ReadConfig();
+        imguioverlay::Configure(float(desc.BufferDesc.Height) / config.Shared.ImGuiBaseVerticalResolution);
     }
 
     void RenderImGui(IDXGISwapChain* swapChain) {
-        if (!g_showImGui || !context || !renderTargetView)
+        if (!hookstate::Has(hookstate::Load(), HookState::ShowImGui) || !context || !renderTargetView)
             return;
         ImGui_ImplDX11_NewFrame();
         ImGui_ImplWin32_NewFrame();
@@ -21,7 +21,10 @@
 #include "../Common/Helper.h"
 #include "../Common/Helper.Encoding.h"
 #include "../Common/Log.h"
+#include "../Common/HookState.h"
 #include "Direct3D8.h"
+#include "InputDetermine.h"
+#include "RawInput.h"
 
 namespace minhook = common::minhook;
 namespace callbackstore = common::callbackstore;
@@ -29,6 +32,9 @@ namespace helper = common::helper;
 namespace encoding = common::helper::encoding;
 namespace note = common::log;
 namespace imguioverlay = core::imguioverlay;
+namespace inputdetermine = core::inputdetermine;
+namespace rawinput = core::rawinput;
+namespace hookstate = common::hookstate;
 
 #define TAG "[DirectX8] "
 
@@ -184,9 +190,10 @@ namespace core::directx8 {
             return;
         }
         g_hFocusWindow = params.hFocusWindow;
-        g_isMinimized = IsIconic(g_hFocusWindow);
+        hookstate::Set(HookState::Minimized, IsIconic(g_hFocusWindow));
 
-        if (gs_textureFilePath[0] && SUCCEEDED(D3DXCreateTextureFromFileW(device, gs_textureFilePath, &cursorTexture))) {
+        auto& config = inputdetermine::ReadConfig();
+        if (config.Shared.TextureFilePath[0] && SUCCEEDED(D3DXCreateTextureFromFileW(device, config.Shared.TextureFilePath, &cursorTexture))) {
             D3DXCreateSprite(device, &cursorSprite);
             D3DSURFACE_DESC cursorSize;
             cursorTexture->GetLevelDesc(0, &cursorSize);
@@ -242,9 +249,10 @@ namespace core::directx8 {
             note::LastErrorToFile(TAG "PrepareMeasurement: GetClientRect failed (2)");
             return;
         }
-        g_pixelRate = float(g_currentConfig.BaseHeight) / clientSize.height();
-        g_pixelOffset.X = g_currentConfig.BasePixelOffset.X / g_pixelRate;
-        g_pixelOffset.Y = g_currentConfig.BasePixelOffset.Y / g_pixelRate;
+        auto& config = inputdetermine::ReadConfig();
+        g_pixelRate = float(config.Game.BaseHeight) / clientSize.height();
+        g_pixelOffset.X = config.Game.BasePixelOffset.X / g_pixelRate;
+        g_pixelOffset.Y = config.Game.BasePixelOffset.Y / g_pixelRate;
         imGuiMousePosScaleX = float(clientSize.width()) / d3dSize.Width;
         imGuiMousePosScaleY = float(clientSize.height()) / d3dSize.Height;
     }
@@ -274,7 +282,8 @@ namespace core::directx8 {
             note::DxErrToFile(TAG "PrepareCursorState: pSurface->GetDesc failed", rs);
             return;
         }
-        auto scale = float(d3dSize.Height) / gs_textureBaseHeight;
+        auto& config = inputdetermine::ReadConfig();
+        auto scale = float(d3dSize.Height) / config.Shared.TextureBaseHeight;
         cursorScale = D3DXVECTOR2(scale, scale);
 
         RECTSIZE clientSize{};
@@ -308,7 +317,7 @@ namespace core::directx8 {
         pDevice->BeginScene();
 
         // scale mouse cursor's position from screen coordinate to D3D coordinate
-        auto pointerPosition = helper::GetPointerPosition();
+        auto pointerPosition = rawinput::GetPointerPosition();
         D3DXVECTOR2 cursorPositionD3D(float(pointerPosition.x), float(pointerPosition.y));
         if (d3dScale != 0.f && d3dScale != 1.f)
             cursorPositionD3D /= d3dScale;
@@ -319,7 +328,7 @@ namespace core::directx8 {
 
         cursorSprite->Begin();
         // draw the cursor and scale cursor sprite to match the current render resolution
-        if (g_inputEnabled) {
+        if (hookstate::Has(hookstate::Load(), HookState::InputEnabled)) {
             static UCHAR tone = 0;
             static auto toneStage = WhiteInc;
             helper::CalculateNextTone(_ref tone, _ref toneStage);
@@ -378,11 +387,12 @@ namespace core::directx8 {
             return;
         }
 
-        imguioverlay::Configure(float(d3dSize.Height) / gs_imGuiBaseVerticalResolution);
+        auto& config = inputdetermine::ReadConfig();
+        imguioverlay::Configure(float(d3dSize.Height) / config.Shared.ImGuiBaseVerticalResolution);
     }
 
     void RenderImGui(IDirect3DDevice8* pDevice) {
-        if (!g_showImGui)
+        if (!hookstate::Has(hookstate::Load(), HookState::ShowImGui))
             return;
         ImGui_ImplDX8_NewFrame();
         ImGui_ImplWin32_NewFrame();
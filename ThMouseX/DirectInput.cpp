@@ -83,6 +83,8 @@ namespace core::directinput {
                 keys[DIK_X] |= 0x80;
             if ((gameInput & GameInput::USE_SPECIAL) == GameInput::USE_SPECIAL)
                 keys[DIK_C] |= 0x80;
+            if ((gameInput & GameInput::USE_FOCUS) == GameInput::USE_FOCUS)
+                keys[DIK_LSHIFT] |= 0x80;
             if ((gameInput & GameInput::MOVE_LEFT) == GameInput::MOVE_LEFT)
                 keys[DIK_LEFT] |= 0x80;
             if ((gameInput & GameInput::MOVE_RIGHT) == GameInput::MOVE_RIGHT)
@@ -0,0 +1,236 @@
+#include "framework.h"
+#include <span>
+#include <string>
+#include <vector>
+#include <format>
+
+#include "../Common/macro.h"
+#include "../Common/DataTypes.h"
+#include "../Common/Variables.h"
+#include "../Common/SeqLock.h"
+#include "GameConfigRegion.h"
+
+namespace seqlock = common::seqlock;
+
+using namespace std;
+
+/*
+Shared game config region layout, every offset is relative to the start of the region unless noted:
+- RegionHeader
+- entry offsets table: DWORD[EntryCount], in the order the entries were read
+- process name index: IndexSlot[IndexSize], open addressing over HashProcessName
+- entry area: PackedGameConfig records, each one followed by its DWORD[AddressLength] pointer chain,
+  its DWORD[PathLength] pointer path bytecode, and the BYTE[SignatureLength] bytes and BYTE[SignatureLength] mask
+  of its signature, padded to a DWORD boundary
+- string pool: null-terminated UTF-16 process names
+The GUI builds it once, and each game process only maps it long enough to copy out its own entry.
+*/
+constexpr DWORD RegionMagic = 'GXMR';
+
+struct RegionHeader {
+    DWORD Magic;
+    DWORD Size;
+    DWORD EntryCount;
+    DWORD IndexSize;
+    DWORD IndexOffset;
+    DWORD EntryAreaOffset;
+    DWORD StringPoolOffset;
+};
+
+struct IndexSlot {
+    DWORD Hash;
+    // 1-based position in the entry offsets table, 0 marks an empty slot
+    DWORD Ordinal;
+};
+
+struct PackedGameConfig {
+    // in characters, relative to the string pool
+    DWORD                   ProcessNameOffset;
+    DWORD                   AddressLength;
+    DWORD                   PathLength;
+    DWORD                   SignatureLength;
+    DWORD                   SignatureOffset;
+
+    ScriptType              ScriptType;
+    ScriptRunPlace          ScriptRunPlace;
+    ScriptPositionGetMethod ScriptPositionGetMethod;
+
+    PointDataType           PosDataType;
+    FloatPoint              BasePixelOffset;
+    DWORD                   BaseHeight;
+    FloatPoint              AspectRatio;
+    InputMethod             InputMethods;
+};
+static_assert(sizeof(PackedGameConfig) % sizeof(DWORD) == 0);
+
+// Case-insensitive FNV-1a hash of a process name.
+// Folding uses the invariant locale, so the GUI process and the game processes always agree on it.
+DWORD HashProcessName(const WCHAR* processName) {
+    WCHAR folded[PROCESS_NAME_MAX_LEN];
+    auto length = LCMapStringEx(LOCALE_NAME_INVARIANT, LCMAP_UPPERCASE, processName, -1, folded, ARRAYSIZE(folded), NULL, NULL, 0);
+    DWORD hash = 2166136261;
+    for (auto i = 0; i < length - 1; i++) {
+        hash ^= folded[i];
+        hash *= 16777619;
+    }
+    return hash;
+}
+
+bool IsSameProcessName(const WCHAR* left, const WCHAR* right) {
+    return CompareStringOrdinal(left, -1, right, -1, TRUE) == CSTR_EQUAL;
+}
+
+template <typename T>
+void AppendBytes(vector<BYTE>& output, const T* data, size_t count) {
+    auto bytes = (const BYTE*)data;
+    output.insert(output.end(), bytes, bytes + count * sizeof(T));
+}
+
+namespace core::gameconfigregion {
+    // the region of the last Publish, kept open for as long as the GUI runs
+    Handle regionMapping;
+    DWORD regionGeneration;
+
+    // Pack the game configs into a region image. An entry overrides any earlier entry
+    // with the same process name, so Games2.txt wins over Games.txt.
+    vector<BYTE> Build(span<const GameConfig> gameConfigs) {
+        auto entryCount = DWORD(gameConfigs.size());
+        // keep the index at most half full, and a power of two for cheap wrapping
+        DWORD indexSize = 8;
+        while (indexSize < entryCount * 2)
+            indexSize *= 2;
+
+        RegionHeader header{
+            .Magic = RegionMagic,
+            .EntryCount = entryCount,
+            .IndexSize = indexSize,
+        };
+        header.IndexOffset = DWORD(sizeof(RegionHeader) + entryCount * sizeof(DWORD));
+        header.EntryAreaOffset = DWORD(header.IndexOffset + indexSize * sizeof(IndexSlot));
+
+        vector<DWORD> entryOffsets;
+        vector<IndexSlot> index(indexSize);
+        vector<BYTE> entryArea;
+        wstring stringPool;
+        for (DWORD i = 0; i < entryCount; i++) {
+            auto& gameConfig = gameConfigs[i];
+            entryOffsets.push_back(DWORD(header.EntryAreaOffset + entryArea.size()));
+
+            PackedGameConfig packed{
+                .ProcessNameOffset = DWORD(stringPool.size()),
+                .AddressLength = DWORD(gameConfig.Address.Length),
+                .PathLength = DWORD(gameConfig.Path.Length),
+                .SignatureLength = DWORD(gameConfig.Signature.Length),
+                .SignatureOffset = gameConfig.Signature.Offset,
+                .ScriptType = gameConfig.ScriptType,
+                .ScriptRunPlace = gameConfig.ScriptRunPlace,
+                .ScriptPositionGetMethod = gameConfig.ScriptPositionGetMethod,
+                .PosDataType = gameConfig.PosDataType,
+                .BasePixelOffset = gameConfig.BasePixelOffset,
+                .BaseHeight = gameConfig.BaseHeight,
+                .AspectRatio = gameConfig.AspectRatio,
+                .InputMethods = gameConfig.InputMethods,
+            };
+            AppendBytes(entryArea, &packed, 1);
+            AppendBytes(entryArea, gameConfig.Address.Level, packed.AddressLength);
+            AppendBytes(entryArea, gameConfig.Path.Code, packed.PathLength);
+            AppendBytes(entryArea, gameConfig.Signature.Bytes, packed.SignatureLength);
+            AppendBytes(entryArea, gameConfig.Signature.Mask, packed.SignatureLength);
+            entryArea.resize((entryArea.size() + sizeof(DWORD) - 1) & ~(sizeof(DWORD) - 1));
+            stringPool.append(gameConfig.ProcessName).push_back(L'\0');
+
+            auto hash = HashProcessName(gameConfig.ProcessName);
+            for (auto slotIdx = hash & (indexSize - 1); ; slotIdx = (slotIdx + 1) & (indexSize - 1)) {
+                auto& slot = index[slotIdx];
+                if (slot.Ordinal == 0 || slot.Hash == hash && IsSameProcessName(gameConfigs[slot.Ordinal - 1].ProcessName, gameConfig.ProcessName)) {
+                    slot = { hash, i + 1 };
+                    break;
+                }
+            }
+        }
+        header.StringPoolOffset = DWORD(header.EntryAreaOffset + entryArea.size());
+        header.Size = DWORD(header.StringPoolOffset + stringPool.size() * sizeof(WCHAR));
+
+        vector<BYTE> region;
+        region.reserve(header.Size);
+        AppendBytes(region, &header, 1);
+        AppendBytes(region, entryOffsets.data(), entryOffsets.size());
+        AppendBytes(region, index.data(), index.size());
+        AppendBytes(region, entryArea.data(), entryArea.size());
+        AppendBytes(region, stringPool.data(), stringPool.size());
+        return region;
+    }
+
+    // Copy the region image into a new named file mapping, and point the game processes to it.
+    bool Publish(span<const BYTE> region) {
+        auto name = format(L"Local\\" L_(APP_NAME) L".GameConfigs.{}.{}", GetCurrentProcessId(), ++regionGeneration);
+        auto config = gs_sharedConfig;
+        if (name.size() >= ARRAYSIZE(config.GameConfigRegionName)) {
+            SetLastError(ERROR_FILENAME_EXCED_RANGE);
+            return false;
+        }
+        Handle mapping(CreateFileMappingW(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, DWORD(region.size()), name.c_str()));
+        MappedView view(mapping ? MapViewOfFile(mapping.get(), FILE_MAP_WRITE, 0, 0, 0) : NULL);
+        if (!view)
+            return false;
+        memcpy(view.get(), region.data(), region.size());
+        view.reset();
+
+        wcscpy(config.GameConfigRegionName, name.c_str());
+        seqlock::Write(gs_sharedConfigSequence, gs_sharedConfig, config);
+        regionMapping = move(mapping);
+        return true;
+    }
+
+    // Look up the config of the given process in the named region, see SharedConfig::GameConfigRegionName.
+    bool Find(const WCHAR* regionName, const WCHAR* processName, GameConfig& gameConfig) {
+        if (regionName[0] == L'\0')
+            return false;
+        Handle mapping(OpenFileMappingW(FILE_MAP_READ, FALSE, regionName));
+        MappedView view(mapping ? MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0) : NULL);
+        if (!view)
+            return false;
+
+        auto region = (const BYTE*)view.get();
+        auto& header = *(const RegionHeader*)region;
+        if (header.Magic != RegionMagic)
+            return false;
+        auto entryOffsets = (const DWORD*)(region + sizeof(RegionHeader));
+        auto index = (const IndexSlot*)(region + header.IndexOffset);
+        auto stringPool = (const WCHAR*)(region + header.StringPoolOffset);
+
+        auto hash = HashProcessName(processName);
+        for (auto slotIdx = hash & (header.IndexSize - 1); ; slotIdx = (slotIdx + 1) & (header.IndexSize - 1)) {
+            auto& slot = index[slotIdx];
+            if (slot.Ordinal == 0)
+                return false;
+            auto entry = region + entryOffsets[slot.Ordinal - 1];
+            auto& packed = *(const PackedGameConfig*)entry;
+            auto entryProcessName = stringPool + packed.ProcessNameOffset;
+            if (slot.Hash != hash || !IsSameProcessName(entryProcessName, processName))
+                continue;
+
+            gameConfig = {};
+            wcsncpy(gameConfig.ProcessName, entryProcessName, ARRAYSIZE(gameConfig.ProcessName) - 1);
+            gameConfig.Address.Length = packed.AddressLength < ARRAYSIZE(gameConfig.Address.Level) ? int(packed.AddressLength) : ARRAYSIZE(gameConfig.Address.Level);
+            memcpy(gameConfig.Address.Level, entry + sizeof(PackedGameConfig), gameConfig.Address.Length * sizeof(DWORD));
+            auto pathCode = entry + sizeof(PackedGameConfig) + packed.AddressLength * sizeof(DWORD);
+            gameConfig.Path.Length = packed.PathLength < ARRAYSIZE(gameConfig.Path.Code) ? int(packed.PathLength) : ARRAYSIZE(gameConfig.Path.Code);
+            memcpy(gameConfig.Path.Code, pathCode, gameConfig.Path.Length * sizeof(DWORD));
+            auto signatureBytes = pathCode + packed.PathLength * sizeof(DWORD);
+            gameConfig.Signature.Length = packed.SignatureLength < ARRAYSIZE(gameConfig.Signature.Bytes) ? int(packed.SignatureLength) : ARRAYSIZE(gameConfig.Signature.Bytes);
+            memcpy(gameConfig.Signature.Bytes, signatureBytes, gameConfig.Signature.Length);
+            memcpy(gameConfig.Signature.Mask, signatureBytes + packed.SignatureLength, gameConfig.Signature.Length);
+            gameConfig.Signature.Offset = packed.SignatureOffset;
+            gameConfig.ScriptType = packed.ScriptType;
+            gameConfig.ScriptRunPlace = packed.ScriptRunPlace;
+            gameConfig.ScriptPositionGetMethod = packed.ScriptPositionGetMethod;
+            gameConfig.PosDataType = packed.PosDataType;
+            gameConfig.BasePixelOffset = packed.BasePixelOffset;
+            gameConfig.BaseHeight = packed.BaseHeight;
+            gameConfig.AspectRatio = packed.AspectRatio;
+            gameConfig.InputMethods = packed.InputMethods;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include "framework.h"
+#include <span>
+#include <vector>
+
+#include "../Common/macro.h"
+#include "../Common/DataTypes.h"
+
+namespace core::gameconfigregion {
+    std::vector<BYTE> Build(std::span<const GameConfig> gameConfigs);
+    bool Publish(std::span<const BYTE> region);
+    bool Find(const WCHAR* regionName, const WCHAR* processName, GameConfig& gameConfig);
+}
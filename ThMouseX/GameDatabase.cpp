@@ -0,0 +1,154 @@
+#include "framework.h"
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../Common/macro.h"
+#include "../Common/DataTypes.h"
+#include "GameDatabase.h"
+
+using namespace std;
+
+#define GameDatabaseFile "Games.bin"
+#define GameDatabaseTempFile GameDatabaseFile ".tmp"
+
+/*
+Games.bin layout:
+- DatabaseHeader
+- string pool: null-terminated UTF-8 names of the source files, referenced by SourceStamp::NameOffset
+- game config region image, as built by core::gameconfigregion, starting at DatabaseHeader::RegionOffset
+The checksum covers everything after the header.
+*/
+constexpr DWORD DatabaseMagic = 'GXMT';
+// bump this whenever the region layout or the layout above changes
+constexpr DWORD DatabaseVersion = 4;
+constexpr auto MaxSourceCount = 4;
+
+struct SourceStamp {
+    DWORD       NameOffset;
+    DWORD       Exists;
+    ULONGLONG   Size;
+    FILETIME    LastWriteTime;
+};
+
+struct DatabaseHeader {
+    DWORD       Magic;
+    DWORD       Version;
+    DWORD       Checksum;
+    DWORD       RegionSize;
+    DWORD       RegionOffset;
+    DWORD       SourceCount;
+    DWORD       StringPoolSize;
+    SourceStamp Sources[MaxSourceCount];
+};
+
+DWORD CalculateChecksum(const BYTE* data, size_t size) {
+    // FNV-1a
+    DWORD hash = 2166136261;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619;
+    }
+    return hash;
+}
+
+SourceStamp GetSourceStamp(const char* sourcePath) {
+    SourceStamp stamp{};
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (GetFileAttributesExA(sourcePath, GetFileExInfoStandard, &attributes) == FALSE)
+        return stamp;
+    stamp.Exists = TRUE;
+    stamp.Size = (ULONGLONG(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+    stamp.LastWriteTime = attributes.ftLastWriteTime;
+    return stamp;
+}
+
+bool IsSameStamp(const SourceStamp& left, const SourceStamp& right) {
+    return left.Exists == right.Exists
+        && left.Size == right.Size
+        && left.LastWriteTime.dwLowDateTime == right.LastWriteTime.dwLowDateTime
+        && left.LastWriteTime.dwHighDateTime == right.LastWriteTime.dwHighDateTime;
+}
+
+namespace core::gamedatabase {
+    // Read the region image from Games.bin, only if it was compiled from the current state of the source files.
+    bool Load(span<const char* const> sourcePaths, vector<BYTE>& region) {
+        if (sourcePaths.size() > MaxSourceCount)
+            return false;
+
+        Handle file(CreateFileA(GameDatabaseFile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL));
+        if (file.get() == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER fileSize{};
+        if (GetFileSizeEx(file.get(), &fileSize) == FALSE || ULONGLONG(fileSize.QuadPart) < sizeof(DatabaseHeader))
+            return false;
+        Handle mapping(CreateFileMappingA(file.get(), NULL, PAGE_READONLY, 0, 0, NULL));
+        MappedView view(mapping ? MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0) : NULL);
+        if (!view)
+            return false;
+
+        auto data = (const BYTE*)view.get();
+        auto size = size_t(fileSize.QuadPart);
+        auto& header = *(const DatabaseHeader*)data;
+        if (header.Magic != DatabaseMagic || header.Version != DatabaseVersion || header.SourceCount != sourcePaths.size())
+            return false;
+        if (header.RegionOffset < sizeof(DatabaseHeader) + header.StringPoolSize
+            || header.RegionOffset + ULONGLONG(header.RegionSize) != size)
+            return false;
+
+        for (size_t i = 0; i < sourcePaths.size(); i++) {
+            if (!IsSameStamp(header.Sources[i], GetSourceStamp(sourcePaths[i])))
+                return false;
+        }
+
+        if (header.Checksum != CalculateChecksum(data + sizeof(DatabaseHeader), size - sizeof(DatabaseHeader)))
+            return false;
+
+        region.assign(data + header.RegionOffset, data + size);
+
+        return true;
+    }
+
+    // Compile the region image into Games.bin, stamped with the given source files.
+    bool Save(span<const char* const> sourcePaths, span<const BYTE> region) {
+        if (sourcePaths.size() > MaxSourceCount)
+            return false;
+
+        DatabaseHeader header{
+            .Magic = DatabaseMagic,
+            .Version = DatabaseVersion,
+            .RegionSize = DWORD(region.size()),
+            .SourceCount = DWORD(sourcePaths.size()),
+        };
+
+        string stringPool;
+        for (size_t i = 0; i < sourcePaths.size(); i++) {
+            header.Sources[i] = GetSourceStamp(sourcePaths[i]);
+            header.Sources[i].NameOffset = DWORD(stringPool.size());
+            stringPool.append(sourcePaths[i]).push_back('\0');
+        }
+        // keep the region image aligned
+        stringPool.resize((stringPool.size() + sizeof(DWORD) - 1) / sizeof(DWORD) * sizeof(DWORD));
+        header.StringPoolSize = DWORD(stringPool.size());
+        header.RegionOffset = DWORD(sizeof(DatabaseHeader) + stringPool.size());
+
+        vector<BYTE> payload(stringPool.begin(), stringPool.end());
+        payload.insert(payload.end(), region.begin(), region.end());
+        header.Checksum = CalculateChecksum(payload.data(), payload.size());
+
+        // write to a temporary file first, so a reader never sees a half-written database
+        Handle file(CreateFileA(GameDatabaseTempFile, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL));
+        if (file.get() == INVALID_HANDLE_VALUE)
+            return false;
+        DWORD written;
+        auto succeeded = WriteFile(file.get(), &header, sizeof(header), &written, NULL) != FALSE && written == sizeof(header);
+        if (succeeded)
+            succeeded = WriteFile(file.get(), payload.data(), DWORD(payload.size()), &written, NULL) != FALSE && written == payload.size();
+        file.reset();
+        if (succeeded)
+            succeeded = MoveFileExA(GameDatabaseTempFile, GameDatabaseFile, MOVEFILE_REPLACE_EXISTING) != FALSE;
+        if (!succeeded)
+            DeleteFileA(GameDatabaseTempFile);
+        return succeeded;
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include "framework.h"
+#include <span>
+#include <vector>
+
+#include "../Common/macro.h"
+
+namespace core::gamedatabase {
+    bool Load(std::span<const char* const> sourcePaths, std::vector<BYTE>& region);
+    bool Save(std::span<const char* const> sourcePaths, std::span<const BYTE> region);
+}
@@ -1,19 +1,41 @@
 #include "ImGuiOverlay.h"
 #include <imgui.h>
 #include <cmath>
+#include <string>
+#include <format>
 #include <nameof.hpp>
 #include "imgui_impl_win32.h"
 #include "../Common/Variables.h"
 #include "../Common/Helper.Encoding.h"
 #include "../Common/Helper.Memory.h"
 #include "../Common/Helper.h"
+#include "../Common/MemoryView.h"
+#include "InputDetermine.h"
+#include "RawInput.h"
+#include "InputRecorder.h"
 
 namespace encoding = common::helper::encoding;
 namespace memory = common::helper::memory;
-namespace helper = common::helper;
+namespace memoryview = common::memoryview;
+namespace inputdetermine = core::inputdetermine;
+namespace rawinput = core::rawinput;
+namespace inputrecorder = core::inputrecorder;
 
 using namespace std;
 
+// Save the memory of the game next to ThMouseX, for the pointer scan of ThMouseXGUI --pointer-scan,
+// or only its writable memory for --value-scan.
+string SaveMemorySnapshot(bool writableOnly) {
+    SYSTEMTIME time;
+    GetLocalTime(&time);
+    auto snapshotPath = format(L"{}\\{}.{:04}{:02}{:02}-{:02}{:02}{:02}.snapshot", g_currentModuleDirPath, inputdetermine::ReadConfig().Game.ProcessName,
+        time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond);
+    auto address = inputdetermine::CalculatePositionAddress();
+    if (!memoryview::SaveSnapshot(snapshotPath.c_str(), writableOnly))
+        return format("Failed to save the snapshot (error {}).", GetLastError());
+    return format("Saved {}\nPosition address then: {:X}", encoding::ConvertToUtf8(snapshotPath.c_str()), address);
+}
+
 namespace core::imguioverlay {
     void Prepare() {
         IMGUI_CHECKVERSION();
@@ -25,10 +47,11 @@ namespace core::imguioverlay {
     void Configure(float fontScale) {
         auto& io = ImGui::GetIO();
         io.Fonts->Clear();
-        auto fontSize = round(gs_imGuiBaseFontSize * fontScale);
+        auto& config = inputdetermine::ReadConfig();
+        auto fontSize = round(config.Shared.ImGuiBaseFontSize * fontScale);
         if (fontSize < 13)
             io.Fonts->AddFontDefault();
-        else if (!io.Fonts->AddFontFromFileTTF(encoding::ConvertToUtf8(gs_imGuiFontPath).c_str(), fontSize))
+        else if (!io.Fonts->AddFontFromFileTTF(encoding::ConvertToUtf8(config.Shared.ImGuiFontPath).c_str(), fontSize))
             io.Fonts->AddFontDefault();
     }
     ImDrawData* Render(unsigned int renderWidth, unsigned int renderHeight, float mouseScaleX, float mouseScaleY) {
@@ -36,6 +59,8 @@ namespace core::imguioverlay {
         io.DisplaySize = ImVec2((float)renderWidth, (float)renderHeight);
         ImGui_ImplWin32_SetMousePosScale(mouseScaleX, mouseScaleY);
         ImGui::NewFrame();
+        // a reload can change any of it, so nothing of the config is kept from one frame to the next
+        auto& config = inputdetermine::ReadConfig();
 
         static auto showVariableViewer = false;
         static auto showImGuiDemoWindow = false;
@@ -70,14 +95,17 @@ namespace core::imguioverlay {
                 static auto showState = false;
                 ImGui::Checkbox("Show State", &showState);
                 if (showState) {
-                    auto child_size = ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * 6.5f);
+                    auto child_size = ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * 8.5f);
                     if (ImGui::BeginChildFrame(ImGui::GetID("Debug_State"), child_size)) {
-                        auto mousePos = helper::GetPointerPosition();
+                        auto mousePos = rawinput::GetPointerPosition();
                         auto simulatedInput = string(NAMEOF_ENUM_FLAG(g_gameInput));
+                        auto inputStats = inputdetermine::GetLastFrameStats();
                         ImGui::Text("Mouse Position:\t(%d,%d)", mousePos.x, mousePos.y);
                         ImGui::Text("Player Position (Scaled):\t(%d,%d)", g_playerPos.x, g_playerPos.y);
                         ImGui::Text("Player Position (Raw):\t(%g,%g)", g_playerPosRaw.X, g_playerPosRaw.Y);
                         ImGui::Text("Simulated Input:\t%s", simulatedInput.c_str());
+                        ImGui::Text("Input Computations / Reuses per Frame:\t%u / %u", inputStats.Computations, inputStats.CacheHits);
+                        ImGui::Text("Mouse to Input Latency:\t%.2f ms", inputStats.PointerLatencyMs);
                         ImGui::Text("Pixel Rate:\t%g", g_pixelRate);
                         ImGui::Text("Pixel Offset:\t(%g,%g)", g_pixelOffset.X, g_pixelOffset.Y);
                     }
@@ -88,22 +116,22 @@ namespace core::imguioverlay {
                 if (showGameConfig) {
                     auto child_size = ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * 10.5f);
                     if (ImGui::BeginChildFrame(ImGui::GetID("Debug_GameConfig"), child_size)) {
-                        static auto procName = encoding::ConvertToUtf8(g_currentConfig.ProcessName);
-                        static auto procAddr = memory::GetAddressConfigAsString();
-                        static auto scriptType = string(NAMEOF_ENUM(g_currentConfig.ScriptType));
-                        static auto scriptRunPlace = string(NAMEOF_ENUM(g_currentConfig.ScriptRunPlace));
-                        static auto scriptPosGetMethod = string(NAMEOF_ENUM(g_currentConfig.ScriptPositionGetMethod));
-                        static auto posDataType = string(NAMEOF_ENUM(g_currentConfig.PosDataType));
-                        static auto inputMethod = string(NAMEOF_ENUM_FLAG(g_currentConfig.InputMethods));
+                        auto procName = encoding::ConvertToUtf8(config.Game.ProcessName);
+                        auto procAddr = memory::GetAddressConfigAsString(config.Game);
+                        auto scriptType = string(NAMEOF_ENUM(config.Game.ScriptType));
+                        auto scriptRunPlace = string(NAMEOF_ENUM(config.Game.ScriptRunPlace));
+                        auto scriptPosGetMethod = string(NAMEOF_ENUM(config.Game.ScriptPositionGetMethod));
+                        auto posDataType = string(NAMEOF_ENUM(config.Game.PosDataType));
+                        auto inputMethod = string(NAMEOF_ENUM_FLAG(config.Game.InputMethods));
                         ImGui::Text("Process Name:\t%s", procName.c_str());
                         ImGui::Text("Position Address:\t%s", procAddr.c_str());
                         ImGui::Text("Script Type:\t%s", scriptType.c_str());
                         ImGui::Text("Script Run Place:\t%s", scriptRunPlace.c_str());
                         ImGui::Text("Script Position Get Method:\t%s", scriptPosGetMethod.c_str());
                         ImGui::Text("Position Data Type:\t%s", posDataType.c_str());
-                        ImGui::Text("Base Pixel Offset:\t(%g,%g)", g_currentConfig.BasePixelOffset.X, g_currentConfig.BasePixelOffset.Y);
-                        ImGui::Text("Base Height:\t%d", g_currentConfig.BaseHeight);
-                        ImGui::Text("Aspect Ratio:\t(%g,%g)", g_currentConfig.AspectRatio.X, g_currentConfig.AspectRatio.Y);
+                        ImGui::Text("Base Pixel Offset:\t(%g,%g)", config.Game.BasePixelOffset.X, config.Game.BasePixelOffset.Y);
+                        ImGui::Text("Base Height:\t%d", config.Game.BaseHeight);
+                        ImGui::Text("Aspect Ratio:\t(%g,%g)", config.Game.AspectRatio.X, config.Game.AspectRatio.Y);
                         ImGui::Text("Input Method(s):\t%s", inputMethod.c_str());
                     }
                     ImGui::EndChildFrame();
@@ -111,23 +139,55 @@ namespace core::imguioverlay {
                 static auto showGlobalConfig = false;
                 ImGui::Checkbox("Show Global Config", &showGlobalConfig);
                 if (showGlobalConfig) {
-                    auto child_size = ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * 9.5f);
+                    auto child_size = ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * 10.5f);
                     if (ImGui::BeginChildFrame(ImGui::GetID("Debug_GlobalConfig"), child_size)) {
-                        static auto bombBtn = ImGui_ImplWin32_VirtualKeyToImGuiKey(gs_bombButton);
-                        static auto extraBtn = ImGui_ImplWin32_VirtualKeyToImGuiKey(gs_extraButton);
-                        static auto toggleCurBtn = ImGui_ImplWin32_VirtualKeyToImGuiKey(gs_toggleOsCursorButton);
-                        static auto toggleImGBtn = ImGui_ImplWin32_VirtualKeyToImGuiKey(gs_toggleImGuiButton);
-                        static auto texturePath = encoding::ConvertToUtf8(gs_textureFilePath);
-                        static auto imGuiFontPath = encoding::ConvertToUtf8(gs_imGuiFontPath);
-                        ImGui::Text("Bomb Button:\t\"%s\" 0x%X", ImGui::GetKeyName(bombBtn), gs_bombButton);
-                        ImGui::Text("Extra Button:\t\"%s\" 0x%X", ImGui::GetKeyName(extraBtn), gs_extraButton);
-                        ImGui::Text("Toggle Os Cursor Button:\t\"%s\" 0x%X", ImGui::GetKeyName(toggleCurBtn), gs_toggleOsCursorButton);
-                        ImGui::Text("Toggle ImGUI Button:\t\"%s\" 0x%X", ImGui::GetKeyName(toggleImGBtn), gs_toggleImGuiButton);
+                        auto bombBtn = ImGui_ImplWin32_VirtualKeyToImGuiKey(config.Shared.BombButton);
+                        auto extraBtn = ImGui_ImplWin32_VirtualKeyToImGuiKey(config.Shared.ExtraButton);
+                        auto toggleCurBtn = ImGui_ImplWin32_VirtualKeyToImGuiKey(config.Shared.ToggleOsCursorButton);
+                        auto toggleImGBtn = ImGui_ImplWin32_VirtualKeyToImGuiKey(config.Shared.ToggleImGuiButton);
+                        auto texturePath = encoding::ConvertToUtf8(config.Shared.TextureFilePath);
+                        auto imGuiFontPath = encoding::ConvertToUtf8(config.Shared.ImGuiFontPath);
+                        ImGui::Text("Bomb Button:\t\"%s\" 0x%X", ImGui::GetKeyName(bombBtn), config.Shared.BombButton);
+                        ImGui::Text("Extra Button:\t\"%s\" 0x%X", ImGui::GetKeyName(extraBtn), config.Shared.ExtraButton);
+                        ImGui::Text("Toggle Os Cursor Button:\t\"%s\" 0x%X", ImGui::GetKeyName(toggleCurBtn), config.Shared.ToggleOsCursorButton);
+                        ImGui::Text("Toggle ImGUI Button:\t\"%s\" 0x%X", ImGui::GetKeyName(toggleImGBtn), config.Shared.ToggleImGuiButton);
                         ImGui::Text("Cursor Texture File Path:\t%s", texturePath.c_str());
-                        ImGui::Text("Cursor Texture Base Height:\t%d", gs_textureBaseHeight);
+                        ImGui::Text("Cursor Texture Base Height:\t%d", config.Shared.TextureBaseHeight);
                         ImGui::Text("ImGUI Font Path:\t%s", imGuiFontPath.c_str());
-                        ImGui::Text("ImGUI Base Font Size:\t%d", gs_imGuiBaseFontSize);
-                        ImGui::Text("ImGUI Base Vertical Resolution:\t%d", gs_imGuiBaseVerticalResolution);
+                        ImGui::Text("ImGUI Base Font Size:\t%d", config.Shared.ImGuiBaseFontSize);
+                        ImGui::Text("ImGUI Base Vertical Resolution:\t%d", config.Shared.ImGuiBaseVerticalResolution);
+                        ImGui::Text("Movement Mode:\t%s", string(NAMEOF_ENUM(config.Shared.MovementMode)).c_str());
+                        ImGui::Text("Input Thread Rate:\t%u Hz", config.Shared.InputThreadRate);
+                    }
+                    ImGui::EndChildFrame();
+                }
+                static auto showMemorySnapshot = false;
+                ImGui::Checkbox("Show Memory Snapshot", &showMemorySnapshot);
+                if (showMemorySnapshot) {
+                    auto child_size = ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * 5.5f);
+                    if (ImGui::BeginChildFrame(ImGui::GetID("Debug_MemorySnapshot"), child_size)) {
+                        static string snapshotResult;
+                        static auto writableOnly = false;
+                        ImGui::Text("Position Address:\t%X", inputdetermine::CalculatePositionAddress());
+                        ImGui::Checkbox("Writable Regions Only", &writableOnly);
+                        if (ImGui::Button("Save Memory Snapshot"))
+                            snapshotResult = SaveMemorySnapshot(writableOnly);
+                        ImGui::TextUnformatted(snapshotResult.c_str());
+                    }
+                    ImGui::EndChildFrame();
+                }
+                static auto showInputRecording = false;
+                ImGui::Checkbox("Show Input Recording", &showInputRecording);
+                if (showInputRecording) {
+                    auto child_size = ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * 3.5f);
+                    if (ImGui::BeginChildFrame(ImGui::GetID("Debug_InputRecording"), child_size)) {
+                        // replayed with ThMouseXGUI --replay
+                        static string recordingResult;
+                        if (!inputrecorder::IsRecording() && ImGui::Button("Start Recording Input"))
+                            recordingResult = inputrecorder::Start();
+                        else if (inputrecorder::IsRecording() && ImGui::Button("Stop Recording Input"))
+                            recordingResult = inputrecorder::Stop();
+                        ImGui::TextUnformatted(recordingResult.c_str());
                     }
                     ImGui::EndChildFrame();
                 }
@@ -12,10 +12,13 @@
 #include "../Common/MinHook.h"
 #include "../Common/CallbackStore.h"
 #include "../Common/Variables.h"
+#include "../Common/SeqLock.h"
+#include "../Common/KeyBindings.h"
 #include "../Common/LuaApi.h"
 #include "../Common/LuaJIT.h"
 #include "../Common/Lua.h"
 #include "../Common/NeoLua.h"
+#include "../Common/Signature.h"
 #include "KeyboardState.h"
 #include "SendKey.h"
 #include "MessageQueue.h"
@@ -23,6 +26,8 @@
 #include "Direct3D8.h"
 #include "Direct3D9.h"
 #include "Direct3D11.h"
+#include "GameConfigRegion.h"
+#include "InputDetermine.h"
 
 namespace minhook = common::minhook;
 namespace callbackstore = common::callbackstore;
@@ -37,9 +42,14 @@ namespace directx9 = core::directx9;
 namespace directx11 = core::directx11;
 namespace directinput = core::directinput;
 namespace keyboardstate = core::keyboardstate;
+namespace gameconfigregion = core::gameconfigregion;
+namespace inputdetermine = core::inputdetermine;
 namespace note = common::log;
 namespace encoding = common::helper::encoding;
 namespace memory = common::helper::memory;
+namespace seqlock = common::seqlock;
+namespace signature = common::signature;
+namespace keybindings = common::keybindings;
 
 #define LOAD_LIBRARY_AS_RES (LOAD_LIBRARY_AS_DATAFILE | LOAD_LIBRARY_AS_DATAFILE_EXCLUSIVE | LOAD_LIBRARY_AS_IMAGE_RESOURCE)
 
@@ -90,36 +100,36 @@ namespace core {
         if (_wcsicmp(currentProcessName, L_(APP_NAME "GUI")) == 0)
             return;
 
-        for (auto ord = gs_gameConfigs.length(); ord > 0; ord--) {
-            auto i = ord - 1;
-            if (_wcsicmp(currentProcessName, gs_gameConfigs[i].ProcessName) == 0) {
-                g_currentConfig = gs_gameConfigs[i];
-
-                minhook::Initialize();
-                luaapi::Initialize();
-                lua::Initialize();
-                luajit::Initialize();
-                neolua::Initialize();
-
-                directx11::Initialize();
-                directx9::Initialize();
-                directx8::Initialize();
-
-                directinput::Initialize();
-                sendkey::Initialize();
-                keyboardstate::Initialize();
-                messagequeue::Initialize();
-
-                minhook::CreateApiHook(std::vector<minhook::HookApiConfig> {
-                    { L"KERNELBASE.dll", "LoadLibraryExW", &_LoadLibraryExW, (PVOID*)&OriLoadLibraryExW },
-                });
-
-                minhook::EnableAll();
-                g_hookApplied = true;
-
-                break;
-            }
-        }
+        if (!seqlock::Read(gs_sharedConfigSequence, gs_sharedConfig, g_sharedConfig, g_sharedConfigSequence))
+            return;
+        keybindings::Publish(g_sharedConfig);
+        if (!gameconfigregion::Find(g_sharedConfig.GameConfigRegionName, currentProcessName, g_currentConfig))
+            return;
+        if (!signature::ApplyTo(g_currentConfig, g_targetModule))
+            note::ToFile("[Initialization] The position signature was not found in the game module.");
+
+        minhook::Initialize();
+        luaapi::Initialize();
+        lua::Initialize();
+        luajit::Initialize();
+        neolua::Initialize();
+
+        directx11::Initialize();
+        directx9::Initialize();
+        directx8::Initialize();
+
+        directinput::Initialize();
+        sendkey::Initialize();
+        keyboardstate::Initialize();
+        messagequeue::Initialize();
+        inputdetermine::Initialize();
+
+        minhook::CreateApiHook(std::vector<minhook::HookApiConfig> {
+            { L"KERNELBASE.dll", "LoadLibraryExW", &_LoadLibraryExW, (PVOID*)&OriLoadLibraryExW },
+        });
+
+        minhook::EnableAll();
+        g_hookApplied = true;
     }
 
     HMODULE WINAPI _LoadLibraryExW(LPCWSTR lpLibFileName, HANDLE hFile, DWORD dwFlags) {
@@ -0,0 +1,59 @@
+#include "framework.h"
+#include <cmath>
+#include <cstring>
+
+#include "../Common/DataTypes.h"
+#include "../Common/Variables.h"
+#include "../Common/InputLog.h"
+#include "MovementControl.h"
+#include "PositionReader.h"
+#include "InputDecision.h"
+
+namespace inputlog = common::inputlog;
+namespace movementcontrol = core::movementcontrol;
+namespace positionreader = core::positionreader;
+
+using namespace std;
+
+namespace core::inputdecision {
+    GameInput Decide(const inputlog::Frame& frame, const positionreader::PositionReader& reader, DWORD address, movementcontrol::MovementState& state) {
+        auto gameInput = GameInput::NONE;
+        if (!frame.InputEnabled && !frame.ShowImGui) {
+            movementcontrol::Reset(state);
+            return gameInput;
+        }
+        if (frame.LeftPressed) {
+            gameInput |= GameInput::USE_BOMB;
+        }
+        if (frame.MidPressed) {
+            gameInput |= GameInput::USE_SPECIAL;
+        }
+        if (!frame.HasPosition) {
+            movementcontrol::Reset(state);
+            return gameInput;
+        }
+        auto playerPos = reader.Read(reader, address);
+        g_playerPos = { lrint(playerPos.X), lrint(playerPos.Y) };
+        // these modes learn from the keys they pressed, so they only run while the keys are really sent
+        DoublePoint target{ double(frame.MousePosition.x), double(frame.MousePosition.y) };
+        if (frame.InputEnabled && frame.MovementMode == MovementMode::Predictive)
+            return gameInput | movementcontrol::MovePredictive(state, playerPos, target);
+        if (frame.InputEnabled && frame.MovementMode == MovementMode::Proportional)
+            return gameInput | movementcontrol::MoveProportional(state, playerPos, target);
+        if (frame.InputEnabled && frame.MovementMode == MovementMode::Straight)
+            return gameInput | movementcontrol::MoveStraight(state, playerPos, target);
+        movementcontrol::Reset(state);
+        return gameInput | movementcontrol::MoveClassic(g_playerPos, frame.MousePosition);
+    }
+
+    GameInput Replay(const inputlog::Frame& frame, movementcontrol::MovementState& state) {
+        // the game makes a reader when the measurement changes, not for each frame
+        static positionreader::PositionReader reader;
+        if (reader.Read == nullptr || memcmp(&reader.ClientSize, &frame.ClientSize, sizeof(SIZE)) != 0
+            || memcmp(&reader.AspectRatio, &frame.AspectRatio, sizeof(FloatPoint)) != 0
+            || memcmp(&reader.PixelRate, &frame.PixelRate, sizeof(float)) != 0
+            || memcmp(&reader.PixelOffset, &frame.PixelOffset, sizeof(FloatPoint)) != 0)
+            reader = positionreader::Make(PointDataType::Double, frame.ClientSize, frame.AspectRatio, frame.PixelRate, frame.PixelOffset);
+        return Decide(frame, reader, DWORD(&frame.PlayerPositionRaw), state);
+    }
+}
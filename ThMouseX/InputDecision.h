@@ -0,0 +1,15 @@
+#pragma once
+#include "framework.h"
+#include "../Common/DataTypes.h"
+#include "../Common/InputLog.h"
+#include "MovementControl.h"
+#include "PositionReader.h"
+
+namespace core::inputdecision {
+    // The input from what the frame says and the player position the reader finds at the address, also sets g_playerPos.
+    // Used by the game and by the replays of input logs alike, so a replay computes the same input the game did.
+    GameInput Decide(const common::inputlog::Frame& frame, const positionreader::PositionReader& reader, DWORD address, movementcontrol::MovementState& state);
+    // The input of a frame of an input log, computed the way the game computed it. The state carries what the movement
+    // modes remember from one frame to the next, from a zeroed one for the first frame.
+    GameInput Replay(const common::inputlog::Frame& frame, movementcontrol::MovementState& state);
+}
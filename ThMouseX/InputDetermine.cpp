@@ -1,69 +1,406 @@
 #include "framework.h"
-#include <cmath>
+#include <atomic>
+#include <mutex>
+#include <cstring>
 
 #include "../Common/Variables.h"
 #include "../Common/Helper.h"
+#include "../Common/Helper.Memory.h"
 #include "../Common/DataTypes.h"
+#include "../Common/CallbackStore.h"
+#include "../Common/SeqLock.h"
+#include "../Common/Signature.h"
+#include "../Common/PointerPath.h"
+#include "../Common/Log.h"
+#include "../Common/InputLog.h"
+#include "../Common/HookState.h"
+#include "../Common/KeyBindings.h"
+#include "GameConfigRegion.h"
+#include "MovementControl.h"
+#include "PositionReader.h"
+#include "InputDecision.h"
+#include "RawInput.h"
+#include "InputRecorder.h"
 #include "InputDetermine.h"
 
-template <typename T>
-void CalculatePosition(T position, POINT& output) {
+namespace helper = common::helper;
+namespace memory = common::helper::memory;
+namespace callbackstore = common::callbackstore;
+namespace gameconfigregion = core::gameconfigregion;
+namespace seqlock = common::seqlock;
+namespace signature = common::signature;
+namespace pointerpath = common::pointerpath;
+namespace note = common::log;
+namespace movementcontrol = core::movementcontrol;
+namespace positionreader = core::positionreader;
+namespace inputdecision = core::inputdecision;
+namespace rawinput = core::rawinput;
+namespace inputrecorder = core::inputrecorder;
+namespace inputlog = common::inputlog;
+namespace hookstate = common::hookstate;
+namespace keybindings = common::keybindings;
+
+using namespace std;
+
+positionreader::PositionReader positionReader;
+bool positionReaderStale = true;
+
+void PreparePositionReader() {
     RECTSIZE clientSize{};
     GetClientRect(g_hFocusWindow, &clientSize);
-    auto realWidth = clientSize.height() * g_currentConfig.AspectRatio.X / g_currentConfig.AspectRatio.Y;
-    auto paddingX = (clientSize.width() - realWidth) / 2;
-    g_playerPosRaw = { (double)(position)->X, (double)(position)->Y };
-    output.x = lrint((position)->X / g_pixelRate + g_pixelOffset.X + paddingX);
-    output.y = lrint((position)->Y / g_pixelRate + g_pixelOffset.Y);
+    positionReader = positionreader::Make(g_currentConfig.PosDataType, { clientSize.width(), clientSize.height() },
+        g_currentConfig.AspectRatio, g_pixelRate, g_pixelOffset);
+    positionReaderStale = false;
 }
 
-void CalculatePlayerPos(DWORD address) {
-    if (g_currentConfig.PosDataType == PointDataType::Int)
-        CalculatePosition((IntPoint*)address, g_playerPos);
-    else if (g_currentConfig.PosDataType == PointDataType::Float)
-        CalculatePosition((FloatPoint*)address, g_playerPos);
-    else if (g_currentConfig.PosDataType == PointDataType::Short)
-        CalculatePosition((ShortPoint*)address, g_playerPos);
-    else if (g_currentConfig.PosDataType == PointDataType::Double)
-        CalculatePosition((DoublePoint*)address, g_playerPos);
+void ClearMeasurementFlags() {
+    positionReaderStale = true;
 }
 
-namespace helper = common::helper;
+void UpdatePositionReader() {
+    // the measurement is redone lazily by the renderer after the flags are cleared, so watch its results too
+    if (positionReaderStale || positionReader.PixelRate != g_pixelRate
+        || positionReader.PixelOffset.X != g_pixelOffset.X || positionReader.PixelOffset.Y != g_pixelOffset.Y)
+        PreparePositionReader();
+}
 
-namespace core::inputdetermine {
-    GameInput DetermineGameInput() {
-        g_gameInput = GameInput::NONE;
-        g_playerPos = {};
-        g_playerPosRaw = {};
-        DWORD address{};
-        if (g_inputEnabled || g_showImGui) {
-            if (g_leftMousePressed) {
-                g_gameInput |= GameInput::USE_BOMB;
-            }
-            if (g_midMousePressed) {
-                g_gameInput |= GameInput::USE_SPECIAL;
-            }
-            address = helper::CalculateAddress();
-            if (address != 0) {
-                CalculatePlayerPos(address);
+movementcontrol::MovementState movementState;
+// the recording the movement state was last computed for, see inputrecorder::GetRecordingNumber
+DWORD movementStateRecording;
+// QueryPerformanceCounter of the mouse movement the input was computed from, 0 when the position was polled
+atomic<LONGLONG> inputPointerTime;
+// held while computing the input or replacing the config it's computed from, the input thread computes it too
+mutex computeMutex;
+// the config published for core::inputdetermine::ReadConfig, written with computeMutex held
+core::inputdetermine::ConfigSnapshot configSnapshot;
+DWORD configSnapshotSequence;
+
+void PublishConfigSnapshot() {
+    seqlock::Write(configSnapshotSequence, configSnapshot, { g_sharedConfig, g_currentConfig });
+}
+
+// Returns whether the shared config was reloaded.
+bool ReloadConfigIfUpdated() {
+    if (!seqlock::HasChanged(gs_sharedConfigSequence, g_sharedConfigSequence))
+        return false;
+    const lock_guard lock(computeMutex);
+    SharedConfig sharedConfig;
+    if (!seqlock::Read(gs_sharedConfigSequence, gs_sharedConfig, sharedConfig, g_sharedConfigSequence))
+        return false;
+    auto regionChanged = wcscmp(sharedConfig.GameConfigRegionName, g_sharedConfig.GameConfigRegionName) != 0;
+    GameConfig newConfig;
+    auto found = regionChanged && gameconfigregion::Find(sharedConfig.GameConfigRegionName, g_currentConfig.ProcessName, newConfig);
+    // Only the latest region is kept open, so the GUI publishing again can make this one vanish before it's found.
+    // Keep the name of the region the config came from, then the next region published is looked up again.
+    if (regionChanged && !found)
+        wcscpy(sharedConfig.GameConfigRegionName, g_sharedConfig.GameConfigRegionName);
+    g_sharedConfig = sharedConfig;
+    keybindings::Publish(g_sharedConfig);
+    if (!found) {
+        PublishConfigSnapshot();
+        return true;
+    }
+    // hooks and scripts are set up at attach time, so keep the settings they were set up with
+    newConfig.ScriptType = g_currentConfig.ScriptType;
+    newConfig.ScriptRunPlace = g_currentConfig.ScriptRunPlace;
+    newConfig.ScriptPositionGetMethod = g_currentConfig.ScriptPositionGetMethod;
+    newConfig.InputMethods = g_currentConfig.InputMethods;
+    // scanning the module again is only needed for a new signature
+    if (memcmp(&newConfig.Signature, &g_currentConfig.Signature, sizeof(Signature)) == 0) {
+        newConfig.Address.Level[0] = g_currentConfig.Address.Level[0];
+        if (newConfig.Signature.Length > 0 && g_currentConfig.Address.Length == 0)
+            newConfig.Address.Length = 0;
+    }
+    else if (!signature::ApplyTo(newConfig, g_targetModule))
+        note::ToFile("[InputDetermine] The position signature was not found in the game module.");
+    auto geometryChanged = newConfig.BaseHeight != g_currentConfig.BaseHeight
+        || newConfig.BasePixelOffset.X != g_currentConfig.BasePixelOffset.X
+        || newConfig.BasePixelOffset.Y != g_currentConfig.BasePixelOffset.Y
+        || newConfig.AspectRatio.X != g_currentConfig.AspectRatio.X
+        || newConfig.AspectRatio.Y != g_currentConfig.AspectRatio.Y;
+    g_currentConfig = newConfig;
+    PublishConfigSnapshot();
+    pointerpath::ResetLastHit();
+    // the data type may have changed too
+    positionReaderStale = true;
+    if (geometryChanged)
+        callbackstore::TriggerClearMeasurementFlagsCallbacks();
+    return true;
+}
+
+// state is a copy of the hook flags, so the input is decided from flags of the same moment
+void ComputeGameInput(HookState state) {
+    g_playerPos = {};
+    g_playerPosRaw = {};
+    inputlog::Frame frame{
+        .FrameCount = callbackstore::FrameCount(),
+        .InputEnabled = hookstate::Has(state, HookState::InputEnabled),
+        .ShowImGui = hookstate::Has(state, HookState::ShowImGui),
+        .LeftPressed = hookstate::Has(state, HookState::LeftMousePressed),
+        .MidPressed = hookstate::Has(state, HookState::MidMousePressed),
+        .MovementMode = g_sharedConfig.MovementMode,
+    };
+    DWORD address = 0;
+    if (frame.InputEnabled || frame.ShowImGui)
+        address = helper::CalculateAddress();
+    if (address != 0) {
+        UpdatePositionReader();
+        // a chain can end at garbage between stages
+        frame.HasPosition = memory::IsReadable(address, positionReader.Size);
+    }
+    if (frame.HasPosition) {
+        auto pointer = rawinput::GetPointerSample();
+        frame.MousePosition = pointer.Position;
+        inputPointerTime.store(pointer.Time, memory_order_relaxed);
+    }
+    // a replay starts from a zeroed state, so each recording does too, or it wouldn't compute the recorded inputs
+    auto recording = inputrecorder::GetRecordingNumber();
+    if (recording != 0 && recording != movementStateRecording)
+        movementState = {};
+    movementStateRecording = recording;
+    g_gameInput = inputdecision::Decide(frame, positionReader, address, movementState);
+    if (recording != 0) {
+        frame.PlayerPositionRaw = g_playerPosRaw;
+        frame.ClientSize = positionReader.ClientSize;
+        frame.AspectRatio = positionReader.AspectRatio;
+        frame.PixelRate = positionReader.PixelRate;
+        frame.PixelOffset = positionReader.PixelOffset;
+        frame.GameInput = g_gameInput;
+        inputrecorder::Record(frame);
+    }
+}
+
+/*
+A game with several input methods, e.g. DirectInput and GetKeyboardState, asks for the input several times per frame.
+The first call of a frame computes it and the others reuse it. The time limit keeps the input fresh
+for games whose frames aren't counted, their g_frameCount never moves.
+*/
+constexpr LONGLONG InputLifetimeMs = 8;
+
+struct CachedInput {
+    bool        Valid;
+    DWORD       Frame;
+    LONGLONG    Time;
+    bool        PositionComputed;
+};
+// only used under computeMutex
+CachedInput cachedInput;
+
+// Guards the counts and the pointer latency. It's apart from computeMutex, so counting an input the input thread
+// published doesn't wait for the thread to compute the next one.
+mutex statsMutex;
+// counts of the frame in progress, moved to lastFrameStats when the next one starts
+core::inputdetermine::InputStats frameStats;
+core::inputdetermine::InputStats lastFrameStats;
+DWORD statsFrame;
+
+void CountInput(bool computed) {
+    const lock_guard lock(statsMutex);
+    auto frame = callbackstore::FrameCount();
+    if (statsFrame != frame) {
+        lastFrameStats = frameStats;
+        frameStats = {};
+        statsFrame = frame;
+    }
+    if (computed)
+        frameStats.Computations++;
+    else
+        frameStats.CacheHits++;
+}
+
+LONGLONG GetFrequency() {
+    static auto frequency = [] {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        return frequency.QuadPart;
+    }();
+    return frequency;
+}
+
+LONGLONG GetTimeMs() {
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart * 1000 / GetFrequency();
+}
+
+// From the mouse movement to the hook handing the input computed from it to the game, measured once per movement.
+LONGLONG measuredPointerTime;
+double pointerLatencyMs;
+
+void MeasurePointerLatency() {
+    auto pointerTime = inputPointerTime.load(memory_order_relaxed);
+    const lock_guard lock(statsMutex);
+    if (pointerTime == 0 || pointerTime == measuredPointerTime)
+        return;
+    measuredPointerTime = pointerTime;
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    pointerLatencyMs = double(counter.QuadPart - pointerTime) * 1000 / GetFrequency();
+}
 
-                auto mousePos = helper::GetPointerPosition();
+/*
+The input thread computes the input at InputThreadRate instead of the hooks, so the game's threads don't pay for it
+and the input doesn't wait for a frame to be fresh. It publishes the input and the time it computed it at in one word,
+the hooks read both with a single load and never wait for the thread:
+bits 0-31 the time in ms, bits 32-62 the GameInput, bit 63 set while there is a published input.
+The other movement modes step once per frame, so the thread only publishes in the Classic mode.
+*/
+constexpr ULONGLONG PublishedFlag = 1ULL << 63;
+atomic<ULONGLONG> publishedInput;
+/*
+The input thread holds a reference to ThMouseX, or it would be unloaded under the thread when the hooks are removed,
+and DllMain couldn't wait for the thread to exit while it holds the loader lock. So ThMouseX is only unloaded
+after the thread let it go, which it does when the GUI that installed the hooks exits, the hooks are gone by then.
+*/
+HANDLE inputThreadTimer;
+HANDLE guiProcess;
+HMODULE inputThreadModule;
+
+ULONGLONG PackInput(GameInput input, LONGLONG time) {
+    return PublishedFlag | ULONGLONG(DWORD(input) & 0x7FFF'FFFF) << 32 | DWORD(time);
+}
+
+// An input older than InputLifetimeMs is stale, the thread is stuck or stopped publishing.
+bool IsFreshInput(ULONGLONG published, LONGLONG now) {
+    return (published & PublishedFlag) != 0 && DWORD(now) - DWORD(published) < InputLifetimeMs;
+}
+
+DWORD WINAPI RunInputThread(PVOID) {
+    HANDLE waits[]{ inputThreadTimer, guiProcess };
+    while (true) {
+        DWORD rate;
+        {
+            const lock_guard lock(computeMutex);
+            rate = g_sharedConfig.MovementMode == MovementMode::Classic ? g_sharedConfig.InputThreadRate : 0;
+            if (rate != 0)
+                ComputeGameInput(hookstate::Load());
+            publishedInput.store(rate != 0 ? PackInput(g_gameInput, GetTimeMs()) : 0, memory_order_release);
+        }
+        // check a few times per second while not publishing, so the thread notices when it can publish again
+        LARGE_INTEGER dueTime{ .QuadPart = -LONGLONG(10'000'000 / (rate != 0 ? rate : 4)) };
+        SetWaitableTimer(inputThreadTimer, &dueTime, 0, NULL, NULL, FALSE);
+        if (WaitForMultipleObjects(ARRAYSIZE(waits), waits, FALSE, INFINITE) != WAIT_OBJECT_0)
+            break;
+    }
+    publishedInput.store(0, memory_order_release);
+    CloseHandle(inputThreadTimer);
+    CloseHandle(guiProcess);
+    // unloads ThMouseX if the hooks were removed already, so nothing of it may run after this
+    FreeLibraryAndExitThread(inputThreadModule, 0);
+}
+
+void StartInputThread() {
+    if (g_sharedConfig.InputThreadRate == 0)
+        return;
+    // a script runs on the game's threads: one pulled from can't be called from another thread,
+    // and one that pushes sets the address while the game can free what it pointed at
+    if (g_currentConfig.ScriptType != ScriptType::None) {
+        note::ToFile("[InputDetermine] No input thread, the position comes from a script.");
+        return;
+    }
+    // a regular timer waits for 15.6 ms at least, which is no better than the game's frames
+    auto timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (timer == NULL) {
+        note::ToFile("[InputDetermine] No input thread, high resolution timers need Windows 10 1803 or later.");
+        return;
+    }
+    guiProcess = OpenProcess(SYNCHRONIZE, FALSE, gs_guiProcessId);
+    if (guiProcess == NULL) {
+        note::LastErrorToFile("[InputDetermine] No input thread, failed to open the process that installed the hooks.");
+        CloseHandle(timer);
+        return;
+    }
+    if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS, (LPCWSTR)RunInputThread, &inputThreadModule)) {
+        note::LastErrorToFile("[InputDetermine] No input thread, failed to hold a reference to ThMouseX.");
+        CloseHandle(timer);
+        CloseHandle(guiProcess);
+        return;
+    }
+    inputThreadTimer = timer;
+    auto thread = CreateThread(NULL, 0, RunInputThread, NULL, 0, NULL);
+    if (thread == NULL) {
+        note::LastErrorToFile("[InputDetermine] Failed to create the input thread.");
+        CloseHandle(timer);
+        CloseHandle(guiProcess);
+        FreeLibrary(inputThreadModule);
+        return;
+    }
+    // its input is sent as soon as it's computed, so it shouldn't wait behind the game's threads
+    SetThreadPriority(thread, THREAD_PRIORITY_ABOVE_NORMAL);
+    CloseHandle(thread);
+}
 
-                if (g_playerPos.x < mousePos.x - 1)
-                    g_gameInput |= GameInput::MOVE_RIGHT;
-                else if (g_playerPos.x > mousePos.x + 1)
-                    g_gameInput |= GameInput::MOVE_LEFT;
+namespace core::inputdetermine {
+    void Initialize() {
+        PublishConfigSnapshot();
+        PreparePositionReader();
+        callbackstore::RegisterClearMeasurementFlagsCallback(ClearMeasurementFlags);
+        StartInputThread();
+    }
 
-                if (g_playerPos.y < mousePos.y - 1)
-                    g_gameInput |= GameInput::MOVE_DOWN;
-                else if (g_playerPos.y > mousePos.y + 1)
-                    g_gameInput |= GameInput::MOVE_UP;
+    GameInput DetermineGameInput() {
+        auto reloaded = ReloadConfigIfUpdated();
+        auto now = GetTimeMs();
+        auto state = hookstate::Load();
+        auto inputEnabled = hookstate::Has(state, HookState::InputEnabled);
+        // an input of the config before a reload is outdated
+        if (!reloaded) {
+            auto published = publishedInput.load(memory_order_acquire);
+            if (IsFreshInput(published, now)) {
+                CountInput(false);
+                if (!inputEnabled)
+                    return GameInput::NONE;
+                MeasurePointerLatency();
+                return GameInput(DWORD(published >> 32) & 0x7FFF'FFFF);
             }
         }
-        if (!g_inputEnabled) {
+        // InputEnabled and ShowImGui decide whether the position is computed at all
+        auto computesPosition = inputEnabled || hookstate::Has(state, HookState::ShowImGui);
+        bool computed;
+        GameInput gameInput;
+        {
+            const lock_guard lock(computeMutex);
+            auto frame = callbackstore::FrameCount();
+            computed = reloaded || !cachedInput.Valid || cachedInput.Frame != frame
+                || now - cachedInput.Time >= InputLifetimeMs || cachedInput.PositionComputed != computesPosition;
+            if (computed) {
+                ComputeGameInput(state);
+                cachedInput = {
+                    .Valid = true,
+                    .Frame = frame,
+                    .Time = now,
+                    .PositionComputed = computesPosition,
+                };
+            }
+            gameInput = g_gameInput;
+        }
+        CountInput(computed);
+        if (!inputEnabled) {
             return GameInput::NONE;
         }
 
-        return g_gameInput;
+        MeasurePointerLatency();
+        return gameInput;
+    }
+
+    InputStats GetLastFrameStats() {
+        const lock_guard lock(statsMutex);
+        auto stats = lastFrameStats;
+        stats.PointerLatencyMs = pointerLatencyMs;
+        return stats;
+    }
+
+    DWORD CalculatePositionAddress() {
+        const lock_guard lock(computeMutex);
+        return helper::CalculateAddress();
+    }
+
+    const ConfigSnapshot& ReadConfig() {
+        // odd, which a published sequence never is, so the first call of a thread always copies
+        thread_local DWORD sequence = 1;
+        thread_local ConfigSnapshot config;
+        if (seqlock::HasChanged(configSnapshotSequence, sequence))
+            seqlock::Read(configSnapshotSequence, configSnapshot, config, sequence);
+        return config;
     }
 }
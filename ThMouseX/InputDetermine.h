@@ -3,5 +3,28 @@
 #include "../Common/DataTypes.h"
 
 namespace core::inputdetermine {
+    struct InputStats {
+        // how many times the input was computed, and how many times a computed one was reused
+        DWORD Computations;
+        DWORD CacheHits;
+        // from the latest raw mouse movement to the input computed from it, 0 while the position is polled
+        double PointerLatencyMs;
+    };
+
+    struct ConfigSnapshot {
+        SharedConfig Shared;
+        GameConfig   Game;
+    };
+
+    // Choose how the position is read for the data type of the game config,
+    // and start the input thread when InputThreadRate isn't 0.
+    void Initialize();
     GameInput DetermineGameInput();
+    // the counts of the last complete frame
+    InputStats GetLastFrameStats();
+    // helper::CalculateAddress, for callers on other threads than the ones computing the input
+    DWORD CalculatePositionAddress();
+    // g_sharedConfig and g_currentConfig as of the latest reload, for the threads that read them without the lock of the
+    // input, e.g. the renderer. The copy belongs to the calling thread and is only copied again after a reload.
+    const ConfigSnapshot& ReadConfig();
 }
@@ -0,0 +1,131 @@
+#include "framework.h"
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <format>
+#include <nameof.hpp>
+
+#include "../Common/macro.h"
+#include "../Common/DataTypes.h"
+#include "../Common/Variables.h"
+#include "../Common/Helper.h"
+#include "../Common/Helper.Encoding.h"
+#include "../Common/InputLog.h"
+#include "MovementControl.h"
+#include "InputDetermine.h"
+#include "InputDecision.h"
+#include "InputRecorder.h"
+
+namespace helper = common::helper;
+namespace encoding = common::helper::encoding;
+namespace inputlog = common::inputlog;
+namespace inputdetermine = core::inputdetermine;
+namespace inputdecision = core::inputdecision;
+namespace movementcontrol = core::movementcontrol;
+
+using namespace std;
+
+// the differing frames after that many are only counted
+constexpr DWORD MaxPrintedDivergences = 20;
+
+mutex recorderMutex;
+// the recording being written, counted from 1, 0 while not recording
+atomic<DWORD> recordingNumber;
+DWORD startedCount;
+inputlog::Writer writer;
+wstring logPath;
+DWORD recordedCount;
+bool writeFailed;
+
+string FormatInput(GameInput input) {
+    auto name = string(NAMEOF_ENUM_FLAG(input));
+    return name.empty() ? "NONE" : name;
+}
+
+namespace core::inputrecorder {
+    string Start() {
+        const lock_guard lock(recorderMutex);
+        if (recordingNumber != 0)
+            return "Already recording.";
+        SYSTEMTIME time;
+        GetLocalTime(&time);
+        logPath = format(L"{}\\{}.{:04}{:02}{:02}-{:02}{:02}{:02}.inputlog", g_currentModuleDirPath, inputdetermine::ReadConfig().Game.ProcessName,
+            time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond);
+        if (!inputlog::Open(writer, logPath.c_str()))
+            return format("Failed to create the input log (error {}).", GetLastError());
+        recordedCount = 0;
+        writeFailed = false;
+        recordingNumber = ++startedCount;
+        return format("Recording to {}", encoding::ConvertToUtf8(logPath.c_str()));
+    }
+
+    string Stop() {
+        const lock_guard lock(recorderMutex);
+        if (recordingNumber == 0)
+            return "Not recording.";
+        recordingNumber = 0;
+        if (!inputlog::Close(writer) || writeFailed)
+            return format("Failed to write the input log (error {}).", GetLastError());
+        return format("Saved {} frames to {}", recordedCount, encoding::ConvertToUtf8(logPath.c_str()));
+    }
+
+    bool IsRecording() {
+        return GetRecordingNumber() != 0;
+    }
+
+    DWORD GetRecordingNumber() {
+        return recordingNumber.load(memory_order_relaxed);
+    }
+
+    void Record(const inputlog::Frame& frame) {
+        const lock_guard lock(recorderMutex);
+        if (recordingNumber == 0 || writeFailed)
+            return;
+        if (!inputlog::Append(writer, frame))
+            writeFailed = true;
+        recordedCount++;
+    }
+
+    bool ReplayInput(const WCHAR* logPath) {
+        vector<inputlog::Frame> frames;
+        if (!inputlog::Read(logPath, frames)) {
+            helper::ReportLastError(APP_NAME ": Failed to read the input log");
+            return false;
+        }
+
+        LARGE_INTEGER frequency, start, end;
+        QueryPerformanceFrequency(&frequency);
+        movementcontrol::MovementState state{};
+        vector<GameInput> inputs(frames.size());
+        LONGLONG slowest = 0;
+        QueryPerformanceCounter(&start);
+        for (size_t i = 0; i < frames.size(); i++) {
+            LARGE_INTEGER frameStart, frameEnd;
+            QueryPerformanceCounter(&frameStart);
+            inputs[i] = inputdecision::Replay(frames[i], state);
+            QueryPerformanceCounter(&frameEnd);
+            if (frameEnd.QuadPart - frameStart.QuadPart > slowest)
+                slowest = frameEnd.QuadPart - frameStart.QuadPart;
+        }
+        QueryPerformanceCounter(&end);
+
+        string report;
+        DWORD divergenceCount = 0;
+        for (size_t i = 0; i < frames.size(); i++) {
+            if (inputs[i] == frames[i].GameInput)
+                continue;
+            if (++divergenceCount <= MaxPrintedDivergences) {
+                report += format("; frame {} (#{}): recorded {}, replayed {}\n", i, frames[i].FrameCount,
+                    FormatInput(frames[i].GameInput), FormatInput(inputs[i]));
+            }
+        }
+        auto toNanoseconds = 1e9 / frequency.QuadPart;
+        auto average = frames.empty() ? 0 : (end.QuadPart - start.QuadPart) * toNanoseconds / frames.size();
+        report = format("; {}: {} frames, {} differ\n; {:.0f} ns per frame on average, {:.0f} ns at most (timer resolution {:.0f} ns)\n",
+            encoding::ConvertToUtf8(logPath), frames.size(), divergenceCount, average, slowest * toNanoseconds, toNanoseconds) + report;
+        if (!helper::PrintToConsole(report))
+            MessageBoxA(NULL, report.c_str(), APP_NAME, MB_OK | (divergenceCount == 0 ? MB_ICONINFORMATION : MB_ICONWARNING));
+        return divergenceCount == 0;
+    }
+}
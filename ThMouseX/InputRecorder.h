@@ -0,0 +1,19 @@
+#pragma once
+#include "framework.h"
+#include <string>
+#include "../Common/macro.h"
+#include "../Common/InputLog.h"
+
+namespace core::inputrecorder {
+    // Start writing an input log next to ThMouseX, returns what to tell the user.
+    std::string Start();
+    std::string Stop();
+    bool IsRecording();
+    // Which recording is being written, counted from 1 since the game started, 0 while not recording.
+    DWORD GetRecordingNumber();
+    // Add a frame to the log being written, called for each computation of the input.
+    void Record(const common::inputlog::Frame& frame);
+    // Compute the input of each frame of the log again and print the frames where it isn't the recorded one,
+    // and how long a frame took. Fails when the log can't be read or a frame differs.
+    DLLEXPORT_C bool ReplayInput(const WCHAR* logPath);
+}
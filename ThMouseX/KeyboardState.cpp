@@ -5,10 +5,12 @@
 #include "../Common/MinHook.h"
 #include "../Common/Variables.h"
 #include "../Common/DataTypes.h"
+#include "../Common/KeyBindings.h"
 #include "KeyboardState.h"
 #include "InputDetermine.h"
 
 namespace minhook = common::minhook;
+namespace keybindings = common::keybindings;
 
 using namespace std;
 using namespace core::inputdetermine;
@@ -29,10 +31,15 @@ namespace core::keyboardstate {
         auto rs = OriGetKeyboardState(lpKeyState);
         if (rs != FALSE) {
             auto gameInput = DetermineGameInput();
+            auto keyBindings = keybindings::Load();
             if ((gameInput & GameInput::USE_BOMB) == GameInput::USE_BOMB)
-                lpKeyState[gs_bombButton] |= 0x80;
+                lpKeyState[keyBindings.BombButton] |= 0x80;
             if ((gameInput & GameInput::USE_SPECIAL) == GameInput::USE_SPECIAL)
-                lpKeyState[gs_extraButton] |= 0x80;
+                lpKeyState[keyBindings.ExtraButton] |= 0x80;
+            if ((gameInput & GameInput::USE_FOCUS) == GameInput::USE_FOCUS) {
+                lpKeyState[VK_SHIFT] |= 0x80;
+                lpKeyState[VK_LSHIFT] |= 0x80;
+            }
             if ((gameInput & GameInput::MOVE_LEFT) == GameInput::MOVE_LEFT)
                 lpKeyState[VK_LEFT] |= 0x80;
             if ((gameInput & GameInput::MOVE_RIGHT) == GameInput::MOVE_RIGHT)
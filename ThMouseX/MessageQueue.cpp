@@ -10,14 +10,20 @@
 #include "../Common/NeoLua.h"
 #include "../Common/CallbackStore.h"
 #include "../Common/Log.h"
+#include "../Common/HookState.h"
+#include "../Common/KeyBindings.h"
 #include "Initialization.h"
 #include "MessageQueue.h"
+#include "RawInput.h"
 
 namespace minhook = common::minhook;
 namespace neolua = common::neolua;
 namespace helper = common::helper;
 namespace callbackstore = common::callbackstore;
 namespace note = common::log;
+namespace rawinput = core::rawinput;
+namespace hookstate = common::hookstate;
+namespace keybindings = common::keybindings;
 
 using namespace std;
 
@@ -56,7 +62,7 @@ namespace core::messagequeue {
     auto hCursor = LoadCursorA(NULL, IDC_ARROW);
 
     HCURSOR WINAPI _SetCursor(HCURSOR hCursor) {
-        if (g_showImGui)
+        if (hookstate::Has(hookstate::Load(), HookState::ShowImGui))
             return OriSetCursor(hCursor);
         return NULL;
     }
@@ -98,39 +104,53 @@ namespace core::messagequeue {
     LRESULT CALLBACK GetMsgProcW(int code, WPARAM wParam, LPARAM lParam) {
         auto e = (PMSG)lParam;
         if (code == HC_ACTION && g_hookApplied && g_hFocusWindow && e->hwnd == g_hFocusWindow) {
-            HandleKeyboardPress(e, gs_toggleImGuiButton, { {
-                g_showImGui = !g_showImGui;
-                if (g_showImGui) {
-                    g_inputEnabled = false;
+            rawinput::Register();
+            // a message that is only peeked comes again when it's removed
+            if (e->message == WM_INPUT && wParam == PM_REMOVE)
+                rawinput::HandleInput(HRAWINPUT(e->lParam));
+            auto keyBindings = keybindings::Load();
+            HandleKeyboardPress(e, keyBindings.ToggleImGuiButton, { {
+                // the input is disabled in the same step, the render hooks never see ImGui shown with the input on
+                auto state = hookstate::Update([](HookState current) {
+                    if (hookstate::Has(current, HookState::ShowImGui))
+                        return HookState(DWORD(current) & ~DWORD(HookState::ShowImGui));
+                    return HookState(DWORD(current | HookState::ShowImGui) & ~DWORD(HookState::InputEnabled));
+                });
+                if (hookstate::Has(state, HookState::ShowImGui))
                     ShowMousePointer();
-                }
                 else
                     HideMousePointer();
                 } }
             );
-            if (g_showImGui) {
+            auto state = hookstate::Load();
+            if (hookstate::Has(state, HookState::ShowImGui)) {
                 ImGui_ImplWin32_WndProcHandler(e->hwnd, e->message, e->wParam, e->lParam);
             }
             else {
-                HandleKeyboardPress(e, gs_toggleOsCursorButton, isCursorShow ? HideMousePointer() : ShowMousePointer());
+                HandleKeyboardPress(e, keyBindings.ToggleOsCursorButton, isCursorShow ? HideMousePointer() : ShowMousePointer());
             }
-            auto wantCaptureMouse = g_showImGui && ImGui::GetIO().WantCaptureMouse;
+            auto wantCaptureMouse = hookstate::Has(state, HookState::ShowImGui) && ImGui::GetIO().WantCaptureMouse;
             HandleMousePress(e, WM_LBUTTON, { {
-                g_leftMousePressed = wantCaptureMouse ? false : true;
                 if (wantCaptureMouse)
-                    g_inputEnabled = false;
-            } }, g_leftMousePressed = false);
+                    hookstate::Set(HookState::LeftMousePressed | HookState::InputEnabled, false);
+                else
+                    hookstate::Set(HookState::LeftMousePressed, true);
+            } }, hookstate::Set(HookState::LeftMousePressed, false));
             HandleMousePress(e, WM_MBUTTON, { {
-                g_midMousePressed = wantCaptureMouse ? false : true;
                 if (wantCaptureMouse)
-                    g_inputEnabled = false;
-                else
+                    hookstate::Set(HookState::MidMousePressed | HookState::InputEnabled, false);
+                else {
+                    hookstate::Set(HookState::MidMousePressed, true);
                     ImGui::SetWindowFocus();
-            } }, g_midMousePressed = false);
+                }
+            } }, hookstate::Set(HookState::MidMousePressed, false));
             HandleMousePress(e, WM_RBUTTON, 0, { {
-                g_inputEnabled = wantCaptureMouse ? false : !g_inputEnabled;
-                if (!wantCaptureMouse)
+                if (wantCaptureMouse)
+                    hookstate::Set(HookState::InputEnabled, false);
+                else {
+                    hookstate::Toggle(HookState::InputEnabled);
                     ImGui::SetWindowFocus();
+                }
             } });
         }
         return CallNextHookEx(NULL, code, wParam, lParam);
@@ -148,10 +168,15 @@ namespace core::messagequeue {
                 NormalizeCursor();
             }
             auto e = (PCWPRETSTRUCT)lParam;
-            if (g_showImGui) {
+            // the raw mouse movements don't tell where the cursor is after these
+            if (e->hwnd == g_hFocusWindow && (e->message == WM_MOVE || e->message == WM_SIZE || e->message == WM_ACTIVATEAPP
+                || e->message == WM_SETTINGCHANGE || e->message == WM_DISPLAYCHANGE))
+                rawinput::Reconcile();
+            auto state = hookstate::Load();
+            if (hookstate::Has(state, HookState::ShowImGui)) {
                 ImGui_ImplWin32_WndProcHandler(e->hwnd, e->message, e->wParam, e->lParam);
             }
-            else if (e->message == WM_SETCURSOR && !g_showImGui) {
+            else if (e->message == WM_SETCURSOR) {
                 if (LOWORD(e->lParam) == HTCLIENT) {
                     if (isCursorShow)
                         ShowMousePointer();
@@ -165,10 +190,9 @@ namespace core::messagequeue {
             }
             else if (e->message == WM_SIZE && g_hFocusWindow) {
                 if (e->wParam == SIZE_MINIMIZED) {
-                    g_isMinimized = true;
+                    hookstate::Set(HookState::Minimized, true);
                 }
-                else if (e->wParam == SIZE_RESTORED && g_isMinimized) {
-                    g_isMinimized = false;
+                else if (e->wParam == SIZE_RESTORED && hookstate::Has(hookstate::Set(HookState::Minimized, false), HookState::Minimized)) {
                     callbackstore::TriggerClearMeasurementFlagsCallbacks();
                 }
             }
@@ -187,6 +211,7 @@ namespace core::messagequeue {
     HHOOK CallWndRetProcHandle;
 
     bool InstallHooks() {
+        gs_guiProcessId = GetCurrentProcessId();
         GetMsgProcHandle = SetWindowsHookExW(WH_GETMESSAGE, GetMsgProcW, g_coreModule, NULL);
         if (!CheckHookProcHandle(GetMsgProcHandle))
             return false;
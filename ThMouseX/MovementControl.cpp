@@ -0,0 +1,245 @@
+#include "framework.h"
+#include <cmath>
+
+#include "../Common/DataTypes.h"
+#include "MovementControl.h"
+
+using namespace std;
+using core::movementcontrol::MovementState;
+using core::movementcontrol::Press;
+using core::movementcontrol::MaxLatencyFrames;
+
+// within that many pixels of the cursor the player is there
+constexpr double Deadzone = 1;
+// a longer move in one sample is a respawn or a new stage, not movement
+constexpr double MaxStep = 64;
+// MoveProportional aims to cover the distance to the cursor in that many frames
+constexpr double ApproachFrames = 2;
+// a cursor moving more than that in a frame makes MoveStraight start a new line
+constexpr double MaxCursorStep = 16;
+
+// The speed of the player on each axis, guessing the focus speed as half the full speed until it's seen.
+DoublePoint StepOf(const MovementState& state, bool focus) {
+    if (!focus)
+        return state.Step;
+    return {
+        state.FocusStep.X > 0 ? state.FocusStep.X : state.Step.X / 2,
+        state.FocusStep.Y > 0 ? state.FocusStep.Y : state.Step.Y / 2,
+    };
+}
+
+// Learn the speeds and the latency from the new position, returns whether the player moved since the last one.
+bool Observe(MovementState& state, DoublePoint player) {
+    auto moved = false;
+    if (state.HasLastPosition) {
+        auto stepX = abs(player.X - state.LastPosition.X);
+        auto stepY = abs(player.Y - state.LastPosition.Y);
+        if (stepX > MaxStep || stepY > MaxStep) {
+            core::movementcontrol::Reset(state);
+        }
+        else {
+            // the press applied by the game since the last position
+            auto& step = state.Pressed[state.Latency].Focus ? state.FocusStep : state.Step;
+            if (stepX > 0)
+                step.X = stepX;
+            if (stepY > 0)
+                step.Y = stepY;
+            moved = stepX > 0 || stepY > 0;
+        }
+    }
+    state.HasLastPosition = true;
+    state.LastPosition = player;
+
+    if (state.LatencyCount > 0) {
+        if (moved) {
+            state.Latency = state.LatencyCount - 1;
+            state.LatencyCount = 0;
+        }
+        // the player can't move, e.g. it's against a wall
+        else if (++state.LatencyCount >= MaxLatencyFrames) {
+            state.LatencyCount = 0;
+        }
+    }
+    return moved;
+}
+
+// Where the player ends up once the game has applied the keys pressed so far.
+DoublePoint Predict(const MovementState& state, DoublePoint player) {
+    for (DWORD i = 0; i < state.Latency; i++) {
+        auto& press = state.Pressed[i];
+        auto step = StepOf(state, press.Focus);
+        player.X += press.Direction.x * step.X;
+        player.Y += press.Direction.y * step.Y;
+    }
+    return player;
+}
+
+bool IsIdle(const MovementState& state) {
+    for (auto& press : state.Pressed) {
+        if (press.Direction.x != 0 || press.Direction.y != 0)
+            return false;
+    }
+    return true;
+}
+
+GameInput Record(MovementState& state, Press press, bool moved) {
+    auto pressing = press.Direction.x != 0 || press.Direction.y != 0;
+    // a press after the player rested long enough for every earlier press to be applied: whatever moves it next is this one
+    if (pressing && state.LatencyCount == 0 && !moved && IsIdle(state))
+        state.LatencyCount = 1;
+    for (auto i = MaxLatencyFrames - 1; i > 0; i--)
+        state.Pressed[i] = state.Pressed[i - 1];
+    state.Pressed[0] = press;
+
+    auto gameInput = GameInput::NONE;
+    if (press.Direction.x > 0)
+        gameInput |= GameInput::MOVE_RIGHT;
+    else if (press.Direction.x < 0)
+        gameInput |= GameInput::MOVE_LEFT;
+    if (press.Direction.y > 0)
+        gameInput |= GameInput::MOVE_DOWN;
+    else if (press.Direction.y < 0)
+        gameInput |= GameInput::MOVE_UP;
+    if (press.Focus && pressing)
+        gameInput |= GameInput::USE_FOCUS;
+    return gameInput;
+}
+
+// How far the position is from the line through origin and target.
+double DistanceFromLine(DoublePoint position, DoublePoint origin, DoublePoint target) {
+    auto lineX = target.X - origin.X;
+    auto lineY = target.Y - origin.Y;
+    auto length = hypot(lineX, lineY);
+    if (length == 0)
+        return hypot(position.X - origin.X, position.Y - origin.Y);
+    return abs((position.X - origin.X) * lineY - (position.Y - origin.Y) * lineX) / length;
+}
+
+// -1, 0 or 1, the direction to press on one axis.
+LONG PredictAxis(double error, double step) {
+    // closer than half a step, one more step would only land as far on the other side
+    if (abs(error) <= Deadzone || abs(error) <= step / 2)
+        return 0;
+    return error > 0 ? 1 : -1;
+}
+
+// Error diffusion: press on the frames where the movement carried over reaches half a step.
+LONG DiffuseAxis(double wanted, double step, double& remainder) {
+    // the speed isn't known before the player has moved once
+    if (step <= 0)
+        return wanted > 0 ? 1 : wanted < 0 ? -1 : 0;
+    remainder += wanted;
+    if (abs(remainder) < step / 2)
+        return 0;
+    auto direction = remainder > 0 ? 1 : -1;
+    remainder -= direction * step;
+    return direction;
+}
+
+namespace core::movementcontrol {
+    GameInput MoveClassic(POINT player, POINT target) {
+        auto gameInput = GameInput::NONE;
+        if (player.x < target.x - 1)
+            gameInput |= GameInput::MOVE_RIGHT;
+        else if (player.x > target.x + 1)
+            gameInput |= GameInput::MOVE_LEFT;
+
+        if (player.y < target.y - 1)
+            gameInput |= GameInput::MOVE_DOWN;
+        else if (player.y > target.y + 1)
+            gameInput |= GameInput::MOVE_UP;
+        return gameInput;
+    }
+
+    GameInput MovePredictive(MovementState& state, DoublePoint player, DoublePoint target) {
+        auto moved = Observe(state, player);
+        auto predicted = Predict(state, player);
+        Press press{
+            .Direction = {
+                PredictAxis(target.X - predicted.X, state.Step.X),
+                PredictAxis(target.Y - predicted.Y, state.Step.Y),
+            },
+        };
+        return Record(state, press, moved);
+    }
+
+    GameInput MoveProportional(MovementState& state, DoublePoint player, DoublePoint target) {
+        auto moved = Observe(state, player);
+        auto predicted = Predict(state, player);
+        DoublePoint error{ target.X - predicted.X, target.Y - predicted.Y };
+        // close enough that even a focus step would overshoot, and nothing left to carry over
+        auto focusStep = StepOf(state, true);
+        if (abs(error.X) <= Deadzone || abs(error.X) <= focusStep.X / 2) {
+            error.X = 0;
+            state.Remainder.X = 0;
+        }
+        if (abs(error.Y) <= Deadzone || abs(error.Y) <= focusStep.Y / 2) {
+            error.Y = 0;
+            state.Remainder.Y = 0;
+        }
+
+        // follow the cursor at its own speed on top of that, so a moving cursor isn't trailed by ApproachFrames of it
+        DoublePoint cursorStep{};
+        if (state.HasLastTarget && abs(target.X - state.LastTarget.X) <= MaxStep && abs(target.Y - state.LastTarget.Y) <= MaxStep)
+            cursorStep = { target.X - state.LastTarget.X, target.Y - state.LastTarget.Y };
+        state.HasLastTarget = true;
+        state.LastTarget = target;
+        DoublePoint wanted{
+            error.X != 0 ? error.X / ApproachFrames + cursorStep.X : 0,
+            error.Y != 0 ? error.Y / ApproachFrames + cursorStep.Y : 0,
+        };
+        // the focus key is shared by both axes, so only hold it when it's fast enough for both
+        auto focus = abs(wanted.X) <= focusStep.X && abs(wanted.Y) <= focusStep.Y;
+        auto step = StepOf(state, focus);
+        // faster than the game can go isn't worth carrying over
+        if (step.X > 0 && abs(wanted.X) > step.X)
+            wanted.X = wanted.X > 0 ? step.X : -step.X;
+        if (step.Y > 0 && abs(wanted.Y) > step.Y)
+            wanted.Y = wanted.Y > 0 ? step.Y : -step.Y;
+        Press press{
+            .Direction = {
+                DiffuseAxis(wanted.X, step.X, state.Remainder.X),
+                DiffuseAxis(wanted.Y, step.Y, state.Remainder.Y),
+            },
+            .Focus = focus,
+        };
+        return Record(state, press, moved);
+    }
+
+    GameInput MoveStraight(MovementState& state, DoublePoint player, DoublePoint target) {
+        auto moved = Observe(state, player);
+        auto predicted = Predict(state, player);
+        // a new line starts when the player sets off, or when the cursor went somewhere else
+        auto cursorJumped = state.HasLastTarget
+            && (abs(target.X - state.LastTarget.X) > MaxCursorStep || abs(target.Y - state.LastTarget.Y) > MaxCursorStep);
+        if (!state.HasLastTarget || cursorJumped || IsIdle(state))
+            state.Origin = predicted;
+        state.HasLastTarget = true;
+        state.LastTarget = target;
+
+        Press press{
+            .Direction = {
+                PredictAxis(target.X - predicted.X, state.Step.X),
+                PredictAxis(target.Y - predicted.Y, state.Step.Y),
+            },
+        };
+        if (press.Direction.x != 0 && press.Direction.y != 0) {
+            DoublePoint diagonal{ predicted.X + press.Direction.x * state.Step.X, predicted.Y + press.Direction.y * state.Step.Y };
+            DoublePoint alongX{ diagonal.X, predicted.Y };
+            DoublePoint alongY{ predicted.X, diagonal.Y };
+            auto diagonalDistance = DistanceFromLine(diagonal, state.Origin, target);
+            auto alongXDistance = DistanceFromLine(alongX, state.Origin, target);
+            auto alongYDistance = DistanceFromLine(alongY, state.Origin, target);
+            // the diagonal on ties, it's the fastest
+            if (alongXDistance < diagonalDistance && alongXDistance <= alongYDistance)
+                press.Direction.y = 0;
+            else if (alongYDistance < diagonalDistance)
+                press.Direction.x = 0;
+        }
+        return Record(state, press, moved);
+    }
+
+    void Reset(MovementState& state) {
+        state = { .Latency = state.Latency };
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "framework.h"
+#include "../Common/DataTypes.h"
+
+/*
+How the player is moved toward the cursor, from both positions in client pixels.
+The movers only depend on their arguments and state, so they can be tried outside of a game, see Tests/MovementSimulator.cpp.
+*/
+namespace core::movementcontrol {
+    // the longest input latency handled, in frames
+    constexpr DWORD MaxLatencyFrames = 8;
+
+    struct Press {
+        // -1, 0 or 1 on each axis
+        POINT   Direction;
+        bool    Focus;
+    };
+
+    struct MovementState {
+        bool        HasLastPosition;
+        DoublePoint LastPosition;
+        // how far the player moved on each axis the last time it moved, i.e. the game's speeds
+        DoublePoint Step;
+        DoublePoint FocusStep;
+        // the keys pressed lately, newest first
+        Press       Pressed[MaxLatencyFrames];
+        // how many frames the game takes to move the player after a key is pressed, measured on each press from rest
+        DWORD       Latency;
+        // frames since that press while it's being measured, else 0
+        DWORD       LatencyCount;
+        // the movement wanted but not made yet, see MoveProportional
+        DoublePoint Remainder;
+        bool        HasLastTarget;
+        DoublePoint LastTarget;
+        // where the line followed by MoveStraight starts
+        DoublePoint Origin;
+    };
+
+    // Press toward the cursor until the player is within a pixel of it.
+    GameInput MoveClassic(POINT player, POINT target);
+    // Predict where the keys already pressed but not yet applied by the game take the player, at the speed it last
+    // moved, and press toward the cursor from there. The player stops early instead of overshooting.
+    GameInput MovePredictive(MovementState& state, DoublePoint player, DoublePoint target);
+    // Like MovePredictive, but aim for a speed proportional to the distance to the cursor. Speeds between the game's
+    // ones are made by holding the focus key and pressing the direction keys on some frames only, the movement left
+    // out of a frame is carried to the next ones so the average speed is the wanted one.
+    GameInput MoveProportional(MovementState& state, DoublePoint player, DoublePoint target);
+    // Like MovePredictive, but follow the straight line to the cursor instead of going diagonally until one axis
+    // is done. Each frame takes whichever of the diagonal and the two straight moves stays closest to the line,
+    // like Bresenham's line algorithm does with pixels.
+    GameInput MoveStraight(MovementState& state, DoublePoint player, DoublePoint target);
+    // Forget the positions and presses, e.g. when the player isn't there. The measured latency is kept.
+    void Reset(MovementState& state);
+}
@@ -0,0 +1,84 @@
+#include "framework.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <format>
+
+#include "../Common/macro.h"
+#include "../Common/DataTypes.h"
+#include "../Common/Helper.h"
+#include "../Common/Helper.Encoding.h"
+#include "../Common/MemoryView.h"
+#include "../Common/PointerScan.h"
+#include "PointerScanner.h"
+
+namespace helper = common::helper;
+namespace encoding = common::helper::encoding;
+namespace memoryview = common::memoryview;
+namespace pointerscan = common::pointerscan;
+
+using namespace std;
+
+#define CandidateFileSuffix L".candidates"
+#define FilteredFileSuffix L".filtered"
+
+// the first scan stops there, more candidates than that are too many to be worth filtering
+constexpr DWORD MaxChainCount = 1'000'000;
+
+// The shortest chains with the smallest offsets first, they are the most likely to be the ones the game uses.
+bool IsBetterChain(const AddressChain& left, const AddressChain& right) {
+    if (left.Length != right.Length)
+        return left.Length < right.Length;
+    return lexicographical_compare(left.Level + 1, left.Level + left.Length, right.Level + 1, right.Level + right.Length)
+        || (equal(left.Level + 1, left.Level + left.Length, right.Level + 1) && left.Level[0] < right.Level[0]);
+}
+
+namespace core::pointerscanner {
+    bool ScanPointers(const WCHAR* const* snapshotPaths, const DWORD* targetAddresses, int snapshotCount, int maxDepth, DWORD maxOffset) {
+        if (snapshotCount <= 0)
+            return false;
+        auto candidatePath = wstring(snapshotPaths[0]) + CandidateFileSuffix;
+        auto filteredPath = wstring(snapshotPaths[0]) + FilteredFileSuffix;
+        auto fail = [&](const char* title) {
+            helper::ReportLastError(title);
+            DeleteFileW(filteredPath.c_str());
+            DeleteFileW(candidatePath.c_str());
+            return false;
+        };
+
+        string report;
+        for (auto i = 0; i < snapshotCount; i++) {
+            auto snapshot = memoryview::OpenSnapshot(snapshotPaths[i]);
+            if (!snapshot)
+                return fail(APP_NAME ": Failed to open the memory snapshot");
+            DWORD chainCount;
+            if (i == 0) {
+                pointerscan::ScanOptions options{
+                    .MaxDepth = maxDepth,
+                    .MaxOffset = maxOffset,
+                    .MaxChainCount = MaxChainCount,
+                };
+                if (!pointerscan::Scan(*snapshot, targetAddresses[i], options, candidatePath.c_str(), chainCount))
+                    return fail(APP_NAME ": Failed to scan the memory snapshot");
+            }
+            else {
+                if (!pointerscan::Filter(candidatePath.c_str(), *snapshot, targetAddresses[i], filteredPath.c_str(), chainCount))
+                    return fail(APP_NAME ": Failed to filter the pointer chains");
+                if (MoveFileExW(filteredPath.c_str(), candidatePath.c_str(), MOVEFILE_REPLACE_EXISTING) == FALSE)
+                    return fail(APP_NAME ": Failed to filter the pointer chains");
+            }
+            report += format("; {}: {} chains{}\n", encoding::ConvertToUtf8(snapshotPaths[i]), chainCount, chainCount >= MaxChainCount ? ", stopped early" : "");
+        }
+
+        vector<AddressChain> chains;
+        if (!pointerscan::ReadCandidates(candidatePath.c_str(), chains))
+            return fail(APP_NAME ": Failed to read the pointer chains");
+        DeleteFileW(candidatePath.c_str());
+        sort(chains.begin(), chains.end(), IsBetterChain);
+        for (auto& chain : chains)
+            report += pointerscan::FormatChain(chain) + "\n";
+        if (!helper::PrintToConsole(report))
+            MessageBoxA(NULL, report.c_str(), APP_NAME, MB_OK | MB_ICONINFORMATION);
+        return true;
+    }
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include "framework.h"
+#include "../Common/macro.h"
+
+namespace core::pointerscanner {
+    // Scan the first snapshot for pointer chains to its target address, keep the ones that lead to the target address
+    // of every other snapshot too, and print them as positionRVAs.
+    DLLEXPORT_C bool ScanPointers(const WCHAR* const* snapshotPaths, const DWORD* targetAddresses, int snapshotCount, int maxDepth, DWORD maxOffset);
+}
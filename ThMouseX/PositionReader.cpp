@@ -0,0 +1,61 @@
+#include "framework.h"
+
+#include "../Common/DataTypes.h"
+#include "../Common/Variables.h"
+#include "../Common/Helper.Memory.h"
+#include "PositionReader.h"
+
+namespace memory = common::helper::memory;
+
+using namespace std;
+using core::positionreader::PositionReader;
+
+template <typename T>
+DoublePoint ReadPosition(const PositionReader& reader, DWORD address) {
+    // the address was checked, but the game can free the position since
+    T position{};
+    memory::TryRead(address, &position, sizeof(T));
+    g_playerPosRaw = { double(position.X), double(position.Y) };
+    return { g_playerPosRaw.X * reader.Scale + reader.Offset.X, g_playerPosRaw.Y * reader.Scale + reader.Offset.Y };
+}
+
+DoublePoint ReadNoPosition(const PositionReader&, DWORD) {
+    return {};
+}
+
+decltype(PositionReader::Read) ChooseReader(PointDataType type) {
+    switch (type) {
+        case PointDataType::Int: return ReadPosition<IntPoint>;
+        case PointDataType::Float: return ReadPosition<FloatPoint>;
+        case PointDataType::Short: return ReadPosition<ShortPoint>;
+        case PointDataType::Double: return ReadPosition<DoublePoint>;
+        default: return ReadNoPosition;
+    }
+}
+
+DWORD PositionSize(PointDataType type) {
+    switch (type) {
+        case PointDataType::Int: return sizeof(IntPoint);
+        case PointDataType::Float: return sizeof(FloatPoint);
+        case PointDataType::Short: return sizeof(ShortPoint);
+        case PointDataType::Double: return sizeof(DoublePoint);
+        default: return 0;
+    }
+}
+
+namespace core::positionreader {
+    PositionReader Make(PointDataType type, SIZE clientSize, FloatPoint aspectRatio, float pixelRate, FloatPoint pixelOffset) {
+        auto realWidth = clientSize.cy * aspectRatio.X / aspectRatio.Y;
+        auto paddingX = (clientSize.cx - realWidth) / 2;
+        return {
+            .Read = ChooseReader(type),
+            .Size = PositionSize(type),
+            .Scale = pixelRate != 0 ? 1.0 / pixelRate : 0,
+            .Offset = { pixelOffset.X + paddingX, pixelOffset.Y },
+            .PixelRate = pixelRate,
+            .PixelOffset = pixelOffset,
+            .ClientSize = clientSize,
+            .AspectRatio = aspectRatio,
+        };
+    }
+}
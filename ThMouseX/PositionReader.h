@@ -0,0 +1,27 @@
+#pragma once
+#include "framework.h"
+#include "../Common/DataTypes.h"
+
+namespace core::positionreader {
+    /*
+    Reads the player position at an address and converts it to client pixels. Made for the position data type and the
+    measurement of the window, so a call is one checked typed load and a multiply-add per axis.
+    */
+    struct PositionReader {
+        DoublePoint (*Read)(const PositionReader& reader, DWORD address);
+        // bytes of a position of the data type, 0 when there's no position
+        DWORD       Size;
+        // 1 / g_pixelRate
+        double      Scale;
+        // g_pixelOffset, plus the padding of the aspect ratio on X
+        DoublePoint Offset;
+        // what it was made from, a new measurement needs a new reader
+        float       PixelRate;
+        FloatPoint  PixelOffset;
+        SIZE        ClientSize;
+        FloatPoint  AspectRatio;
+    };
+
+    // The raw position read is also stored in g_playerPosRaw.
+    PositionReader Make(PointDataType type, SIZE clientSize, FloatPoint aspectRatio, float pixelRate, FloatPoint pixelOffset);
+}
@@ -0,0 +1,199 @@
+#include "framework.h"
+#include <hidusage.h>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include "../Common/Variables.h"
+#include "../Common/DataTypes.h"
+#include "../Common/Helper.h"
+#include "../Common/Log.h"
+#include "RawInput.h"
+
+namespace helper = common::helper;
+namespace note = common::log;
+
+using namespace std;
+using namespace core::rawinput;
+
+// Only the window's thread writes samples, any thread reads the latest one. A reader copies a sample the writer
+// won't touch again before going around the ring, and checks afterwards that it didn't.
+constexpr DWORD RingSize = 16;
+PointerSample ring[RingSize];
+atomic<DWORD> ringHead;
+// whether the latest sample is the position of the cursor
+atomic<bool> estimateValid;
+// a sample older than that is checked against GetCursorPos, the cursor can move without a movement,
+// e.g. after a SetCursorPos
+constexpr LONGLONG SampleCheckAgeMs = 50;
+// how often the window's thread makes sure that the raw mouse input is still delivered as registered
+constexpr ULONGLONG RegistrationCheckMs = 500;
+
+// state of the window's thread
+bool registrationTried;
+// while the registration for raw mouse input is ours, the game can replace it any time
+bool registered;
+ULONGLONG registrationCheckTime;
+POINT position;
+RECTSIZE clientSize;
+
+void Push(LONGLONG time) {
+    auto head = ringHead.load(memory_order_relaxed);
+    ring[head % RingSize] = { .Time = time, .Position = position };
+    ringHead.store(head + 1, memory_order_release);
+}
+
+bool IsInClientArea(POINT point) {
+    return point.x >= 0 && point.y >= 0 && point.x < clientSize.width() && point.y < clientSize.height();
+}
+
+// Whether a raw movement moves the cursor by as many pixels of the window.
+bool IsCursorMovedOneToOne(POINT cursorPosition) {
+    UINT speed;
+    int mouse[3];
+    // the physical position differs when the game is scaled for the DPI
+    POINT physicalPosition;
+    return SystemParametersInfoW(SPI_GETMOUSESPEED, 0, &speed, 0) && speed == 10
+        && SystemParametersInfoW(SPI_GETMOUSE, 0, mouse, 0) && mouse[2] == 0
+        && GetPhysicalCursorPos(&physicalPosition)
+        && physicalPosition.x == cursorPosition.x && physicalPosition.y == cursorPosition.y;
+}
+
+// Start following from the position of the cursor, it already includes the movement being handled.
+void Anchor(LONGLONG time) {
+    POINT cursorPosition;
+    auto valid = GetCursorPos(&cursorPosition) && IsCursorMovedOneToOne(cursorPosition)
+        && GetClientRect(g_hFocusWindow, &clientSize) && ScreenToClient(g_hFocusWindow, &cursorPosition)
+        && IsInClientArea(cursorPosition);
+    if (valid) {
+        position = cursorPosition;
+        Push(time);
+    }
+    estimateValid.store(valid, memory_order_release);
+}
+
+// The process's registration for the mouse, there is one per device type and process. False when there is none.
+bool FindMouseRegistration(RAWINPUTDEVICE& mouse) {
+    UINT count = 0;
+    GetRegisteredRawInputDevices(NULL, &count, sizeof(RAWINPUTDEVICE));
+    vector<RAWINPUTDEVICE> devices(count);
+    if (count > 0 && GetRegisteredRawInputDevices(devices.data(), &count, sizeof(RAWINPUTDEVICE)) == UINT(-1))
+        count = 0;
+    for (UINT i = 0; i < count; i++) {
+        if (devices[i].usUsagePage == HID_USAGE_PAGE_GENERIC && devices[i].usUsage == HID_USAGE_GENERIC_MOUSE) {
+            mouse = devices[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+// The game can register again after us, for another window or with flags such as RIDEV_NOLEGACY,
+// and the movements then don't come the way they're followed. Stop following them for good.
+bool IsStillRegistered() {
+    auto now = GetTickCount64();
+    if (now - registrationCheckTime < RegistrationCheckMs)
+        return true;
+    registrationCheckTime = now;
+    RAWINPUTDEVICE mouse;
+    if (FindMouseRegistration(mouse) && mouse.hwndTarget == g_hFocusWindow && mouse.dwFlags == 0)
+        return true;
+    registered = false;
+    estimateValid.store(false, memory_order_release);
+    note::ToFile("[RawInput] The game replaced the raw mouse input registration, the cursor position is polled.");
+    return false;
+}
+
+bool IsSampleStale(const PointerSample& sample) {
+    static auto frequency = [] {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        return frequency.QuadPart;
+    }();
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart - sample.Time > frequency * SampleCheckAgeMs / 1000;
+}
+
+namespace core::rawinput {
+    void Register() {
+        if (registrationTried || !g_hFocusWindow)
+            return;
+        registrationTried = true;
+        // the game's registration comes first
+        RAWINPUTDEVICE mouse;
+        if (FindMouseRegistration(mouse)) {
+            note::ToFile("[RawInput] The game already receives raw mouse input, the cursor position is polled.");
+            return;
+        }
+        mouse = {
+            .usUsagePage = HID_USAGE_PAGE_GENERIC,
+            .usUsage = HID_USAGE_GENERIC_MOUSE,
+            .dwFlags = 0,
+            .hwndTarget = g_hFocusWindow,
+        };
+        if (RegisterRawInputDevices(&mouse, 1, sizeof(mouse)) == FALSE) {
+            note::LastErrorToFile("[RawInput] Failed to register for raw mouse input.");
+            return;
+        }
+        registered = true;
+        registrationCheckTime = GetTickCount64();
+    }
+
+    void HandleInput(HRAWINPUT input) {
+        // the movements are the game's own then
+        if (!registered || !IsStillRegistered())
+            return;
+        RAWINPUT data;
+        UINT size = sizeof(data);
+        if (GetRawInputData(input, RID_INPUT, &data, &size, sizeof(RAWINPUTHEADER)) == UINT(-1) || data.header.dwType != RIM_TYPEMOUSE)
+            return;
+        LARGE_INTEGER time;
+        QueryPerformanceCounter(&time);
+        auto& mouse = data.data.mouse;
+        // tablets and remote desktops give absolute positions, let GetCursorPos convert them,
+        // and an estimate that was invalidated starts again from the cursor
+        if ((mouse.usFlags & MOUSE_MOVE_ABSOLUTE) == MOUSE_MOVE_ABSOLUTE || !estimateValid.load(memory_order_relaxed)) {
+            Anchor(time.QuadPart);
+            return;
+        }
+        if (mouse.lLastX == 0 && mouse.lLastY == 0)
+            return;
+        position.x += mouse.lLastX;
+        position.y += mouse.lLastY;
+        // outside, the cursor can be stopped by the screen edges or a ClipCursor, which the movements don't show
+        if (!IsInClientArea(position)) {
+            estimateValid.store(false, memory_order_release);
+            return;
+        }
+        Push(time.QuadPart);
+    }
+
+    void Reconcile() {
+        estimateValid.store(false, memory_order_release);
+    }
+
+    PointerSample GetPointerSample() {
+        for (auto attempt = 0; attempt < 4 && estimateValid.load(memory_order_acquire); attempt++) {
+            auto head = ringHead.load(memory_order_acquire);
+            PointerSample sample;
+            memcpy(&sample, &ring[(head - 1) % RingSize], sizeof(sample));
+            atomic_thread_fence(memory_order_acquire);
+            if (ringHead.load(memory_order_relaxed) - head >= RingSize - 1)
+                continue;
+            if (!IsSampleStale(sample))
+                return sample;
+            // no movement came for a while, so the cursor should still be where the sample is
+            auto polled = helper::GetPointerPosition();
+            if (polled.x == sample.Position.x && polled.y == sample.Position.y)
+                return sample;
+            estimateValid.store(false, memory_order_release);
+            return { .Time = 0, .Position = polled };
+        }
+        return { .Time = 0, .Position = helper::GetPointerPosition() };
+    }
+
+    POINT GetPointerPosition() {
+        return GetPointerSample().Position;
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "framework.h"
+
+/*
+The cursor position, followed from the raw mouse movements (WM_INPUT) the game's window receives
+instead of polled with GetCursorPos and ScreenToClient whenever it's needed.
+Raw movements only match the cursor's when Windows moves the cursor by exactly that much: a pointer speed of 10,
+"Enhance pointer precision" off, and a game not scaled for the DPI. Otherwise, or while the cursor is outside
+the client area, the position is polled like before.
+*/
+namespace core::rawinput {
+    struct PointerSample {
+        // QueryPerformanceCounter when the movement was received, 0 when the position was polled
+        LONGLONG    Time;
+        // in client pixels
+        POINT       Position;
+    };
+
+    // Subscribe the focus window to raw mouse input, unless the game did already. Call from the window's thread.
+    void Register();
+    // Follow a movement, from the window's thread. Ignored unless the registration is still the one Register made.
+    void HandleInput(HRAWINPUT input);
+    // Take the position from GetCursorPos again on the next movement, after the window moved or the settings changed.
+    void Reconcile();
+    // The latest position, callable from any thread. A sample that no movement followed for a while
+    // is checked against GetCursorPos, and the position is polled again if they disagree.
+    PointerSample GetPointerSample();
+    POINT GetPointerPosition();
+}
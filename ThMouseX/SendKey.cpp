@@ -4,15 +4,21 @@
 #include "../Common/macro.h"
 #include "../Common/Variables.h"
 #include "../Common/CallbackStore.h"
+#include "../Common/KeyBindings.h"
 #include "InputDetermine.h"
 
 using namespace core::inputdetermine;
 
 namespace callbackstore = common::callbackstore;
+namespace keybindings = common::keybindings;
+namespace sendkey = core::sendkey;
+
+using sendkey::KeyTransition;
 
 struct LastState {
     bool bomb;
     bool extra;
+    bool focus;
     bool left;
     bool right;
     bool up;
@@ -36,91 +42,130 @@ bool IsVKExtended(UINT key) {
         return false;
 }
 
-void SendKeyDown(BYTE vkCode) {
-    if ((g_currentConfig.InputMethods & InputMethod::SendMsg) == InputMethod::SendMsg) {
-        auto lParam = (MapVirtualKeyW(vkCode, MAPVK_VK_TO_VSC) << 16) | 0x00000001;
-        if (IsVKExtended(vkCode))
-            lParam |= 0x01000000;
-        SendMessageW(g_hFocusWindow, WM_KEYDOWN, vkCode, lParam);
-    }
-    else if ((g_currentConfig.InputMethods & InputMethod::SendInput) == InputMethod::SendInput) {
-        if (!g_hFocusWindow || GetForegroundWindow() != g_hFocusWindow)
-            return;
-        INPUT input{
+// one transition per key at most, in the order of SendKeys
+constexpr UINT MaxTransitions = 7;
+
+struct KeyBatch {
+    KeyTransition   Transitions[MaxTransitions];
+    UINT            Count;
+};
+
+// MapVirtualKeyW of the keys sent so far, 0 until a key is first sent
+WORD scanCodes[256];
+
+WORD GetScanCode(BYTE vkCode) {
+    if (scanCodes[vkCode] == 0)
+        scanCodes[vkCode] = (WORD)MapVirtualKeyW(vkCode, MAPVK_VK_TO_VSC);
+    return scanCodes[vkCode];
+}
+
+// The transitions of the frame in a single SendInput.
+void SubmitWithSendInput(const KeyTransition* transitions, UINT count) {
+    if (!g_hFocusWindow || GetForegroundWindow() != g_hFocusWindow)
+        return;
+    INPUT inputs[MaxTransitions];
+    for (UINT i = 0; i < count; i++) {
+        auto vkCode = transitions[i].VkCode;
+        inputs[i] = INPUT{
             .type = INPUT_KEYBOARD,
             .ki = {
                 .wVk = vkCode,
-                .wScan = (WORD)MapVirtualKeyW(vkCode, MAPVK_VK_TO_VSC),
-                .dwFlags = DWORD(IsVKExtended(vkCode) ? KEYEVENTF_EXTENDEDKEY : 0),/*
+                .wScan = GetScanCode(vkCode),
+                .dwFlags = DWORD((transitions[i].Down ? 0 : KEYEVENTF_KEYUP) | (IsVKExtended(vkCode) ? KEYEVENTF_EXTENDEDKEY : 0)),/*
           */},
         };
-        SendInput(1, &input, sizeof(INPUT));
     }
+    SendInput(count, inputs, sizeof(INPUT));
 }
 
-void SendKeyUp(BYTE vkCode) {
-    if ((g_currentConfig.InputMethods & InputMethod::SendMsg) == InputMethod::SendMsg) {
-        auto lParam = (MapVirtualKeyW(vkCode, MAPVK_VK_TO_VSC) << 16) | 0xC0000001;
+// The transitions of the frame as key messages. Sending to a window of this thread is a plain call of its window
+// procedure, but sending to another thread waits for it to handle each message, so they are all posted then.
+void SubmitWithSendMessage(const KeyTransition* transitions, UINT count) {
+    // a NULL window would post to this thread's queue instead
+    auto window = g_hFocusWindow;
+    if (!window)
+        return;
+    auto sameThread = GetWindowThreadProcessId(window, NULL) == GetCurrentThreadId();
+    for (UINT i = 0; i < count; i++) {
+        auto vkCode = transitions[i].VkCode;
+        auto lParam = LPARAM(GetScanCode(vkCode) << 16) | (transitions[i].Down ? 0x00000001 : 0xC0000001);
         if (IsVKExtended(vkCode))
             lParam |= 0x01000000;
-        SendMessageW(g_hFocusWindow, WM_KEYUP, vkCode, lParam);
-    }
-    else if ((g_currentConfig.InputMethods & InputMethod::SendInput) == InputMethod::SendInput) {
-        if (!g_hFocusWindow || GetForegroundWindow() != g_hFocusWindow)
-            return;
-        INPUT input{
-            .type = INPUT_KEYBOARD,
-            .ki = {
-                .wVk = vkCode,
-                .wScan = (WORD)MapVirtualKeyW(vkCode, MAPVK_VK_TO_VSC),
-                .dwFlags = DWORD(KEYEVENTF_KEYUP | (IsVKExtended(vkCode) ? KEYEVENTF_EXTENDEDKEY : 0)),/*
-          */},
-        };
-        SendInput(1, &input, sizeof(INPUT));
+        auto message = transitions[i].Down ? WM_KEYDOWN : WM_KEYUP;
+        if (sameThread)
+            SendMessageW(window, message, vkCode, lParam);
+        else
+            PostMessageW(window, message, vkCode, lParam);
     }
 }
 
-void HandleKeyPress(GameInput gameInput, bool& wasPressing, BYTE vkCode) {
-    if (gameInput != GameInput::NONE) {
-        if (!wasPressing) {
-            SendKeyDown(vkCode);
-            wasPressing = true;
-        }
-    }
-    else {
-        if (wasPressing) {
-            SendKeyUp(vkCode);
-            wasPressing = false;
-        }
+// where the batches go, chosen from the input methods of the game in Initialize
+sendkey::KeySink submitKeys;
+
+void Submit(const KeyBatch& batch) {
+    if (batch.Count > 0)
+        submitKeys(batch.Transitions, batch.Count);
+}
+
+void HandleKeyPress(KeyBatch& batch, GameInput gameInput, bool& wasPressing, BYTE vkCode) {
+    auto pressing = gameInput != GameInput::NONE;
+    if (pressing != wasPressing) {
+        batch.Transitions[batch.Count++] = { .VkCode = vkCode, .Down = pressing };
+        wasPressing = pressing;
     }
 }
 
 void TestInputAndSendKeys() {
-    auto gameInput = DetermineGameInput();
-    HandleKeyPress(gameInput & GameInput::USE_BOMB, _ref lastState.bomb, gs_bombButton);
-    HandleKeyPress(gameInput & GameInput::USE_SPECIAL, _ref lastState.extra, gs_extraButton);
-    HandleKeyPress(gameInput & GameInput::MOVE_LEFT, _ref lastState.left, VK_LEFT);
-    HandleKeyPress(gameInput & GameInput::MOVE_RIGHT, _ref lastState.right, VK_RIGHT);
-    HandleKeyPress(gameInput & GameInput::MOVE_UP, _ref lastState.up, VK_UP);
-    HandleKeyPress(gameInput & GameInput::MOVE_DOWN, _ref lastState.down, VK_DOWN);
+    sendkey::SendKeys(DetermineGameInput());
 }
 
 void CleanUp(bool isProcessTerminating) {
     if (isProcessTerminating)
         return;
-    SendKeyUp(gs_bombButton);
-    SendKeyUp(gs_extraButton);
-    SendKeyUp(VK_LEFT);
-    SendKeyUp(VK_RIGHT);
-    SendKeyUp(VK_UP);
-    SendKeyUp(VK_DOWN);
+    auto keyBindings = keybindings::Load();
+    KeyBatch batch{
+        .Transitions = {
+            { keyBindings.BombButton, false },
+            { keyBindings.ExtraButton, false },
+            { VK_SHIFT, false },
+            { VK_LEFT, false },
+            { VK_RIGHT, false },
+            { VK_UP, false },
+            { VK_DOWN, false },
+        },
+        .Count = MaxTransitions,
+    };
+    Submit(batch);
 }
 
 namespace core::sendkey {
     void Initialize() {
-        if ((g_currentConfig.InputMethods & (InputMethod::SendInput | InputMethod::SendMsg)) == InputMethod::None)
+        if ((g_currentConfig.InputMethods & InputMethod::SendMsg) == InputMethod::SendMsg)
+            submitKeys = SubmitWithSendMessage;
+        else if ((g_currentConfig.InputMethods & InputMethod::SendInput) == InputMethod::SendInput)
+            submitKeys = SubmitWithSendInput;
+        else
             return;
         callbackstore::RegisterPostRenderCallback(TestInputAndSendKeys);
         callbackstore::RegisterUninitializeCallback(CleanUp);
     }
+
+    void SendKeys(GameInput gameInput) {
+        auto keyBindings = keybindings::Load();
+        KeyBatch batch{};
+        HandleKeyPress(batch, gameInput & GameInput::USE_BOMB, _ref lastState.bomb, keyBindings.BombButton);
+        HandleKeyPress(batch, gameInput & GameInput::USE_SPECIAL, _ref lastState.extra, keyBindings.ExtraButton);
+        HandleKeyPress(batch, gameInput & GameInput::USE_FOCUS, _ref lastState.focus, VK_SHIFT);
+        HandleKeyPress(batch, gameInput & GameInput::MOVE_LEFT, _ref lastState.left, VK_LEFT);
+        HandleKeyPress(batch, gameInput & GameInput::MOVE_RIGHT, _ref lastState.right, VK_RIGHT);
+        HandleKeyPress(batch, gameInput & GameInput::MOVE_UP, _ref lastState.up, VK_UP);
+        HandleKeyPress(batch, gameInput & GameInput::MOVE_DOWN, _ref lastState.down, VK_DOWN);
+        Submit(batch);
+    }
+
+    KeySink SetKeySink(KeySink sink) {
+        auto previous = submitKeys;
+        submitKeys = sink;
+        return previous;
+    }
 }
\ No newline at end of file
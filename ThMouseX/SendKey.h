@@ -1,5 +1,21 @@
 #pragma once
+#include "framework.h"
+#include "../Common/DataTypes.h"
 
 namespace core::sendkey {
+    // a key going down or up, the ones of a frame are sent together
+    struct KeyTransition {
+        BYTE    VkCode;
+        bool    Down;
+    };
+
+    // Where the key transitions of a frame go, all of them in one call, in the order of SendKeys.
+    using KeySink = void (*)(const KeyTransition* transitions, UINT count);
+
+    // Send the keys with SendInput or key messages, whichever the input methods of the game config say.
     void Initialize();
-}
\ No newline at end of file
+    // Press and release the keys so the pressed ones are those of the input: bomb, extra, focus, left, right, up, down.
+    void SendKeys(GameInput gameInput);
+    // Replace where the key transitions go, returns the previous sink.
+    KeySink SetKeySink(KeySink sink);
+}
@@ -0,0 +1,101 @@
+#include "framework.h"
+#include <string>
+#include <memory>
+#include <format>
+
+#include "../Common/macro.h"
+#include "../Common/DataTypes.h"
+#include "../Common/Helper.h"
+#include "../Common/Helper.Encoding.h"
+#include "../Common/MemoryView.h"
+#include "../Common/ValueScan.h"
+#include "ValueScanner.h"
+
+namespace helper = common::helper;
+namespace encoding = common::helper::encoding;
+namespace memoryview = common::memoryview;
+namespace valuescan = common::valuescan;
+
+using namespace std;
+using valuescan::ValueFilter;
+
+// more candidates than that aren't worth reading, another filter is needed
+constexpr DWORD MaxPrintedCount = 100;
+
+const char* FilterName(ValueFilter filter) {
+    switch (filter) {
+        case ValueFilter::Changed: return "changed";
+        case ValueFilter::Unchanged: return "unchanged";
+        case ValueFilter::Increased: return "increased";
+        case ValueFilter::Decreased: return "decreased";
+        case ValueFilter::InRange: return "in range";
+        default: return "?";
+    }
+}
+
+string FormatValue(memoryview::MemoryView& view, PointDataType type, DWORD address) {
+    BYTE value[sizeof(double)];
+    if (!view.Read(address, value, valuescan::ValueSize(type)))
+        return "?";
+    switch (type) {
+        case PointDataType::Int: return format("{}", *(int*)value);
+        case PointDataType::Float: return format("{}", *(float*)value);
+        case PointDataType::Short: return format("{}", *(short*)value);
+        case PointDataType::Double: return format("{}", *(double*)value);
+        default: return "?";
+    }
+}
+
+namespace core::valuescanner {
+    bool ScanValues(PointDataType type, const WCHAR* const* snapshotPaths, const int* filters, const double* minimums, const double* maximums, int stepCount) {
+        if (valuescan::ValueSize(type) == 0)
+            return false;
+        unique_ptr<memoryview::MemoryView> previous;
+        unique_ptr<memoryview::MemoryView> current;
+        valuescan::Candidates candidates;
+        string report;
+        for (auto i = 0; i < stepCount; i++) {
+            if (snapshotPaths[i] != nullptr) {
+                auto snapshot = memoryview::OpenSnapshot(snapshotPaths[i]);
+                if (!snapshot) {
+                    helper::ReportLastError(APP_NAME ": Failed to open the memory snapshot");
+                    return false;
+                }
+                if (!current)
+                    candidates = valuescan::Start(*snapshot, type);
+                previous = move(current);
+                current = move(snapshot);
+                report += format("; {}: {} candidates\n", encoding::ConvertToUtf8(snapshotPaths[i]), valuescan::Count(candidates));
+                continue;
+            }
+            auto filter = ValueFilter(filters[i]);
+            if (!current || (!previous && filter != ValueFilter::InRange)) {
+                MessageBoxA(NULL, "A filter must follow the snapshots it compares.", APP_NAME, MB_OK | MB_ICONERROR);
+                return false;
+            }
+            valuescan::Apply(candidates, previous ? *previous : *current, *current, filter, minimums[i], maximums[i]);
+            report += format("; {}: {} candidates\n", FilterName(filter), valuescan::Count(candidates));
+        }
+        if (!current)
+            return false;
+
+        // the values in the last snapshot, with the positionRVA of the ones in the game module
+        for (auto address : valuescan::List(candidates, MaxPrintedCount)) {
+            report += format("{:08X}\t{}", address, FormatValue(*current, type, address));
+            if (address >= current->ModuleBase && address - current->ModuleBase < current->ModuleSize)
+                report += format("\t[{:08X}]", address - current->ModuleBase);
+            report += "\n";
+        }
+        if (!helper::PrintToConsole(report))
+            MessageBoxA(NULL, report.c_str(), APP_NAME, MB_OK | MB_ICONINFORMATION);
+        return true;
+    }
+
+    bool SnapshotProcess(DWORD processId, const WCHAR* snapshotPath) {
+        if (!memoryview::SaveProcessSnapshot(processId, snapshotPath, true)) {
+            helper::ReportLastError(APP_NAME ": Failed to save the memory snapshot");
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include "framework.h"
+#include "../Common/macro.h"
+#include "../Common/DataTypes.h"
+
+namespace core::valuescanner {
+    // Run the steps in order and print the values that are left. A step with a snapshot path opens that snapshot,
+    // the others apply their filter (a common::valuescan::ValueFilter) to the last two snapshots opened.
+    // minimums and maximums are only used by InRange filters.
+    DLLEXPORT_C bool ScanValues(PointDataType type, const WCHAR* const* snapshotPaths, const int* filters, const double* minimums, const double* maximums, int stepCount);
+    // Save the writable memory of another process, for a value scan of a game ThMouseX isn't in.
+    DLLEXPORT_C bool SnapshotProcess(DWORD processId, const WCHAR* snapshotPath);
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "framework.h"
+#include <string_view>
+#include <algorithm>
+
+// Built-in virtual-key names accepted in ThMouseX.ini, sorted by name so they can be binary searched.
+// Reference: https://learn.microsoft.com/en-us/windows/win32/inputdev/virtual-key-codes
+struct VkCodeName {
+    std::string_view    Name;
+    BYTE                Code;
+};
+
+constexpr VkCodeName VirtualKeyCodes[]{
+    { "VK_0",          0x30 }, // 0 key
+    { "VK_1",          0x31 }, // 1 key
+    { "VK_2",          0x32 }, // 2 key
+    { "VK_3",          0x33 }, // 3 key
+    { "VK_4",          0x34 }, // 4 key
+    { "VK_5",          0x35 }, // 5 key
+    { "VK_6",          0x36 }, // 6 key
+    { "VK_7",          0x37 }, // 7 key
+    { "VK_8",          0x38 }, // 8 key
+    { "VK_9",          0x39 }, // 9 key
+    { "VK_A",          0x41 }, // A key
+    { "VK_ADD",        0x6B }, // Add key
+    { "VK_B",          0x42 }, // B key
+    { "VK_BACK",       0x08 }, // BACKSPACE key
+    { "VK_BACK_QUOTE", 0xC0 }, // Back Quote
+    { "VK_C",          0x43 }, // C key
+    { "VK_CONTROL",    0x11 }, // CTRL key
+    { "VK_D",          0x44 }, // D key
+    { "VK_DECIMAL",    0x6E }, // Decimal key
+    { "VK_DELETE",     0x2E }, // DEL key
+    { "VK_DIVIDE",     0x6F }, // Divide key
+    { "VK_DOWN",       0x28 }, // DOWN ARROW key
+    { "VK_E",          0x45 }, // E key
+    { "VK_END",        0x23 }, // END key
+    { "VK_F",          0x46 }, // F key
+    { "VK_G",          0x47 }, // G key
+    { "VK_H",          0x48 }, // H key
+    { "VK_HOME",       0x24 }, // HOME key
+    { "VK_I",          0x49 }, // I key
+    { "VK_INSERT",     0x2D }, // INS key
+    { "VK_J",          0x4A }, // J key
+    { "VK_K",          0x4B }, // K key
+    { "VK_L",          0x4C }, // L key
+    { "VK_LCONTROL",   0xA2 }, // Left CONTROL key
+    { "VK_LEFT",       0x25 }, // LEFT ARROW key
+    { "VK_LMENU",      0xA4 }, // Left ALT key
+    { "VK_LSHIFT",     0xA0 }, // Left SHIFT key
+    { "VK_M",          0x4D }, // M key
+    { "VK_MENU",       0x12 }, // ALT key
+    { "VK_MULTIPLY",   0x6A }, // Multiply key
+    { "VK_N",          0x4E }, // N key
+    { "VK_NEXT",       0x22 }, // PAGE DOWN key
+    { "VK_NUMPAD0",    0x60 }, // Numeric keypad 0 key
+    { "VK_NUMPAD1",    0x61 }, // Numeric keypad 1 key
+    { "VK_NUMPAD2",    0x62 }, // Numeric keypad 2 key
+    { "VK_NUMPAD3",    0x63 }, // Numeric keypad 3 key
+    { "VK_NUMPAD4",    0x64 }, // Numeric keypad 4 key
+    { "VK_NUMPAD5",    0x65 }, // Numeric keypad 5 key
+    { "VK_NUMPAD6",    0x66 }, // Numeric keypad 6 key
+    { "VK_NUMPAD7",    0x67 }, // Numeric keypad 7 key
+    { "VK_NUMPAD8",    0x68 }, // Numeric keypad 8 key
+    { "VK_NUMPAD9",    0x69 }, // Numeric keypad 9 key
+    { "VK_O",          0x4F }, // O key
+    { "VK_P",          0x50 }, // P key
+    { "VK_PRIOR",      0x21 }, // PAGE UP key
+    { "VK_Q",          0x51 }, // Q key
+    { "VK_R",          0x52 }, // R key
+    { "VK_RCONTROL",   0xA3 }, // Right CONTROL key
+    { "VK_RETURN",     0x0D }, // ENTER key
+    { "VK_RIGHT",      0x27 }, // RIGHT ARROW key
+    { "VK_RMENU",      0xA5 }, // Right ALT key
+    { "VK_RSHIFT",     0xA1 }, // Right SHIFT key
+    { "VK_S",          0x53 }, // S key
+    { "VK_SEPARATOR",  0x6C }, // Separator key
+    { "VK_SHIFT",      0x10 }, // SHIFT key
+    { "VK_SPACE",      0x20 }, // SPACEBAR
+    { "VK_SUBTRACT",   0x6D }, // Subtract key
+    { "VK_T",          0x54 }, // T key
+    { "VK_TAB",        0x09 }, // TAB key
+    { "VK_U",          0x55 }, // U key
+    { "VK_UP",         0x26 }, // UP ARROW key
+    { "VK_V",          0x56 }, // V key
+    { "VK_W",          0x57 }, // W key
+    { "VK_X",          0x58 }, // X key
+    { "VK_Y",          0x59 }, // Y key
+    { "VK_Z",          0x5A }, // Z key
+};
+static_assert(std::ranges::is_sorted(VirtualKeyCodes, {}, &VkCodeName::Name));
@@ -1,5 +1,7 @@
 ﻿using System;
 using System.Collections.Generic;
+using System.Diagnostics;
+using System.Globalization;
 using System.Linq;
 using System.Runtime.InteropServices;
 using System.Threading;
@@ -18,16 +20,63 @@ namespace ThMouseX
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         static extern void RemoveHooks();
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
-        static extern bool ReadGamesFile();
+        internal static extern bool ReadGamesFile();
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
-        static extern bool ReadGeneralConfigFile();
+        static extern bool CompileGamesFile();
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        static extern bool LintConfigFiles();
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        internal static extern bool ReadGeneralConfigFile();
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        static extern bool ScanPointers(
+            [MarshalAs(UnmanagedType.LPArray, ArraySubType = UnmanagedType.LPWStr)] string[] snapshotPaths,
+            uint[] targetAddresses, int snapshotCount, int maxDepth, uint maxOffset);
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        static extern bool ScanValues(int type,
+            [MarshalAs(UnmanagedType.LPArray, ArraySubType = UnmanagedType.LPWStr)] string[] snapshotPaths,
+            int[] filters, double[] minimums, double[] maximums, int stepCount);
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        static extern bool SnapshotProcess(uint processId, [MarshalAs(UnmanagedType.LPWStr)] string snapshotPath);
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        static extern bool ReplayInput([MarshalAs(UnmanagedType.LPWStr)] string logPath);
+
+        // same order as PointDataType and ValueFilter of ThMouseX
+        static readonly string[] ValueTypes = { "int", "float", "short", "double" };
+        static readonly string[] ValueFilters = { "changed", "unchanged", "increased", "decreased" };
+        const int InRangeFilter = 4;
 
         [STAThread]
-        static void Main()
+        static void Main(string[] args)
         {
             Application.EnableVisualStyles();
             Application.SetCompatibleTextRenderingDefault(false);
 
+            // "--compile" only rebuilds Games.bin from Games.txt and Games2.txt, then exits
+            if (args.Contains("--compile"))
+                Environment.Exit(CompileGamesFile() ? 0 : 1);
+            // "--lint" checks every config file and prints all problems found, without touching running games
+            if (args.Contains("--lint"))
+                Environment.Exit(LintConfigFiles() ? 0 : 1);
+            // "--pointer-scan <snapshot> <address> [<snapshot> <address>]..." prints the pointer chains that lead to the (hexadecimal)
+            // address in every snapshot, "--max-depth <n>" and "--max-offset <hex>" can follow
+            var pointerScanIdx = Array.IndexOf(args, "--pointer-scan");
+            if (pointerScanIdx >= 0)
+                Environment.Exit(RunPointerScan(args.Skip(pointerScanIdx + 1).ToArray()) ? 0 : 1);
+            // "--snapshot <process name or id> <snapshot>" saves the writable memory of a running game for "--value-scan"
+            var snapshotIdx = Array.IndexOf(args, "--snapshot");
+            if (snapshotIdx >= 0)
+                Environment.Exit(RunSnapshot(args.Skip(snapshotIdx + 1).ToArray()) ? 0 : 1);
+            // "--value-scan <int|float|short|double> <snapshot> [<filter>|<snapshot>]..." prints the values that passed every filter,
+            // a filter being changed, unchanged, increased or decreased between the last two snapshots, or <min>..<max> in the last one
+            var valueScanIdx = Array.IndexOf(args, "--value-scan");
+            if (valueScanIdx >= 0)
+                Environment.Exit(RunValueScan(args.Skip(valueScanIdx + 1).ToArray()) ? 0 : 1);
+            // "--replay <input log>" computes the input of each frame recorded in the game again and prints the frames where
+            // it differs from the recorded one and the time a frame took, it fails when a frame differs
+            var replayIdx = Array.IndexOf(args, "--replay");
+            if (replayIdx >= 0)
+                Environment.Exit(RunReplay(args.Skip(replayIdx + 1).ToArray()) ? 0 : 1);
+
             using var mutex = new Mutex(true, AppName, out var mutexIsCreated);
             if (!mutexIsCreated)
             {
@@ -48,5 +97,94 @@ namespace ThMouseX
 
             RemoveHooks();
         }
+
+        static bool RunPointerScan(string[] args)
+        {
+            var snapshotPaths = new List<string>();
+            var targetAddresses = new List<uint>();
+            var maxDepth = 4;
+            var maxOffset = 0x1000u;
+            try
+            {
+                for (var i = 0; i < args.Length; i += 2)
+                {
+                    if (args[i] == "--max-depth")
+                        maxDepth = int.Parse(args[i + 1]);
+                    else if (args[i] == "--max-offset")
+                        maxOffset = Convert.ToUInt32(args[i + 1], 16);
+                    else
+                    {
+                        snapshotPaths.Add(args[i]);
+                        targetAddresses.Add(Convert.ToUInt32(args[i + 1], 16));
+                    }
+                }
+            }
+            catch (Exception e) when (e is IndexOutOfRangeException || e is FormatException || e is OverflowException)
+            {
+                MessageBox.Show("Usage: --pointer-scan <snapshot> <address> [<snapshot> <address>]... [--max-depth <n>] [--max-offset <hex>]",
+                    AppName, MessageBoxButtons.OK, MessageBoxIcon.Error);
+                return false;
+            }
+            return ScanPointers(snapshotPaths.ToArray(), targetAddresses.ToArray(), snapshotPaths.Count, maxDepth, maxOffset);
+        }
+
+        static bool RunSnapshot(string[] args)
+        {
+            if (args.Length != 2)
+            {
+                MessageBox.Show("Usage: --snapshot <process name or id> <snapshot>", AppName, MessageBoxButtons.OK, MessageBoxIcon.Error);
+                return false;
+            }
+            var processes = uint.TryParse(args[0], out var processId)
+                ? new[] { processId }
+                : Process.GetProcessesByName(args[0]).Select(process => (uint)process.Id).ToArray();
+            if (processes.Length != 1)
+            {
+                MessageBox.Show($"There must be exactly one process named {args[0]}.", AppName, MessageBoxButtons.OK, MessageBoxIcon.Error);
+                return false;
+            }
+            return SnapshotProcess(processes[0], args[1]);
+        }
+
+        static bool RunReplay(string[] args)
+        {
+            if (args.Length != 1)
+            {
+                MessageBox.Show("Usage: --replay <input log>", AppName, MessageBoxButtons.OK, MessageBoxIcon.Error);
+                return false;
+            }
+            return ReplayInput(args[0]);
+        }
+
+        static bool RunValueScan(string[] args)
+        {
+            var type = args.Length > 0 ? Array.IndexOf(ValueTypes, args[0]) : -1;
+            if (type < 0 || args.Length < 2)
+            {
+                MessageBox.Show("Usage: --value-scan <int|float|short|double> <snapshot> [<changed|unchanged|increased|decreased|min..max>|<snapshot>]...",
+                    AppName, MessageBoxButtons.OK, MessageBoxIcon.Error);
+                return false;
+            }
+            var snapshotPaths = new List<string>();
+            var filters = new List<int>();
+            var minimums = new List<double>();
+            var maximums = new List<double>();
+            foreach (var arg in args.Skip(1))
+            {
+                var filter = Array.IndexOf(ValueFilters, arg);
+                var range = arg.Split(new[] { ".." }, StringSplitOptions.None);
+                double minimum = 0, maximum = 0;
+                if (filter < 0 && range.Length == 2
+                    && double.TryParse(range[0], NumberStyles.Float, CultureInfo.InvariantCulture, out minimum)
+                    && double.TryParse(range[1], NumberStyles.Float, CultureInfo.InvariantCulture, out maximum))
+                    filter = InRangeFilter;
+                snapshotPaths.Add(filter < 0 ? arg : null);
+                filters.Add(filter);
+                minimums.Add(minimum);
+                maximums.Add(maximum);
+            }
+            // PointDataType starts with None
+            return ScanValues(type + 1, snapshotPaths.ToArray(), filters.ToArray(), minimums.ToArray(), maximums.ToArray(), snapshotPaths.Count);
+        }
     }
 }
@@ -1,7 +1,9 @@
 ﻿using System;
 using System.Collections.Generic;
+using System.IO;
 using System.Linq;
 using System.Text;
+using System.Threading;
 using System.Threading.Tasks;
 using System.Windows.Forms;
 
@@ -11,6 +13,17 @@ namespace ThMouseX
     {
         readonly NotifyIcon notifyIcon = new NotifyIcon();
 
+        // editors often save a file in several writes, so wait for them to settle before reloading
+        const int ReloadDelay = 500;
+        static readonly string[] GamesFiles = { "Games.txt", "Games2.txt" };
+        static readonly string[] GeneralConfigFiles = { Program.AppName + ".ini", "VirtualKeyCodes.txt" };
+        readonly FileSystemWatcher configWatcher = new FileSystemWatcher(Environment.CurrentDirectory);
+        readonly System.Threading.Timer reloadTimer;
+        readonly object pendingLock = new object();
+        readonly object reloadLock = new object();
+        bool gamesFileChanged;
+        bool generalConfigFileChanged;
+
         public ThMouseApplicationContext()
         {
             notifyIcon.Visible = true;
@@ -21,6 +34,46 @@ namespace ThMouseX
                 new MenuItem("Exit", (_, __) => Exit()),
             });
             notifyIcon.ShowBalloonTip(2000, Program.AppName, $"{Program.AppName} is activated.", ToolTipIcon.Info);
+
+            reloadTimer = new System.Threading.Timer(_ => ReloadConfigs());
+            configWatcher.NotifyFilter = NotifyFilters.FileName | NotifyFilters.LastWrite | NotifyFilters.Size;
+            configWatcher.Changed += OnConfigFileChanged;
+            configWatcher.Created += OnConfigFileChanged;
+            configWatcher.Renamed += OnConfigFileChanged;
+            configWatcher.EnableRaisingEvents = true;
+        }
+
+        void OnConfigFileChanged(object sender, FileSystemEventArgs e)
+        {
+            lock (pendingLock)
+            {
+                if (GamesFiles.Contains(e.Name, StringComparer.OrdinalIgnoreCase))
+                    gamesFileChanged = true;
+                else if (GeneralConfigFiles.Contains(e.Name, StringComparer.OrdinalIgnoreCase))
+                    generalConfigFileChanged = true;
+                else
+                    return;
+                reloadTimer.Change(ReloadDelay, Timeout.Infinite);
+            }
+        }
+
+        // Reparse only what changed, running games pick the game list up on their next frame.
+        void ReloadConfigs()
+        {
+            bool reloadGamesFile, reloadGeneralConfigFile;
+            lock (pendingLock)
+            {
+                reloadGamesFile = gamesFileChanged;
+                reloadGeneralConfigFile = generalConfigFileChanged;
+                gamesFileChanged = generalConfigFileChanged = false;
+            }
+            lock (reloadLock)
+            {
+                if (reloadGamesFile)
+                    Program.ReadGamesFile();
+                if (reloadGeneralConfigFile)
+                    Program.ReadGeneralConfigFile();
+            }
         }
 
         void ShowDialog()
@@ -31,6 +84,8 @@ namespace ThMouseX
 
         void Exit()
         {
+            configWatcher.Dispose();
+            reloadTimer.Dispose();
             notifyIcon.Visible = false;
             Application.Exit();
         }